@@ -0,0 +1,177 @@
+// Brick decode with per-brick vectors against the slab arena: heap
+// allocations and wall time for load_bricks_bin() / stream_bricks_bin().
+//
+// usage: bench_brick_arena [dims] [iterations]
+//   defaults: 256^3 debug sphere (B=64 bricks), every other brick zstd, 3 iterations
+//
+// Allocations are counted by replacing the global operator new, so they
+// include the reader's own bookkeeping; "large" are >= 64 KiB (brick
+// buffers and slabs). Huge-page slabs (posix_memalign) are not counted.
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "genmesh/brick_codec.h"
+#include "genmesh/bricks_data.h"
+#include "genmesh/debug_generate.h"
+#include "genmesh/log.h"
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<int64_t> g_allocs{0};
+static std::atomic<int64_t> g_large{0};
+
+static void count(size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (n >= 64 * 1024) g_large.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* operator new(size_t n) {
+    count(n);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t n, std::align_val_t al) {
+    count(n);
+    const size_t a = static_cast<size_t>(al);
+    if (void* p = std::aligned_alloc(a, (n + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+const char* kBin = "_bench_brick_arena.bin";
+
+// Write the debug sphere as bricks.bin: raw f32 and zstd alternating, so
+// both in-place (mmap) and decoded bricks are exercised.
+bool write_bricks(int dims, genmesh::Manifest& m, genmesh::BricksIndex& idx) {
+    auto gen = genmesh::debug_generate("sphere", dims, 1.0f);
+    if (!gen.ok) return false;
+    m = gen.manifest;
+    idx = {};
+    idx.version = 1;
+    idx.brick_size = m.brick_size;
+    idx.dtype = "f32";
+    idx.dims = m.dims;
+
+    std::ofstream ofs(kBin, std::ios::binary);
+    int64_t offset = 0;
+    for (size_t i = 0; i < gen.bricks.size(); ++i) {
+        const auto& bd = gen.bricks[i];
+        const auto* raw = reinterpret_cast<const uint8_t*>(bd.data());
+        const size_t bytes = bd.size() * sizeof(float);
+        genmesh::BrickEntry e;
+        e.bx = bd.bx;
+        e.by = bd.by;
+        e.bz = bd.bz;
+        e.offset_bytes = offset;
+        if (i % 2 == 0) {
+            e.encoding = "raw";
+            e.payload_bytes = static_cast<int64_t>(bytes);
+            ofs.write(reinterpret_cast<const char*>(raw), static_cast<std::streamsize>(bytes));
+        } else {
+            auto z = genmesh::encode_brick_payload("zstd", raw, bytes);
+            e.encoding = "zstd";
+            e.payload_bytes = static_cast<int64_t>(z.size());
+            ofs.write(reinterpret_cast<const char*>(z.data()),
+                      static_cast<std::streamsize>(z.size()));
+        }
+        offset += e.payload_bytes;
+        idx.bricks.push_back(e);
+    }
+    return static_cast<bool>(ofs);
+}
+
+struct Sample {
+    double ms = 0.0;
+    int64_t allocs = 0;
+    int64_t large = 0;
+    bool ok = true;
+};
+
+template <typename Fn>
+Sample measure(int iterations, Fn&& fn) {
+    Sample s;
+    for (int it = 0; it < iterations; ++it) {
+        const int64_t a0 = g_allocs.load();
+        const int64_t l0 = g_large.load();
+        auto t0 = Clock::now();
+        s.ok = fn() && s.ok;
+        s.ms += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        s.allocs += g_allocs.load() - a0;
+        s.large += g_large.load() - l0;
+    }
+    s.ms /= iterations;
+    s.allocs /= iterations;
+    s.large /= iterations;
+    return s;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int dims = argc > 1 ? std::atoi(argv[1]) : 256;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    genmesh::min_log_level() = genmesh::LogLevel::Error;
+
+    genmesh::Manifest m;
+    genmesh::BricksIndex idx;
+    if (!write_bricks(dims, m, idx)) {
+        std::fprintf(stderr, "failed to write %s\n", kBin);
+        return 1;
+    }
+
+    std::printf("dims=%d^3 B=%d bricks=%zu iterations=%d\n", dims, m.brick_size,
+                idx.bricks.size(), iterations);
+    std::printf("%-10s %-8s %-7s %10s %10s %10s\n", "mode", "api", "arena", "ms", "allocs",
+                "large");
+
+    const struct {
+        const char* name;
+        genmesh::ReadMode mode;
+    } modes[] = {
+        {"stream", genmesh::ReadMode::Stream},
+        {"mmap", genmesh::ReadMode::Mmap},
+        {"coalesced", genmesh::ReadMode::Coalesced},
+    };
+
+    bool ok = true;
+    for (const auto& md : modes) {
+        for (bool streamed : {false, true}) {
+            for (bool arena : {false, true}) {
+                genmesh::BricksReadOptions opts;
+                opts.mode = md.mode;
+                opts.arena = arena;
+                auto s = measure(iterations, [&] {
+                    if (!streamed) return genmesh::load_bricks_bin(kBin, idx, m, opts).ok;
+                    std::atomic<int64_t> sum{0};
+                    auto r = genmesh::stream_bricks_bin(kBin, idx, m, opts,
+                                                        [&](const genmesh::BrickData& bd) {
+                                                            sum += bd.size();
+                                                        });
+                    return r.ok;
+                });
+                std::printf("%-10s %-8s %-7s %10.1f %10lld %10lld\n", md.name,
+                            streamed ? "stream" : "load", arena ? "on" : "off", s.ms,
+                            static_cast<long long>(s.allocs), static_cast<long long>(s.large));
+                ok = ok && s.ok;
+            }
+        }
+    }
+
+    std::remove(kBin);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+// CRC32 throughput per kernel.
+//
+// usage: bench_crc32 [bytes] [iterations]
+//   defaults: 1 MiB (one B=64 f32 brick), 200 iterations
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "genmesh/crc32.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    const size_t bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64u * 64u * 64u * 4u;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::vector<uint8_t> buf(bytes);
+    std::mt19937 rng(42);
+    for (auto& b : buf) b = static_cast<uint8_t>(rng());
+
+    std::printf("bytes=%zu iterations=%d auto=%s\n", bytes, iterations,
+                genmesh::crc32_kernel_name());
+    std::printf("%-8s %10s %10s %10s\n", "kernel", "ms", "GB/s", "crc");
+
+    const struct {
+        const char* name;
+        genmesh::Crc32Kernel kernel;
+    } kernels[] = {
+        {"slice16", genmesh::Crc32Kernel::Slice16},
+        {"pclmul", genmesh::Crc32Kernel::Pclmul},
+    };
+
+    for (const auto& k : kernels) {
+        if (!genmesh::crc32_kernel_supported(k.kernel)) {
+            std::printf("%-8s %10s\n", k.name, "n/a");
+            continue;
+        }
+        uint32_t crc = genmesh::crc32(buf.data(), buf.size(), 0, k.kernel);  // warm-up
+
+        auto t0 = Clock::now();
+        for (int it = 0; it < iterations; ++it) {
+            crc = genmesh::crc32(buf.data(), buf.size(), 0, k.kernel);
+        }
+        const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::printf("%-8s %10.2f %10.2f   %08x\n", k.name, sec * 1e3,
+                    static_cast<double>(bytes) * iterations / sec / 1e9, crc);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// f16 → f32 conversion throughput per kernel.
+//
+// usage: bench_half [voxels] [iterations]
+//   defaults: 64^3 voxels (one B=64 brick), 200 iterations
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "genmesh/half.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double run(genmesh::HalfKernel kernel, const std::vector<uint16_t>& src,
+                  std::vector<float>& dst, int iterations) {
+    // warm-up (page faults, frequency ramp)
+    genmesh::half_to_float_n(src.data(), dst.data(), src.size(), kernel);
+
+    auto t0 = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        genmesh::half_to_float_n(src.data(), dst.data(), src.size(), kernel);
+    }
+    auto t1 = Clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+    const size_t voxels = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64u * 64u * 64u;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    // Finite SDF-like values: mostly normals, a few denormals/zeros.
+    std::vector<uint16_t> src(voxels);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> dist(0, 0x7BFF);
+    for (auto& h : src) {
+        h = static_cast<uint16_t>(dist(rng) | ((rng() & 1u) << 15));
+    }
+    std::vector<float> dst(voxels);
+
+    std::printf("voxels=%zu iterations=%d auto=%s\n", voxels, iterations,
+                genmesh::half_kernel_name());
+    std::printf("%-8s %10s %12s %12s\n", "kernel", "ms", "in GB/s", "out GB/s");
+
+    const struct {
+        const char* name;
+        genmesh::HalfKernel kernel;
+    } kernels[] = {
+        {"scalar", genmesh::HalfKernel::Scalar},
+        {"f16c", genmesh::HalfKernel::F16C},
+        {"avx512", genmesh::HalfKernel::Avx512},
+    };
+
+    for (const auto& k : kernels) {
+        if (!genmesh::half_kernel_supported(k.kernel)) {
+            std::printf("%-8s %10s\n", k.name, "n/a");
+            continue;
+        }
+        const double sec = run(k.kernel, src, dst, iterations);
+        const double in_bytes = static_cast<double>(voxels) * sizeof(uint16_t) * iterations;
+        const double out_bytes = static_cast<double>(voxels) * sizeof(float) * iterations;
+        std::printf("%-8s %10.2f %12.2f %12.2f\n", k.name, sec * 1e3,
+                    in_bytes / sec / 1e9, out_bytes / sec / 1e9);
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+// Brick codec comparison on the examples/ shapes: raw vs zstd vs lz4 vs sdfp
+// vs band-quantized q8/q16.
+//
+// usage: bench_sdf_codec [voxel_size] [iterations]
+//   defaults: voxel_size 1.0 (examples' default grid), 3 decode iterations
+//
+// Shapes mirror examples/{sphere,gyroid,csg,linked-torus}/*.wgsl, sampled at
+// voxel centers in B=64 bricks; background-only bricks (|d| >= 3 voxels
+// everywhere) are skipped like sdf-baker does. q8/q16 use that 3-voxel band;
+// their max error only counts in-band voxels (outside, only the sign is kept).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "genmesh/brick_codec.h"
+#include "genmesh/sdf_codec.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Vec3 {
+    float x, y, z;
+};
+
+float length3(float x, float y, float z) { return std::sqrt(x * x + y * y + z * z); }
+
+float sdf_sphere(Vec3 p) { return length3(p.x - 32.0f, p.y - 32.0f, p.z - 32.0f) - 25.6f; }
+
+float sdf_gyroid(Vec3 p) {
+    const float s = 0.1f;
+    const float g = std::sin(p.x * s) * std::cos(p.y * s) + std::sin(p.y * s) * std::cos(p.z * s) +
+                    std::sin(p.z * s) * std::cos(p.x * s);
+    return std::fabs(g) - 0.5f;
+}
+
+float sdf_csg(Vec3 p) {
+    const float qx = p.x - 64.0f, qy = p.y - 64.0f, qz = p.z - 64.0f;
+    const float sphere = length3(qx, qy, qz) - 40.0f;
+    const float dx = std::fabs(qx) - 25.0f, dy = std::fabs(qy) - 25.0f, dz = std::fabs(qz) - 25.0f;
+    const float box_d = length3(std::max(dx, 0.0f), std::max(dy, 0.0f), std::max(dz, 0.0f)) +
+                        std::min(std::max(dx, std::max(dy, dz)), 0.0f);
+    return std::max(sphere, -box_d);
+}
+
+float sdf_torus(float px, float py, float pz, float R, float r) {
+    const float qx = std::sqrt(px * px + pz * pz) - R;
+    return std::sqrt(qx * qx + py * py) - r;
+}
+
+float sdf_linked_torus(Vec3 p) {
+    const float cx = 49.0f, cy = 64.0f, cz = 64.0f;
+    const float t1 = sdf_torus(p.x - cx, p.y - cy, p.z - cz, 30.0f, 8.0f);
+    const float qx = p.x - cx - 30.0f, qy = p.y - cy, qz = p.z - cz;
+    const float t2 = sdf_torus(qx, qz, qy, 30.0f, 8.0f);
+    return std::min(t1, t2);
+}
+
+struct Shape {
+    const char* name;
+    float aabb_min;
+    float aabb_size;
+    std::function<float(Vec3)> sdf;
+};
+
+std::vector<std::vector<float>> bake(const Shape& s, float voxel, int B) {
+    const int dims = static_cast<int>(std::ceil(s.aabb_size / voxel));
+    const int nb = (dims + B - 1) / B;
+    const float bg = 3.0f * voxel;
+
+    std::vector<std::vector<float>> bricks;
+    for (int bz = 0; bz < nb; ++bz)
+        for (int by = 0; by < nb; ++by)
+            for (int bx = 0; bx < nb; ++bx) {
+                std::vector<float> v;
+                v.reserve(static_cast<size_t>(B) * B * B);
+                bool background = true;
+                for (int z = 0; z < B; ++z)
+                    for (int y = 0; y < B; ++y)
+                        for (int x = 0; x < B; ++x) {
+                            Vec3 p{s.aabb_min + (bx * B + x + 0.5f) * voxel,
+                                   s.aabb_min + (by * B + y + 0.5f) * voxel,
+                                   s.aabb_min + (bz * B + z + 0.5f) * voxel};
+                            const float d = s.sdf(p);
+                            background = background && std::fabs(d) >= bg;
+                            v.push_back(d);
+                        }
+                if (!background) bricks.push_back(std::move(v));
+            }
+    return bricks;
+}
+
+struct Codec {
+    std::string label;
+    std::string encoding;
+    float error_voxels;  // sdfp bound as a fraction of voxel_size (0 = lossless)
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const float voxel = argc > 1 ? std::strtof(argv[1], nullptr) : 1.0f;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 3;
+    const int B = 64;
+
+    const Shape shapes[] = {
+        {"sphere", 0.0f, 64.0f, sdf_sphere},
+        {"gyroid", -64.0f, 128.0f, sdf_gyroid},
+        {"csg", 0.0f, 128.0f, sdf_csg},
+        {"linked-torus", 0.0f, 128.0f, sdf_linked_torus},
+    };
+    const Codec codecs[] = {
+        {"raw", "raw", 0.0f},
+        {"zstd", "zstd", 0.0f},
+        {"lz4", "lz4", 0.0f},
+        {"sdfp", "sdfp", 0.0f},
+        {"sdfp/64", "sdfp", 1.0f / 64.0f},
+        {"sdfp/1024", "sdfp", 1.0f / 1024.0f},
+        {"q8", "q8", 0.0f},
+        {"q16", "q16", 0.0f},
+    };
+    const float band = 3.0f * voxel;
+
+    std::printf("voxel_size=%.3f B=%d (sdfp/N: error bound = voxel_size/N)\n", voxel, B);
+    std::printf("%-13s %-10s %7s %10s %10s %10s %12s\n", "shape", "codec", "bricks", "ratio",
+                "enc MB/s", "dec MB/s", "max err mm");
+
+    for (const auto& shape : shapes) {
+        const auto bricks = bake(shape, voxel, B);
+        const size_t raw_bytes = bricks.size() * static_cast<size_t>(B) * B * B * sizeof(float);
+
+        for (const auto& c : codecs) {
+            std::vector<std::vector<uint8_t>> enc;
+            auto t0 = Clock::now();
+            for (const auto& b : bricks) {
+                const auto* src = reinterpret_cast<const uint8_t*>(b.data());
+                if (c.encoding == "sdfp") {
+                    genmesh::SdfpOptions opts;
+                    opts.max_error_mm = genmesh::sdfp_error_bound(voxel, c.error_voxels);
+                    enc.push_back(genmesh::sdfp_encode(b.data(), B, opts));
+                } else if (genmesh::is_band_quantized_encoding(c.encoding)) {
+                    enc.push_back(genmesh::band_quantize(c.encoding, b.data(), b.size(), band));
+                } else {
+                    enc.push_back(genmesh::encode_brick_payload(c.encoding, src,
+                                                                b.size() * sizeof(float)));
+                }
+            }
+            const double enc_s = std::chrono::duration<double>(Clock::now() - t0).count();
+
+            size_t stored = 0;
+            for (const auto& e : enc) stored += e.size();
+
+            const bool quantized = genmesh::is_band_quantized_encoding(c.encoding);
+            std::vector<float> out(static_cast<size_t>(B) * B * B);
+            double max_err = 0.0;
+            std::string err;
+            auto t1 = Clock::now();
+            for (int it = 0; it < iterations; ++it) {
+                for (size_t i = 0; i < bricks.size(); ++i) {
+                    if (quantized) {
+                        genmesh::band_dequantize(c.encoding, enc[i].data(), out.size(), band, band,
+                                                 out.data());
+                    } else {
+                        genmesh::decode_brick_payload(c.encoding, enc[i].data(), enc[i].size(),
+                                                      reinterpret_cast<uint8_t*>(out.data()),
+                                                      out.size() * sizeof(float), &err);
+                    }
+                    if (it == 0) {
+                        for (size_t k = 0; k < out.size(); ++k) {
+                            if (quantized && std::fabs(bricks[i][k]) >= band) continue;
+                            max_err = std::max(max_err,
+                                               static_cast<double>(std::fabs(out[k] - bricks[i][k])));
+                        }
+                    }
+                }
+            }
+            const double dec_s = std::chrono::duration<double>(Clock::now() - t1).count();
+
+            std::printf("%-13s %-10s %7zu %10.2f %10.1f %10.1f %12.2e\n", shape.name,
+                        c.label.c_str(), bricks.size(),
+                        static_cast<double>(raw_bytes) / static_cast<double>(stored),
+                        raw_bytes / enc_s / 1e6, raw_bytes * iterations / dec_s / 1e6, max_err);
+        }
+    }
+    return 0;
+}
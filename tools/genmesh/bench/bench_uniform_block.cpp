@@ -0,0 +1,65 @@
+// Uniform 8^3 block scan throughput per kernel.
+//
+// usage: bench_uniform_block [brick_size] [iterations]
+//   defaults: one B=64 brick of solid interior (every block uniform, so each
+//   scan reads all 512 values), 2000 iterations
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "genmesh/uniform_block.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double run(genmesh::UniformKernel kernel, const std::vector<float>& brick, int B,
+                  int iterations, int64_t& uniform) {
+    uniform = 0;
+    auto t0 = Clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (int oz = 0; oz < B; oz += 8)
+            for (int oy = 0; oy < B; oy += 8)
+                for (int ox = 0; ox < B; ox += 8) {
+                    float v;
+                    uniform += genmesh::uniform_block(brick.data(), B, ox, oy, oz, v, kernel);
+                }
+    }
+    auto t1 = Clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+    const int B = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 2000;
+    if (B <= 0 || B % 8 != 0) {
+        std::fprintf(stderr, "brick_size must be a positive multiple of 8\n");
+        return 1;
+    }
+
+    const std::vector<float> brick(static_cast<size_t>(B) * B * B, -1000.0f);
+
+    std::printf("B=%d blocks=%d iterations=%d auto=%s\n", B, (B / 8) * (B / 8) * (B / 8),
+                iterations, genmesh::uniform_kernel_name());
+    std::printf("%-8s %10s %12s\n", "kernel", "ms", "GB/s");
+
+    const struct {
+        const char* name;
+        genmesh::UniformKernel kernel;
+    } kernels[] = {
+        {"scalar", genmesh::UniformKernel::Scalar},
+        {"avx2", genmesh::UniformKernel::Avx2},
+    };
+
+    for (const auto& k : kernels) {
+        if (!genmesh::uniform_kernel_supported(k.kernel)) {
+            std::printf("%-8s %10s\n", k.name, "n/a");
+            continue;
+        }
+        int64_t uniform = 0;
+        const double sec = run(k.kernel, brick, B, iterations, uniform);
+        const double bytes = static_cast<double>(brick.size()) * sizeof(float) * iterations;
+        std::printf("%-8s %10.2f %12.2f\n", k.name, sec * 1e3, bytes / sec / 1e9);
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+// build_vdb() throughput against per-voxel accessor insertion, then thread
+// scaling of the parallel build (1, 2, 4, ... N threads) on debug shapes.
+//
+// usage: bench_vdb_build [dims] [iterations]
+//   defaults: 256^3 debug sphere/box (B=64 bricks), 3 iterations
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <openvdb/openvdb.h>
+#include <tbb/global_control.h>
+
+#include "genmesh/debug_generate.h"
+#include "genmesh/log.h"
+#include "genmesh/vdb_builder.h"
+
+using Clock = std::chrono::steady_clock;
+
+// The pre-leaf build_vdb() loop: one setValue per non-background voxel.
+static openvdb::Index64 build_per_voxel(const genmesh::Manifest& m,
+                                        const std::vector<genmesh::BrickData>& bricks) {
+    auto grid = genmesh::create_grid(m);
+    auto acc = grid->getAccessor();
+    const int B = m.brick_size;
+    for (const auto& brick : bricks) {
+        const float* src = brick.data();
+        for (int z = 0; z < B; ++z)
+            for (int y = 0; y < B; ++y)
+                for (int x = 0; x < B; ++x) {
+                    const float v = src[static_cast<size_t>(x + B * (y + B * z))];
+                    if (v == m.background_value_mm) continue;
+                    acc.setValue(openvdb::Coord(brick.bx * B + x, brick.by * B + y,
+                                                brick.bz * B + z), v);
+                }
+    }
+    return grid->activeVoxelCount();
+}
+
+static std::string tree_bytes(const openvdb::FloatGrid& grid) {
+    std::ostringstream os(std::ios_base::binary);
+    grid.tree().writeTopology(os);
+    grid.tree().writeBuffers(os);
+    return os.str();
+}
+
+// Time build_vdb() with 1, 2, 4, ... hardware_concurrency threads and check
+// every result against the serial grid. Returns false on a mismatch.
+static bool bench_threads(const char* shape, int dims, int iterations) {
+    auto gen = genmesh::debug_generate(shape, dims, 1.0f);
+    if (!gen.ok) {
+        std::fprintf(stderr, "debug_generate failed: %s\n", gen.error_msg.c_str());
+        return false;
+    }
+    genmesh::VdbBuildOptions serial_opts;
+    serial_opts.parallel = false;
+    const auto serial = genmesh::build_vdb(gen.manifest, gen.bricks, serial_opts);
+    const std::string expected = tree_bytes(*serial.grid);
+
+    const int max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+
+    std::printf("\n%s: bricks=%zu\n", shape, gen.bricks.size());
+    std::printf("%-10s %10s %10s %10s\n", "threads", "ms", "speedup", "output");
+    bool same = true;
+    double sec_one = 0.0;
+    for (int t : counts) {
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism,
+                                  static_cast<size_t>(t));
+        double sec = 0.0;
+        bool match = true;
+        for (int it = 0; it < iterations; ++it) {
+            auto t0 = Clock::now();
+            genmesh::VdbBuildOptions opts;
+            opts.parallel = t > 1;
+            auto r = genmesh::build_vdb(gen.manifest, gen.bricks, opts);
+            sec += std::chrono::duration<double>(Clock::now() - t0).count();
+            match = match && tree_bytes(*r.grid) == expected;
+        }
+        if (t == 1) sec_one = sec;
+        std::printf("%-10d %10.1f %9.2fx %10s\n", t, sec / iterations * 1e3, sec_one / sec,
+                    match ? "same" : "DIFFER");
+        same = same && match;
+    }
+    return same;
+}
+
+int main(int argc, char** argv) {
+    const int dims = argc > 1 ? std::atoi(argv[1]) : 256;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    genmesh::min_log_level() = genmesh::LogLevel::Error;
+    genmesh::vdb_init();
+
+    auto gen = genmesh::debug_generate("sphere", dims, 1.0f);
+    if (!gen.ok) {
+        std::fprintf(stderr, "debug_generate failed: %s\n", gen.error_msg.c_str());
+        return 1;
+    }
+    const double voxels = static_cast<double>(gen.bricks.size()) *
+                          gen.manifest.brick_size * gen.manifest.brick_size *
+                          gen.manifest.brick_size;
+
+    std::printf("dims=%d^3 B=%d bricks=%zu iterations=%d\n", dims, gen.manifest.brick_size,
+                gen.bricks.size(), iterations);
+    std::printf("%-10s %10s %14s\n", "method", "ms", "Mvoxels/s");
+
+    double sec_voxel = 0.0;
+    double sec_leaf = 0.0;
+    openvdb::Index64 active_voxel = 0;
+    int64_t active_leaf = 0;
+    for (int it = 0; it < iterations; ++it) {
+        auto t0 = Clock::now();
+        active_voxel = build_per_voxel(gen.manifest, gen.bricks);
+        auto t1 = Clock::now();
+        auto r = genmesh::build_vdb(gen.manifest, gen.bricks);
+        auto t2 = Clock::now();
+        active_leaf = r.active_voxel_count;
+        sec_voxel += std::chrono::duration<double>(t1 - t0).count();
+        sec_leaf += std::chrono::duration<double>(t2 - t1).count();
+    }
+
+    std::printf("%-10s %10.1f %14.1f\n", "per-voxel", sec_voxel / iterations * 1e3,
+                voxels * iterations / sec_voxel / 1e6);
+    std::printf("%-10s %10.1f %14.1f\n", "leaves", sec_leaf / iterations * 1e3,
+                voxels * iterations / sec_leaf / 1e6);
+    std::printf("speedup %.1fx, active voxels %s\n", sec_voxel / sec_leaf,
+                static_cast<int64_t>(active_voxel) == active_leaf ? "match" : "DIFFER");
+
+    bool ok = static_cast<int64_t>(active_voxel) == active_leaf;
+    for (const char* shape : {"sphere", "box"}) {
+        ok = bench_threads(shape, dims, iterations) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace genmesh {
+
+/// Fixed-size brick buffers carved out of large aligned slabs.
+///
+/// Decoded bricks are all the same size (B^3 values), so instead of one heap
+/// allocation per brick the reader takes slots from a few slabs of
+/// `slots_per_slab` bricks each. Released slots go back on a free list and
+/// are reused, so a streamed read recycles the same few buffers. Every slot
+/// starts on a kAlignment boundary.
+///
+/// With `huge_pages`, slabs are 2 MiB aligned and advised as transparent huge
+/// pages (Linux MADV_HUGEPAGE); elsewhere, or if the kernel refuses, they
+/// are ordinary pages and huge_pages() reports false.
+class BrickArena : public std::enable_shared_from_this<BrickArena> {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    static std::shared_ptr<BrickArena> create(size_t slot_bytes, size_t slots_per_slab,
+                                              bool huge_pages = false);
+    ~BrickArena();
+
+    BrickArena(const BrickArena&) = delete;
+    BrickArena& operator=(const BrickArena&) = delete;
+
+    /// A free slot of slot_bytes(), or a slot of a new slab when none is free.
+    /// The slot goes back to the arena when the last copy of the returned
+    /// pointer is released; the arena stays alive until then. Thread-safe.
+    std::shared_ptr<void> acquire();
+
+    size_t slot_bytes() const { return slot_bytes_; }
+    size_t slab_count() const;
+    size_t slab_bytes() const;  // memory held by all slabs
+    size_t slots_in_use() const;
+    bool huge_pages() const;  // some slab is backed by huge pages
+
+private:
+    BrickArena() = default;
+
+    struct Slab {
+        void* data;
+        size_t bytes;
+        bool page_aligned;  // posix_memalign'ed for huge pages (freed with free())
+    };
+
+    void add_slab();  // mutex_ held
+    void release(void* slot);
+
+    size_t slot_bytes_ = 0;
+    size_t stride_ = 0;  // slot_bytes_ rounded up to kAlignment
+    size_t slots_per_slab_ = 0;
+    bool want_huge_pages_ = false;
+
+    mutable std::mutex mutex_;
+    std::vector<Slab> slabs_;
+    std::vector<void*> free_;
+    size_t in_use_ = 0;
+    bool huge_pages_ = false;
+};
+
+}  // namespace genmesh
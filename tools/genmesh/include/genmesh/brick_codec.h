@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace genmesh {
+
+/// Per-brick payload encodings (bricks.index.json `encoding`, spec §5.4).
+///
+/// Every brick is compressed on its own, so bricks decode independently
+/// (and in parallel). The decoded form is always the dense raw payload:
+/// B^3 values of the index dtype, little-endian, x-fastest.
+///
+///   raw   stored as-is
+///   zstd  one Zstandard frame
+///   lz4   one LZ4 block (no frame header; decoded size is implied by B/dtype)
+///   sdfp  SDF predictive codec, f32 only (see sdf_codec.h)
+///   q8    band-quantized int8 fixed point (see band_dequantize)
+///   q16   band-quantized int16 fixed point
+///   constant  no payload; every voxel equals the entry's `value`
+
+/// Whether `encoding` is a known value for bricks.index.json.
+bool is_known_encoding(std::string_view encoding);
+
+/// Whether `encoding` can store bricks of `dtype` ("f16"|"f32").
+inline bool encoding_supports_dtype(std::string_view encoding, std::string_view dtype) {
+    return encoding != "sdfp" || dtype == "f32";
+}
+
+/// Whether `encoding` carries its value in the index instead of bricks.bin.
+inline bool is_constant_encoding(std::string_view encoding) { return encoding == "constant"; }
+
+/// Whether payload_bytes of such a brick must equal the raw size.
+inline bool is_raw_encoding(std::string_view encoding) { return encoding == "raw"; }
+
+/// Whether `encoding` stores band-quantized fixed point ("q8" / "q16").
+/// These payloads have a fixed size of B^3 * band_quantized_value_bytes()
+/// whatever the index dtype, and do not go through decode_brick_payload().
+inline bool is_band_quantized_encoding(std::string_view encoding) {
+    return encoding == "q8" || encoding == "q16";
+}
+
+/// Bytes per stored value of a band-quantized encoding.
+inline size_t band_quantized_value_bytes(std::string_view encoding) {
+    return encoding == "q8" ? 1 : 2;
+}
+
+/// Band-quantized bricks store each distance d as q = round(d / band * Q),
+/// Q = 127 (q8) or 32767 (q16), with band = half_width_voxels * voxel_size.
+/// |q| >= Q marks a voxel outside the band, where only the sign matters.
+///
+/// Expand `n` stored values (little-endian) into floats: in-band values
+/// become q * band / Q, saturated ones +/-saturation_mm. The loader passes
+/// background_value_mm, so positive saturation is skipped by the VDB build
+/// exactly like background.
+void band_dequantize(std::string_view encoding, const uint8_t* src, size_t n,
+                     float band_mm, float saturation_mm, float* dst);
+
+/// Quantize `n` floats for a "q8" / "q16" brick (tests, benchmarks and
+/// debug tooling). |d| >= band and NaN saturate, keeping the sign.
+std::vector<uint8_t> band_quantize(std::string_view encoding, const float* src, size_t n,
+                                   float band_mm);
+
+/// Decode `src` (the stored bytes) into exactly `dst_size` bytes at `dst`
+/// (float-aligned for "sdfp", which writes floats directly).
+/// Returns false with a short reason in *error_msg on corrupt input or a
+/// decoded size other than dst_size.
+bool decode_brick_payload(std::string_view encoding,
+                          const uint8_t* src, size_t src_size,
+                          uint8_t* dst, size_t dst_size,
+                          std::string* error_msg);
+
+/// Encode a raw payload (used by tests, benchmarks and debug tooling).
+/// `level` is codec-specific; 0 picks the codec default. "sdfp" is encoded
+/// lossless here; use sdfp_encode() for a bounded-error stream. "q8" / "q16"
+/// need the band width and return an empty vector; use band_quantize().
+std::vector<uint8_t> encode_brick_payload(std::string_view encoding,
+                                          const uint8_t* src, size_t src_size,
+                                          int level = 0);
+
+}  // namespace genmesh
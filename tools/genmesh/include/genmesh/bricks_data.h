@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -11,16 +15,106 @@
 namespace genmesh {
 
 /// A loaded brick: dense B^3 float values in x-fastest order.
+///
+/// Values are either owned (`values`) or a view (`view`): zero-copy into the
+/// mapped bricks.bin in the mmap reader mode, or a slot of a BrickArena
+/// (BricksReadOptions::arena). Always read them through data()/size(). A "constant" brick has no storage at all: check
+/// `constant` first, data()/size() are then empty.
+///
+/// With BricksReadOptions::keep_half, f16 bricks keep their binary16 values
+/// (`half_values`, or `half_view` into the mapping) and data() is empty:
+/// check is_half() and read half_data(), or use brick_floats().
 struct BrickData {
     int bx = 0;
     int by = 0;
     int bz = 0;
-    std::vector<float> values;  // B^3 floats (x-fastest order)
+    std::vector<float> values;  // B^3 floats (x-fastest order); empty when `view` is set
+
+    const float* view = nullptr;            // non-owning B^3 floats (mmap mode f32, arena slot)
+    size_t view_size = 0;                   // length of `view` or `half_view`
+    std::shared_ptr<const void> keepalive;  // keeps the mapping / arena slot behind `view` alive
+
+    std::vector<uint16_t> half_values;      // B^3 binary16 (keep_half); empty otherwise
+    const uint16_t* half_view = nullptr;    // non-owning B^3 binary16 (mmap mode / arena, keep_half)
+
+    std::optional<float> constant;          // every voxel has this value (encoding "constant")
+
+    const float* data() const { return view ? view : values.data(); }
+    size_t size() const {
+        if (view || half_view) return view_size;
+        return is_half() ? half_values.size() : values.size();
+    }
+
+    bool is_half() const { return half_view || !half_values.empty(); }
+    const uint16_t* half_data() const { return half_view ? half_view : half_values.data(); }
+};
+
+/// Float values of `bd`: data() itself, or for f16 storage the values
+/// widened into `scratch` (resized as needed). nullptr for constant bricks.
+const float* brick_floats(const BrickData& bd, std::vector<float>& scratch);
+
+/// Non-owning view of one brick: its coordinates and B^3 float values
+/// (x-fastest), or its constant. What the grid builder consumes, whoever
+/// owns the storage (vector, arena slot, mapping).
+struct BrickView {
+    int bx = 0;
+    int by = 0;
+    int bz = 0;
+    const float* values = nullptr;  // nullptr for constant bricks
+    size_t size = 0;
+    std::optional<float> constant;
 };
 
+/// View of `bd`; f16 storage is widened into `scratch` (see brick_floats()).
+BrickView brick_view(const BrickData& bd, std::vector<float>& scratch);
+
+/// Consumer of streamed bricks (stream_bricks_bin(), debug_generate()). The
+/// brick, and the buffer behind it, is released as soon as the call returns,
+/// so the sink must copy what it keeps. May be called from several threads
+/// at once.
+using BrickSink = std::function<void(const BrickData&)>;
+
+/// How bricks.bin is read.
+enum class ReadMode {
+    Stream,  // seekg + read into owned buffers
+    Mmap,    // memory-map the file; f32 bricks become views into the mapping
+    Coalesced,  // offset-sorted, merged positional reads, several in flight
+};
+
+/// Reader options for load_bricks_bin().
+struct BricksReadOptions {
+    ReadMode mode = ReadMode::Stream;
+    bool parallel = true;    // decode bricks with tbb::parallel_for
+    bool verify_crc = true;  // false: skip crc32 here, run verify_bricks_crc() separately
+    bool direct_io = false;  // Coalesced only: bypass the page cache (O_DIRECT) if possible
+    bool cull = false;       // skip bricks whose min/max keep them off the surface (classify_brick)
+    std::optional<float> summary_iso;  // iso crosses_iso was written for (default: manifest.iso)
+    bool keep_half = false;  // dtype f16: leave raw/zstd/lz4 payloads as binary16 in BrickData
+    bool arena = false;      // decode into BrickArena slots instead of per-brick vectors
+    bool huge_pages = false; // arena: back the slabs with transparent huge pages if possible
+};
+
+/// What the min/max summary of an index entry says about the surface.
+enum class BrickCull {
+    Keep,     // may touch the band around the surface, or no summary
+    Outside,  // every value > surface + band: left out, like an omitted brick
+    Inside,   // every value < surface - band: becomes a constant brick (value = max)
+};
+
+/// Classify `entry` from its summary alone (no payload access) against the
+/// surface the mesher extracts, iso + offset_mm, with a band of
+/// half_width_voxels * voxel_size + |offset_mm| (the offset filter reads the
+/// band around the unshifted surface too). Constant bricks and entries
+/// without min/max are always Keep.
+BrickCull classify_brick(const BrickEntry& entry, const Manifest& manifest);
+
 /// Result of loading bricks.bin
 struct BricksDataResult {
     std::vector<BrickData> bricks;
+    size_t unique_payloads = 0;  // stored payloads actually read (shared ones count once)
+    size_t culled_outside = 0;   // options.cull: bricks left out
+    size_t culled_inside = 0;    // options.cull: bricks turned into constant interior
+    size_t arena_bytes = 0;      // options.arena: slab memory the decoded bricks took
     bool ok = false;
     ExitCode exit_code = ExitCode::Success;
     std::vector<ValidationError> errors;
@@ -29,10 +123,73 @@ struct BricksDataResult {
 /// Load brick data from bricks.bin using the parsed index and manifest.
 ///
 /// - Validates that each brick's (offset_bytes + payload_bytes) is within file size.
-/// - Reads raw f32 or f16 data, converting f16 → float.
-/// - If crc32 is present in a BrickEntry, verifies CRC32 of the raw payload.
+/// - Reads raw f32 or f16 data, converting f16 → float. zstd/lz4/sdfp bricks
+///   are decompressed per brick (E1107 if corrupt); q8/q16 bricks are expanded
+///   against the manifest's narrow band (see band_dequantize). "constant"
+///   bricks read nothing from bricks.bin and come back with `constant` set.
+/// - If crc32 is present in a BrickEntry, verifies CRC32 of the stored payload
+///   (unless options.verify_crc is false).
+/// - ReadMode::Mmap maps the file once; 4-byte aligned raw f32 payloads are
+///   not copied, only f16 and compressed payloads get a decode buffer.
+/// - Entries that reference the same stored payload (same offset_bytes,
+///   payload_bytes, encoding, crc32) are read and decoded once; the others
+///   get a BrickData that shares the decoded buffer via view/keepalive.
+/// - ReadMode::Coalesced sorts payloads by offset and merges neighbours
+///   (holes <= 64 KiB, runs <= 16 MiB) into single pread/ReadFile calls, one
+///   in flight per TBB worker. With direct_io, runs are block-aligned and
+///   bypass the page cache; W2002 if the filesystem refuses it.
+/// - Entries with a min/max summary are checked against the decoded values
+///   (every value within [min, max]), crosses_iso against whether the values
+///   straddle options.summary_iso; E1108 on disagreement.
+/// - With options.cull, entries are first classified by classify_brick().
+///   Outside / Inside bricks are neither read nor CRC-checked; Inside ones
+///   come back as constant bricks.
+/// - With options.keep_half and dtype "f16", raw and zstd/lz4 payloads are
+///   not widened: bricks come back with half_values (ReadMode::Mmap: a
+///   half_view into the mapping when the offset is 2-byte aligned), half the
+///   memory of floats. q8/q16 bricks still decode to floats.
+/// - With options.arena, decoded values go into slots of a BrickArena (a
+///   single aligned slab per element size here) instead of a std::vector per
+///   brick: bricks come back as views (`view` / `half_view`) whose keepalive
+///   is the slot. Payloads used in place (mmap) take no slot.
+///   binary16 bricks (keep_half) use slots of half the size, in an arena of
+///   their own.
+/// - With options.parallel, bricks are decoded on the TBB pool. `bricks` and
+///   `errors` keep index order either way.
 BricksDataResult load_bricks_bin(const std::string& bin_path,
                                  const BricksIndex& index,
-                                 const Manifest& manifest);
+                                 const Manifest& manifest,
+                                 const BricksReadOptions& options = {});
+
+/// load_bricks_bin() that hands each brick to `sink` as soon as it is decoded
+/// and checked, instead of collecting them: only the bricks being decoded or
+/// consumed at the moment are in memory (about one per TBB worker, plus a
+/// coalesced run buffer each).
+///
+/// Bricks arrive in no particular order; entries sharing a payload arrive
+/// right after the first one, sharing its buffer. Inside bricks dropped by
+/// options.cull come first, as constant bricks. `result.bricks` stays empty;
+/// errors are collected in index order as in load_bricks_bin(), and a brick
+/// with an error is not handed over. The sink may already have received
+/// other bricks when the result is not ok. With options.arena the slab holds
+/// a few bricks per TBB worker and slots are recycled as the sink releases
+/// them, so a long read allocates no brick buffers after the first ones. In ReadMode::Mmap the mapping
+/// (page cache, counted in RSS while mapped) stays until the call returns.
+BricksDataResult stream_bricks_bin(const std::string& bin_path,
+                                   const BricksIndex& index,
+                                   const Manifest& manifest,
+                                   const BricksReadOptions& options,
+                                   const BrickSink& sink);
+
+/// Verify the crc32 of every index entry that carries one, independently of
+/// load_bricks_bin(). Meant to run concurrently with the VDB build when the
+/// loader was called with verify_crc = false.
+///
+/// The file is mapped read-only; `bricks` stays empty. Errors (E1106) are in
+/// index order. Entries outside the file are skipped (the loader reports
+/// them as E1105). A payload shared by several entries is checked once.
+BricksDataResult verify_bricks_crc(const std::string& bin_path,
+                                   const BricksIndex& index,
+                                   bool parallel = true);
 
 }  // namespace genmesh
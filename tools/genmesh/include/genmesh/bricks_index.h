@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -17,8 +18,17 @@ struct BrickEntry {
     int bz = 0;
     int64_t offset_bytes = 0;
     int64_t payload_bytes = 0;
-    std::string encoding;            // v1: "raw" only
+    std::string encoding;            // see brick_codec.h
     std::optional<std::string> crc32; // optional hex string
+    std::optional<float> value;      // "constant" only: value of every voxel
+    std::optional<std::string> content_hash;  // optional hex digest of the stored payload
+
+    // Optional summary of the decoded values (spec §5.4). min/max bound every
+    // voxel; crosses_iso says whether the brick has values on both sides of
+    // the manifest iso as written. Checked against the payload when read.
+    std::optional<float> min;
+    std::optional<float> max;
+    std::optional<bool> crosses_iso;
 };
 
 /// Parsed bricks index
@@ -41,7 +51,41 @@ struct BricksIndexResult {
 
 /// Load and validate bricks.index.json from a file path.
 /// Validates internal consistency and cross-checks against manifest.
+/// The file is parsed with a streaming (SAX) handler that fills the index
+/// directly, so million-brick indices never materialize as a JSON DOM.
+/// Repeated keys follow JSON-object semantics: the last occurrence wins.
 BricksIndexResult load_bricks_index(const std::string& path,
                                     const Manifest& manifest);
 
+/// Run the load_bricks_index() checks on an index built some other way
+/// (e.g. from the bricks.pack directory). Every field counts as present.
+BricksIndexResult validate_bricks_index(BricksIndex index, const Manifest& manifest);
+
+/// Axis-aligned box in world space (mm), e.g. --clip-bbox.
+struct WorldBox {
+    std::array<float, 3> min = {};
+    std::array<float, 3> max = {};
+};
+
+/// What clip_bricks_index() removed.
+struct BrickClipStats {
+    int64_t kept = 0;
+    int64_t skipped = 0;
+    int64_t bytes_skipped = 0;  // stored payload bytes no kept entry references
+};
+
+/// Keep only the entries whose bricks intersect `box` grown by
+/// `margin_voxels` on every side; order is preserved. Voxel (i,j,k) sits at
+/// aabb_min + (i,j,k) * voxel_size, the same mapping as create_grid().
+BrickClipStats clip_bricks_index(BricksIndex& index, const Manifest& manifest,
+                                 const WorldBox& box, int margin_voxels);
+
+/// Margin (voxels) for clip_bricks_index() that keeps every brick the grid
+/// inside the box depends on: the band and the voxel the mesher reads past
+/// it, plus how far the offset (manifest offset_mm) and the shell erosion
+/// (`shell_mm`, 0 without --shell) reach. Bricks past it are never read and
+/// act as outside; eroding by more than the margin would pull that fake
+/// surface into the box.
+int clip_margin_voxels(const Manifest& manifest, float shell_mm = 0.0f);
+
 }  // namespace genmesh
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "genmesh/bricks_index.h"
+#include "genmesh/exit_code.h"
+#include "genmesh/manifest.h"
+#include "genmesh/mapped_file.h"
+
+namespace genmesh {
+
+/// bricks.pack: manifest, brick directory and payloads in one file (spec §5.7).
+///
+/// Layout (little-endian):
+///
+///   PackHeader                 fixed 128 bytes
+///   manifest                   project.json bytes, as written by the producer
+///   directory                  PackDirEntry[brick_count], ascending Morton code
+///   slots                      uint32[grid x*y*z], x-fastest: directory index + 1, 0 = no brick
+///   payloads                   each at a kPackAlignment-aligned absolute offset
+///
+/// Payload offsets are absolute file offsets, so the pack itself is read by
+/// load_bricks_bin() exactly like bricks.bin (every ReadMode, direct I/O).
+/// Nothing but the manifest is JSON: BricksPack maps the file and finds
+/// any brick through the slot table in O(1).
+
+inline constexpr char kPackMagic[8] = {'G', 'M', 'B', 'P', 'A', 'C', 'K', '\0'};
+inline constexpr uint32_t kPackVersion = 1;
+inline constexpr uint64_t kPackAlignment = 4096;
+
+struct PackHeader {
+    char magic[8];              // kPackMagic
+    uint32_t version;           // kPackVersion
+    uint32_t header_bytes;      // sizeof(PackHeader)
+    uint32_t brick_size;        // must match manifest brick.size
+    uint32_t grid[3];           // bricks per axis: ceil(dims / brick_size)
+    uint64_t manifest_offset;
+    uint64_t manifest_bytes;
+    uint64_t directory_offset;  // 8-byte aligned
+    uint64_t brick_count;
+    uint64_t slots_offset;      // 4-byte aligned
+    uint64_t data_offset;       // first payload, kPackAlignment aligned
+    uint64_t file_bytes;        // total size, catches truncated copies
+    uint8_t reserved[40];       // zero
+};
+static_assert(sizeof(PackHeader) == 128, "PackHeader layout");
+
+/// Directory entry. Encodings are stored as PackEncoding ids; constant
+/// bricks keep their value here and have no payload. min/max/crosses_iso
+/// carry the optional index summary (spec §5.4).
+struct PackDirEntry {
+    uint64_t morton;         // morton3_encode(bx, by, bz)
+    uint64_t offset_bytes;   // absolute; entries may share a payload
+    uint32_t payload_bytes;
+    uint32_t crc32;          // valid if flags & kPackHasCrc32
+    float value;             // "constant" only
+    uint8_t encoding;        // PackEncoding
+    uint8_t flags;
+    uint16_t reserved;       // zero
+    float min;               // valid if flags & kPackHasRange
+    float max;
+};
+static_assert(sizeof(PackDirEntry) == 40, "PackDirEntry layout");
+
+inline constexpr uint8_t kPackHasCrc32 = 1u << 0;
+inline constexpr uint8_t kPackHasRange = 1u << 1;
+inline constexpr uint8_t kPackHasCrossesIso = 1u << 2;
+inline constexpr uint8_t kPackCrossesIso = 1u << 3;  // crosses_iso value
+
+enum class PackEncoding : uint8_t { Raw, Zstd, Lz4, Sdfp, Q8, Q16, Constant };
+
+/// Interleave the low 21 bits of each coordinate (x in bit 0).
+uint64_t morton3_encode(uint32_t x, uint32_t y, uint32_t z);
+void morton3_decode(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z);
+
+/// A mapped bricks.pack. The structure (header bounds, table sizes) is
+/// checked on open; entries themselves are checked by load_bricks_pack().
+class BricksPack {
+public:
+    /// Returns nullptr and fills `error_msg` if the mapping is not a
+    /// well-formed bricks.pack.
+    static std::shared_ptr<BricksPack> open(std::shared_ptr<MappedFile> file,
+                                            std::string* error_msg = nullptr);
+
+    const PackHeader& header() const { return header_; }
+    std::string_view manifest_json() const;
+
+    size_t brick_count() const { return static_cast<size_t>(header_.brick_count); }
+    const PackDirEntry& entry(size_t i) const { return directory_[i]; }
+
+    /// Directory entry of brick (bx, by, bz), nullptr if the brick is absent.
+    const PackDirEntry* find(int bx, int by, int bz) const;
+
+    /// Stored bytes of `e` (nullptr for constant bricks).
+    const uint8_t* payload(const PackDirEntry& e) const;
+
+    /// Slot value of a grid cell (directory index + 1, 0 = absent).
+    uint32_t slot(int bx, int by, int bz) const;
+
+private:
+    BricksPack() = default;
+
+    std::shared_ptr<MappedFile> file_;
+    PackHeader header_ = {};
+    const PackDirEntry* directory_ = nullptr;
+    const uint32_t* slots_ = nullptr;
+};
+
+/// Result of loading a bricks.pack
+struct BricksPackResult {
+    Manifest manifest;
+    BricksIndex index;  // offsets are absolute within the pack
+    bool ok = false;
+    ExitCode exit_code = ExitCode::Success;
+    std::vector<ValidationError> errors;
+};
+
+/// Load bricks.pack into the same Manifest / BricksIndex that
+/// load_manifest() + load_bricks_index() produce, with the same checks
+/// (manifest E1xxx, index E1101-E1104). Pack structure errors are E1101,
+/// an unreadable file E2003. Payloads are left to load_bricks_bin().
+BricksPackResult load_bricks_pack(const std::string& path);
+
+/// Write a bricks.pack from a validated manifest + index and bricks.bin.
+/// `manifest_json` is embedded verbatim. Payloads shared by several entries
+/// are written once; content_hash is not carried over.
+/// Returns false with `error_msg` filled on failure.
+bool write_bricks_pack(const std::string& path, std::string_view manifest_json,
+                       const Manifest& manifest, const BricksIndex& index,
+                       const std::string& bin_path, std::string* error_msg = nullptr);
+
+}  // namespace genmesh
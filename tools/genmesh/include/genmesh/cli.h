@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace genmesh {
 
+/// --drain-hole x0,y0,z0..x1,y1,z1: axis of a drain hole (world mm)
+struct DrainSegment {
+    std::array<float, 3> from;
+    std::array<float, 3> to;
+};
+
 /// Parsed CLI arguments per spec section 2
 struct CliArgs {
     // Required
@@ -12,6 +20,9 @@ struct CliArgs {
     std::string in_dir;
     std::string out_dir;
 
+    // Single-file input: replaces manifest_path + in_dir
+    std::string pack_path;
+
     // Optional flags
     bool write_stl   = true;
     bool write_vdb   = false;
@@ -21,9 +32,39 @@ struct CliArgs {
     std::optional<float> iso;
     std::optional<float> adaptivity;
 
+    // Region of interest in world mm (--clip-bbox x0,y0,z0..x1,y1,z1)
+    std::optional<std::array<float, 3>> clip_min;
+    std::optional<std::array<float, 3>> clip_max;
+
     // Log level string
     std::string log_level = "info";
 
+    // bricks.bin reader mode
+    std::string read_mode = "stream";  // "stream" | "mmap" | "coalesced"
+    bool direct_io = false;            // coalesced reads bypass the page cache
+    bool cull_bricks = false;          // skip bricks whose min/max keep them off the surface
+    bool huge_pages = false;           // brick arena slabs advised as huge pages
+
+    // VDB build
+    bool narrow_band = false;  // only voxels near the surface active, signedFloodFill
+    bool half = false;         // f16 bricks stay f16 until the build; volume.vdb in half
+
+    // Hollowing (--shell, --drain-hole, --drain-radius)
+    std::optional<float> shell_mm;          // wall thickness
+    std::vector<DrainSegment> drain_holes;  // capsule axes, world mm
+    float drain_radius_mm = 1.5f;
+
+    // TPMS infill inside the shell (--infill, --infill-cell, --infill-wall)
+    std::string infill;  // "" | "gyroid" | "schwarz-p" | "diamond"
+    float infill_cell_mm = 8.0f;
+    float infill_wall_mm = 0.8f;
+
+    // When bricks.bin CRC32 is checked
+    std::string crc_verify = "inline";  // "inline" | "background"
+
+    // Worker threads for TBB (0 = all cores)
+    int threads = 0;
+
     // Debug
     std::string debug_generate;  // "" | "sphere" | "box"
 
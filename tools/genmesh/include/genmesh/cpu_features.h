@@ -0,0 +1,33 @@
+#pragma once
+
+/// Runtime CPU feature detection for the SIMD kernels (f16 conversion, CRC32).
+///
+/// Kernels are compiled with per-function target attributes (GCC/Clang) so the
+/// binary still runs on the baseline ISA; dispatch happens once at runtime.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GENMESH_X86 1
+#else
+#define GENMESH_X86 0
+#endif
+
+#if GENMESH_X86 && (defined(__GNUC__) || defined(__clang__))
+#define GENMESH_TARGET(isa) __attribute__((target(isa)))
+#else
+#define GENMESH_TARGET(isa)
+#endif
+
+namespace genmesh {
+
+struct CpuFeatures {
+    bool sse41 = false;
+    bool pclmul = false;
+    bool avx2 = false;
+    bool f16c = false;
+    bool avx512f = false;
+};
+
+/// Features of the running CPU *and* OS (YMM/ZMM state enabled). Cached.
+const CpuFeatures& cpu_features();
+
+}  // namespace genmesh
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace genmesh {
+
+/// CRC32 kernels (ISO 3309 / zlib polynomial 0xEDB88320).
+enum class Crc32Kernel {
+    Auto,     // best kernel supported by the running CPU
+    Slice16,  // portable slice-by-16 tables (built at compile time)
+    Pclmul,   // PCLMULQDQ carry-less multiply folding, 64 bytes per step
+};
+
+/// zlib-compatible CRC32: crc32(data, len) == zlib crc32(0, data, len).
+///
+/// `crc` is a previous result to continue from, so a buffer may be processed
+/// in pieces: crc32(b, n2, crc32(a, n1)) == crc32(a ++ b, n1 + n2).
+/// Thread-safe; no lazy initialization.
+uint32_t crc32(const void* data, size_t len, uint32_t crc = 0,
+               Crc32Kernel kernel = Crc32Kernel::Auto);
+
+/// Whether `kernel` can run on this CPU (Auto and Slice16 always can).
+bool crc32_kernel_supported(Crc32Kernel kernel);
+
+/// Name of the kernel that Crc32Kernel::Auto resolves to ("pclmul"|"slice16").
+const char* crc32_kernel_name();
+
+/// Parse a crc32 as written in bricks.index.json: exactly 8 hex digits,
+/// either case. Returns false (leaving `out` untouched) for anything else.
+bool parse_crc32_hex(std::string_view hex, uint32_t& out);
+
+}  // namespace genmesh
@@ -12,7 +12,8 @@ namespace genmesh {
 /// Result of debug SDF generation.
 struct DebugGenerateResult {
     Manifest manifest;
-    std::vector<BrickData> bricks;
+    std::vector<BrickData> bricks;  // empty when streamed to a sink
+    size_t brick_count = 0;         // bricks generated (all-background ones are left out)
     bool ok = false;
     ExitCode exit_code = ExitCode::Success;
     std::string error_msg;
@@ -33,4 +34,17 @@ DebugGenerateResult debug_generate(const std::string& shape,
                                    int dims = 64,
                                    float voxel_size = 1.0f);
 
+/// debug_generate() that hands each brick to `sink` as soon as it is
+/// computed instead of collecting them (`bricks` stays empty). The sink is
+/// called from this thread, in brick order. Each brick is a view into one
+/// recycled BrickArena slot, released when the sink returns.
+DebugGenerateResult debug_generate(const std::string& shape,
+                                   int dims,
+                                   float voxel_size,
+                                   const BrickSink& sink);
+
+/// The manifest debug_generate() produces for `dims` and `voxel_size`,
+/// for consumers that need it before the bricks arrive.
+Manifest debug_manifest(int dims = 64, float voxel_size = 1.0f);
+
 }  // namespace genmesh
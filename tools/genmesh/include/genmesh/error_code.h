@@ -28,6 +28,8 @@ inline constexpr std::string_view E1103 = "GENMESH_E1103";  // bricks.index.json
 inline constexpr std::string_view E1104 = "GENMESH_E1104";  // bricks payload_bytes mismatch
 inline constexpr std::string_view E1105 = "GENMESH_E1105";  // bricks offset out of file range
 inline constexpr std::string_view E1106 = "GENMESH_E1106";  // bricks CRC32 mismatch
+inline constexpr std::string_view E1107 = "GENMESH_E1107";  // bricks payload decode failure
+inline constexpr std::string_view E1108 = "GENMESH_E1108";  // brick summary disagrees with payload
 
 // --- E2xxx: I/O ----------------------------------------------------------
 inline constexpr std::string_view E2001 = "GENMESH_E2001";  // bricks.bin read failure
@@ -55,6 +57,8 @@ inline constexpr std::string_view E9001 = "GENMESH_E9001";  // unhandled excepti
 
 // --- Warnings (W) --------------------------------------------------------
 inline constexpr std::string_view W1001 = "GENMESH_W1001";  // optional field missing
+inline constexpr std::string_view W2002 = "GENMESH_W2002";  // direct I/O unavailable, buffered reads
+inline constexpr std::string_view W4001 = "GENMESH_W4001";  // narrow band unavailable, dense grid
 inline constexpr std::string_view W5001 = "GENMESH_W5001";  // degenerate triangles detected
 inline constexpr std::string_view W5002 = "GENMESH_W5002";  // winding inversion suspected
 
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace genmesh {
+
+/// f16 → f32 conversion kernels.
+enum class HalfKernel {
+    Auto,    // best kernel supported by the running CPU
+    Scalar,  // portable, branch-light
+    F16C,    // AVX2 + F16C, 8 values per step
+    Avx512,  // AVX-512F, 16 values per step
+};
+
+/// Software f16 → f32 conversion (IEEE 754 binary16), one value.
+float half_to_float(uint16_t h);
+
+/// Bulk conversion: dst[i] = half_to_float(src[i]) for i in [0, count).
+///
+/// Every kernel is bit-identical to half_to_float(), including denormals,
+/// infinities and NaN payloads (signaling NaNs are not quieted).
+/// `src` and `dst` need no particular alignment and must not overlap.
+void half_to_float_n(const uint16_t* src, float* dst, size_t count,
+                     HalfKernel kernel = HalfKernel::Auto);
+
+/// Whether `kernel` can run on this CPU (Auto and Scalar always can).
+bool half_kernel_supported(HalfKernel kernel);
+
+/// Name of the kernel that HalfKernel::Auto resolves to ("avx512"|"f16c"|"scalar").
+const char* half_kernel_name();
+
+}  // namespace genmesh
@@ -3,6 +3,7 @@
 #include <array>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "genmesh/exit_code.h"
@@ -69,4 +70,8 @@ struct ManifestResult {
 /// Returns ManifestResult with all validation errors collected (not just first).
 ManifestResult load_manifest(const std::string& path);
 
+/// Same as load_manifest() for manifest JSON already in memory (e.g. the
+/// copy embedded in bricks.pack). Parse errors are reported as E2002.
+ManifestResult parse_manifest(std::string_view text);
+
 }  // namespace genmesh
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace genmesh {
+
+/// Read-only memory mapping of an entire file.
+///
+/// Used by the mmap reader mode so that f32 brick payloads can be handed out
+/// as zero-copy views into bricks.bin. Instances are shared via shared_ptr;
+/// the mapping stays valid while any BrickData holds a reference to it.
+class MappedFile {
+public:
+    /// Access pattern hints (madvise on POSIX; no-op where unsupported).
+    enum class Advice {
+        Normal,
+        Sequential,
+        WillNeed,
+    };
+
+    /// Map `path` read-only. Returns nullptr and fills `error_msg` on failure.
+    static std::shared_ptr<MappedFile> open(const std::string& path,
+                                            std::string* error_msg = nullptr);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    int64_t size() const { return size_; }
+
+    /// Give the kernel an access-pattern hint for [offset, offset+length).
+    /// length < 0 means "to the end of the file".
+    void advise(Advice advice, int64_t offset = 0, int64_t length = -1) const;
+
+private:
+    MappedFile() = default;
+
+    const uint8_t* data_ = nullptr;
+    int64_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+}  // namespace genmesh
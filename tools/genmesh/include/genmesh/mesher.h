@@ -70,7 +70,11 @@ struct VdbWriteResult {
 };
 
 /// Write VDB grid to file using openvdb::io::File.
+///
+/// With `save_as_half`, voxel values are stored as 16-bit floats
+/// (Grid::setSaveFloatAsHalf; half the file size, read back as FloatGrid).
 VdbWriteResult write_vdb(const std::filesystem::path& path,
-                         const openvdb::FloatGrid::Ptr& grid);
+                         const openvdb::FloatGrid::Ptr& grid,
+                         bool save_as_half = false);
 
 }  // namespace genmesh
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace genmesh {
+
+/// Read-only file for positional reads (pread / ReadFile with an offset).
+///
+/// Used by the coalesced reader mode: reads carry their own offset, so any
+/// number of threads can read the same handle at once. Optionally opened
+/// for direct I/O (O_DIRECT, F_NOCACHE on macOS, FILE_FLAG_NO_BUFFERING on
+/// Windows) so that huge jobs do not evict the page cache of a shared host.
+class PositionalFile {
+public:
+    /// Offset, length and buffer alignment required by direct reads.
+    /// 4096 covers the logical block size of common disks and filesystems.
+    static constexpr size_t kDirectAlignment = 4096;
+
+    /// Open `path` read-only. With `direct`, falls back to a buffered handle
+    /// when the filesystem refuses direct I/O (see direct()). Returns nullptr
+    /// and fills `error_msg` on failure.
+    static std::unique_ptr<PositionalFile> open(const std::string& path, bool direct,
+                                                std::string* error_msg = nullptr);
+
+    ~PositionalFile();
+
+    PositionalFile(const PositionalFile&) = delete;
+    PositionalFile& operator=(const PositionalFile&) = delete;
+
+    int64_t size() const { return size_; }
+
+    /// Whether reads bypass the page cache. When true, read_at() needs
+    /// `dst`, `offset` and `length` aligned to kDirectAlignment.
+    bool direct() const { return direct_; }
+
+    /// Read up to `length` bytes at `offset`. Short only at end of file.
+    /// Returns the byte count, or -1 with `error_msg` filled on failure.
+    int64_t read_at(void* dst, size_t length, int64_t offset,
+                    std::string* error_msg = nullptr) const;
+
+private:
+    PositionalFile() = default;
+
+    int64_t size_ = 0;
+    bool direct_ = false;
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+}  // namespace genmesh
@@ -48,6 +48,42 @@ struct Stats {
     std::array<float, 3> mesh_aabb_min = {};
     std::array<float, 3> mesh_aabb_max = {};
     int64_t active_voxel_count = -1;  // negative = not available
+
+    // VDB tree size (optional)
+    bool has_grid = false;
+    int64_t grid_leaf_count = 0;
+    int64_t grid_uniform_tiles = 0;
+    int64_t grid_memory_bytes = 0;
+    int64_t grid_memory_saved_bytes = 0;
+
+    // --clip-bbox (optional)
+    bool has_clip = false;
+    std::array<float, 3> clip_min = {};
+    std::array<float, 3> clip_max = {};
+    int64_t clip_bricks_skipped = 0;  // index entries not read
+    int64_t clip_bytes_skipped = 0;   // stored payload bytes not read
+
+    // manifest offset_mm != 0 (optional)
+    bool has_offset = false;
+    float offset_mm = 0.0f;
+    std::string offset_method;      // "shift" | "sweep"
+    int64_t offset_dilated_voxels = 0;
+    double offset_ms = 0.0;
+
+    // --shell (optional)
+    bool has_shell = false;
+    float shell_thickness_mm = 0.0f;
+    std::string shell_method;  // how the inner surface was eroded: "shift" | "sweep"
+    int64_t shell_drain_holes = 0;
+    double shell_ms = 0.0;
+
+    // --infill inside the shell (optional)
+    bool has_infill = false;
+    std::string infill_surface;  // "gyroid" | "schwarz-p" | "diamond"
+    float infill_cell_mm = 0.0f;
+    float infill_wall_mm = 0.0f;
+    int64_t infill_leaves = 0;   // lattice leaves generated
+    double infill_ms = 0.0;
 };
 
 /// Input information recorded in the report.
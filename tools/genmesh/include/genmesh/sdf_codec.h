@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace genmesh {
+
+/// "sdfp" brick encoding: predictive codec for f32 distance fields.
+///
+/// Each voxel is predicted from its already-decoded neighbours with the 3D
+/// Lorenzo predictor (previous x, previous row, previous slice and their
+/// diagonals); a locally linear field is predicted exactly. Residuals are
+/// zigzag-mapped and Rice-coded with one parameter per x-row.
+///
+/// Two modes, chosen by the encoder:
+///   - lossless: prediction in float, residual taken between the
+///     order-preserving integer images of actual and predicted value;
+///     decodes bit-exactly.
+///   - bounded: values are quantized to a multiple of `step` (= 2 * bound)
+///     and predicted in the integer domain; |decoded - original| <= bound.
+///
+/// Stream layout (little-endian):
+///   u8  mode         0 = lossless, 1 = bounded
+///   u8  reserved     0
+///   u16 brick_size   B
+///   f32 step         quantization step in mm (0 for lossless)
+///   ... bitstream: for each (y, z) row, a 5-bit Rice parameter then B codes
+struct SdfpOptions {
+    /// Max absolute error in mm; 0 = lossless. See sdfp_error_bound().
+    float max_error_mm = 0.0f;
+};
+
+/// Error bound as a fraction of the voxel size, e.g. 1/64 voxel.
+/// Keeps the bound meaningful across presets (draft 2 mm, fine 0.5 mm).
+inline float sdfp_error_bound(float voxel_size, float fraction_of_voxel) {
+    return voxel_size * fraction_of_voxel;
+}
+
+/// Encode B^3 floats (x-fastest). Falls back to lossless if the bound is 0
+/// or the values cannot be quantized (non-finite, out of range).
+std::vector<uint8_t> sdfp_encode(const float* values, int brick_size,
+                                 const SdfpOptions& options = {});
+
+/// Decode into `voxels` floats at `dst`. Returns false with a short reason
+/// in *error_msg on a corrupt stream or a brick size other than cbrt(voxels).
+bool sdfp_decode(const uint8_t* src, size_t src_size, float* dst, size_t voxels,
+                 std::string* error_msg);
+
+}  // namespace genmesh
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+
+namespace genmesh {
+
+/// Triply periodic minimal surfaces usable as infill (--infill).
+enum class TpmsSurface {
+    Gyroid,    // sin x cos y + sin y cos z + sin z cos x
+    SchwarzP,  // cos x + cos y + cos z
+    Diamond,   // Schwarz D
+};
+
+/// "gyroid" | "schwarz-p" | "diamond" -> surface; false for anything else.
+bool parse_tpms_surface(std::string_view name, TpmsSurface& out);
+
+/// Name of `surface` as parse_tpms_surface() accepts it.
+const char* tpms_surface_name(TpmsSurface surface);
+
+/// Sheet TPMS: walls of `wall_mm` around the surface, repeating every
+/// `cell_mm` along each axis.
+struct TpmsParams {
+    TpmsSurface surface = TpmsSurface::Gyroid;
+    float cell_mm = 8.0f;
+    float wall_mm = 0.8f;
+};
+
+/// TPMS block evaluation kernels.
+enum class TpmsKernel {
+    Auto,    // best kernel supported by the running CPU
+    Scalar,  // portable, one voxel at a time
+    Avx2,    // AVX2, one 8-voxel z row per step
+};
+
+/// Side of the blocks tpms_block() evaluates: one VDB leaf node (8^3).
+inline constexpr int kTpmsBlockDim = 8;
+
+/// Approximate signed distance (mm, negative inside the walls) to the sheet
+/// TPMS at world point (x, y, z): |g| / |grad g| - wall_mm / 2, a first-order
+/// estimate that is exact at the surface and close within a few voxels.
+float tpms_distance(const TpmsParams& params, double x, double y, double z);
+
+/// tpms_distance() for the 8^3 voxels at `origin` + (i, j, k) * `voxel`
+/// (world mm), written to `out` (512 floats) in VDB leaf order:
+/// out[i * 64 + j * 8 + k], z fastest.
+///
+/// sin/cos are taken once per axis of the block, so each voxel costs a few
+/// multiply-adds and a square root. Every kernel gives bit-identical
+/// results, equal to tpms_distance() at the same points.
+void tpms_block(const TpmsParams& params, const std::array<double, 3>& origin, double voxel,
+                float* out, TpmsKernel kernel = TpmsKernel::Auto);
+
+/// Whether `kernel` can run on this CPU (Auto and Scalar always can).
+bool tpms_kernel_supported(TpmsKernel kernel);
+
+/// Name of the kernel that TpmsKernel::Auto resolves to ("avx2"|"scalar").
+const char* tpms_kernel_name();
+
+}  // namespace genmesh
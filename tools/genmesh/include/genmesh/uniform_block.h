@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+namespace genmesh {
+
+/// Side of the blocks uniform_block() scans: one VDB leaf node (8^3).
+inline constexpr int kUniformBlockDim = 8;
+
+/// Uniform-block scan kernels.
+enum class UniformKernel {
+    Auto,    // best kernel supported by the running CPU
+    Scalar,  // portable, stops at the first differing row
+    Avx2,    // AVX2, one 8-value row per compare, stops per 8x8 slice
+};
+
+/// Whether the 8^3 block at brick-local (ox, oy, oz) of a B^3 x-fastest
+/// brick holds a single value. `ox`, `oy`, `oz` are multiples of 8 and B is
+/// a multiple of 8.
+///
+/// Values are compared bit for bit: -0 and +0 differ, a NaN only matches the
+/// same NaN payload. On true, `value` receives the block's value; every
+/// kernel gives the same answer.
+bool uniform_block(const float* src, int B, int ox, int oy, int oz, float& value,
+                   UniformKernel kernel = UniformKernel::Auto);
+
+/// Whether `kernel` can run on this CPU (Auto and Scalar always can).
+bool uniform_kernel_supported(UniformKernel kernel);
+
+/// Name of the kernel that UniformKernel::Auto resolves to ("avx2"|"scalar").
+const char* uniform_kernel_name();
+
+}  // namespace genmesh
@@ -1,14 +1,18 @@
 #pragma once
 
+#include <array>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <openvdb/openvdb.h>
 
 #include "genmesh/bricks_data.h"
+#include "genmesh/bricks_index.h"
 #include "genmesh/exit_code.h"
 #include "genmesh/manifest.h"
+#include "genmesh/tpms.h"
 
 namespace genmesh {
 
@@ -20,6 +24,20 @@ struct VdbBuildResult {
     std::string error_code;
     std::string error_msg;
     int64_t active_voxel_count = 0;
+    int64_t brick_count = 0;   // bricks built into the grid (voxel and constant)
+    bool narrow_band = false;  // built as a narrow band (options.narrow_band and usable)
+
+    // Tree size
+    int64_t leaf_count = 0;
+    int64_t uniform_tiles = 0;       // uniform 8^3 blocks stored as tiles, not leaves
+    int64_t memory_bytes = 0;        // Tree::memUsage()
+    int64_t memory_saved_bytes = 0;  // leaf memory those tiles did not allocate
+};
+
+/// Options for build_vdb().
+struct VdbBuildOptions {
+    bool parallel = true;      // build voxel bricks on the TBB pool (build_vdb() only)
+    bool narrow_band = false;  // keep only voxels near the surface active (--narrow-band)
 };
 
 /// Initialize OpenVDB. Must be called once before any VDB operations.
@@ -36,10 +54,66 @@ openvdb::FloatGrid::Ptr create_grid(const Manifest& manifest);
 /// Build a VDB FloatGrid from brick data.
 ///
 /// 1. Creates grid via create_grid().
-/// 2. Iterates over bricks and sets voxel values.
+/// 2. Iterates over bricks and sets voxel values. Constant bricks are filled
+///    as tiles, active exactly when the same value written as voxels would
+///    be (dense: unless it equals the background, which is skipped).
 /// 3. Bricks not present in the data are left as background (sparse convention §5.5).
+/// f16 bricks (BrickData::is_half) are widened one brick at a time into a
+/// per-thread buffer, so the float copy of all bricks never exists.
+///
+/// Inside voxel bricks, every 8^3 block holding a single value (checked with
+/// uniform_block()) becomes a leaf-level tile instead of a leaf, under the
+/// same active rule as its voxels. Finally the tree is pruned, so runs
+/// of equal tiles collapse into internal-node tiles.
+///
+/// With `parallel`, voxel bricks are built on the TBB pool into per-thread
+/// trees that are merged at the end; the grid is identical to the serial one.
+/// (build_vdb() is a VdbStreamBuilder fed from `bricks`.)
+///
+/// With `narrow_band`, only voxels within half_width_voxels * voxel_size +
+/// |offset_mm| of iso + offset_mm are active (constant bricks too), and
+/// tools::signedFloodFill then sets every inactive voxel and tile to
+/// -/+background by side, so enclosed interiors, omitted bricks included,
+/// read as inside. That needs the band to straddle 0; otherwise W4001 is
+/// logged and the grid is built dense (result.narrow_band stays false).
 VdbBuildResult build_vdb(const Manifest& manifest,
-                         const std::vector<BrickData>& bricks);
+                         const std::vector<BrickData>& bricks,
+                         const VdbBuildOptions& options = {});
+
+/// build_vdb() for bricks that arrive one at a time (stream_bricks_bin(),
+/// debug_generate() with a sink). Each brick is inserted when it is added
+/// and not kept, so the bricks and the grid are never resident together:
+/// peak memory is the grid plus the bricks in flight.
+///
+/// add() may be called from several threads at once, e.g. straight from a
+/// BrickSink; each thread builds into its own tree as in build_vdb().
+/// finish() merges them and applies constant bricks, the narrow band flood
+/// fill and pruning, giving the grid build_vdb() builds from the same bricks
+/// in any order.
+class VdbStreamBuilder {
+public:
+    explicit VdbStreamBuilder(const Manifest& manifest, const VdbBuildOptions& options = {});
+    ~VdbStreamBuilder();
+
+    VdbStreamBuilder(const VdbStreamBuilder&) = delete;
+    VdbStreamBuilder& operator=(const VdbStreamBuilder&) = delete;
+
+    /// Insert one brick: voxel values are copied into leaves, constant
+    /// bricks are only recorded. Does nothing if grid creation failed.
+    void add(const BrickData& brick);
+
+    /// add() for a brick held elsewhere (arena slot, mapping); the values
+    /// are only read during the call.
+    void add(const BrickView& brick);
+
+    /// Finish the grid (or report the grid creation error). Call once,
+    /// after every add() has returned.
+    VdbBuildResult finish();
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
 
 /// Apply level set offset (dilation/erosion) to a VDB grid.
 ///
@@ -52,4 +126,79 @@ VdbBuildResult build_vdb(const Manifest& manifest,
 /// Returns false if the operation fails.
 bool apply_offset(openvdb::FloatGrid::Ptr& grid, float offset_mm);
 
+/// How offset_grid() moved the surface.
+enum class OffsetMethod {
+    None,   // offset_mm == 0
+    Shift,  // apply_offset() within the existing band
+    Sweep,  // band extended by fast sweeping, then shifted
+};
+
+/// "none" | "shift" | "sweep" (report.json stats.offset.method).
+const char* offset_method_name(OffsetMethod method);
+
+/// Result of offset_grid().
+struct OffsetResult {
+    bool ok = false;
+    OffsetMethod method = OffsetMethod::None;
+    int dilated_voxels = 0;  // band extension on the offset side (Sweep)
+    double ms = 0.0;         // wall time of the whole offset
+};
+
+/// Offset the level set by `offset_mm` (same sign convention as
+/// apply_offset()), valid beyond the narrow band of `band_mm`
+/// (half_width_voxels * voxel_size).
+///
+/// Values are only trustworthy within the band, and meshing the moved
+/// surface reads one voxel past it, so:
+/// - |offset_mm| + voxel_size <= band_mm: apply_offset() (Shift).
+/// - otherwise: the grid is first reduced to its band (values past it,
+///   e.g. dense interiors and inactive tiles, become -/+background), then
+///   tools::dilateSdf grows the band by fast sweeping on the side the
+///   surface moves into by |offset_mm|, the band is shifted and trimmed
+///   back to +/-band_mm around the moved surface (Sweep).
+OffsetResult offset_grid(openvdb::FloatGrid::Ptr& grid, float offset_mm, float band_mm);
+
+/// A drain hole: capsule of `radius_mm` around the segment from `from` to
+/// `to` (world mm).
+struct DrainHole {
+    std::array<float, 3> from = {};
+    std::array<float, 3> to = {};
+    float radius_mm = 0.0f;
+};
+
+/// Result of make_shell().
+struct ShellResult {
+    bool ok = false;
+    OffsetMethod erode_method = OffsetMethod::None;  // how the inner surface was found
+    int drain_holes = 0;                             // holes subtracted
+    int64_t infill_leaves = 0;                       // lattice leaves evaluated and kept
+    double infill_ms = 0.0;                          // lattice generation + clip
+    double ms = 0.0;                                 // wall time of the whole stage
+};
+
+/// Hollow the solid in `grid`, keeping a wall of `thickness_mm` (--shell).
+///
+/// The inner surface is a copy of the level set eroded by thickness_mm
+/// with offset_grid() (in parallel; the band is extended by fast sweeping
+/// when the wall is thicker than `band_mm`), and is CSG-subtracted from
+/// `grid`. Each drain hole is then built as a capsule level set on the
+/// grid's transform (tools::createLevelSetCapsule: threaded, band only) and
+/// subtracted as well, opening the cavity.
+///
+/// With `infill` (--infill), a sheet TPMS lattice is generated on the CPU
+/// in the leaves of the cavity only (tpms_block(), one call per leaf),
+/// intersected with the cavity and unioned back with the shell before the
+/// drain holes are cut, so the holes pass through the lattice too.
+ShellResult make_shell(openvdb::FloatGrid::Ptr& grid, float thickness_mm,
+                       const std::vector<DrainHole>& holes, float band_mm,
+                       const std::optional<TpmsParams>& infill = std::nullopt);
+
+/// Clip a grid to a world-space box (--clip-bbox).
+///
+/// Replaces `grid` with openvdb::tools::clip(): voxels outside `box` become
+/// background (outside), so the level set is capped at the box faces and
+/// the mesh of the region stays closed.
+/// Returns false if the operation fails.
+bool clip_grid(openvdb::FloatGrid::Ptr& grid, const WorldBox& box);
+
 }  // namespace genmesh
@@ -0,0 +1,102 @@
+#include "genmesh/brick_arena.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace genmesh {
+
+static constexpr size_t kHugePageBytes = size_t(2) << 20;
+
+static size_t round_up(size_t n, size_t to) {
+    return (n + to - 1) / to * to;
+}
+
+std::shared_ptr<BrickArena> BrickArena::create(size_t slot_bytes, size_t slots_per_slab,
+                                               bool huge_pages) {
+    std::shared_ptr<BrickArena> arena(new BrickArena());
+    arena->slot_bytes_ = slot_bytes;
+    arena->stride_ = round_up(slot_bytes > 0 ? slot_bytes : 1, kAlignment);
+    arena->slots_per_slab_ = slots_per_slab > 0 ? slots_per_slab : 1;
+    arena->want_huge_pages_ = huge_pages;
+    return arena;
+}
+
+BrickArena::~BrickArena() {
+    for (const auto& slab : slabs_) {
+        if (slab.page_aligned) {
+            std::free(slab.data);
+        } else {
+            ::operator delete(slab.data, std::align_val_t(kAlignment));
+        }
+    }
+}
+
+void BrickArena::add_slab() {
+    Slab slab{nullptr, stride_ * slots_per_slab_, false};
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (want_huge_pages_) {
+        const size_t bytes = round_up(slab.bytes, kHugePageBytes);
+        void* p = nullptr;
+        if (posix_memalign(&p, kHugePageBytes, bytes) == 0) {
+            slab = {p, bytes, true};
+            if (madvise(p, bytes, MADV_HUGEPAGE) == 0) huge_pages_ = true;
+        }
+    }
+#endif
+    if (!slab.data) {
+        slab.data = ::operator new(slab.bytes, std::align_val_t(kAlignment));
+    }
+    slabs_.push_back(slab);
+
+    // Pushed in reverse so slots are handed out in address order
+    auto* base = static_cast<unsigned char*>(slab.data);
+    for (size_t i = slots_per_slab_; i-- > 0;) {
+        free_.push_back(base + i * stride_);
+    }
+}
+
+std::shared_ptr<void> BrickArena::acquire() {
+    void* slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) add_slab();
+        slot = free_.back();
+        free_.pop_back();
+        ++in_use_;
+    }
+    return std::shared_ptr<void>(slot, [self = shared_from_this()](void* p) { self->release(p); });
+}
+
+void BrickArena::release(void* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(slot);
+    --in_use_;
+}
+
+size_t BrickArena::slab_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slabs_.size();
+}
+
+size_t BrickArena::slab_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = 0;
+    for (const auto& slab : slabs_) bytes += slab.bytes;
+    return bytes;
+}
+
+size_t BrickArena::slots_in_use() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_use_;
+}
+
+bool BrickArena::huge_pages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return huge_pages_;
+}
+
+}  // namespace genmesh
@@ -0,0 +1,181 @@
+#include "genmesh/brick_codec.h"
+#include "genmesh/sdf_codec.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#include <lz4.h>
+#include <zstd.h>
+
+namespace genmesh {
+
+bool is_known_encoding(std::string_view encoding) {
+    return encoding == "raw" || encoding == "zstd" || encoding == "lz4" || encoding == "sdfp" ||
+           is_band_quantized_encoding(encoding) || is_constant_encoding(encoding);
+}
+
+// ---------- decode ----------
+
+static bool decode_zstd(const uint8_t* src, size_t src_size,
+                        uint8_t* dst, size_t dst_size, std::string* error_msg) {
+    // One context per thread: decode runs on the TBB pool.
+    thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> dctx(ZSTD_createDCtx(),
+                                                                         ZSTD_freeDCtx);
+    if (!dctx) {
+        if (error_msg) *error_msg = "ZSTD_createDCtx failed";
+        return false;
+    }
+
+    const size_t n = ZSTD_decompressDCtx(dctx.get(), dst, dst_size, src, src_size);
+    if (ZSTD_isError(n)) {
+        if (error_msg) *error_msg = ZSTD_getErrorName(n);
+        return false;
+    }
+    if (n != dst_size) {
+        if (error_msg) {
+            *error_msg = "decoded " + std::to_string(n) + " bytes, expected " +
+                         std::to_string(dst_size);
+        }
+        return false;
+    }
+    return true;
+}
+
+static bool decode_lz4(const uint8_t* src, size_t src_size,
+                       uint8_t* dst, size_t dst_size, std::string* error_msg) {
+    constexpr size_t kMax = static_cast<size_t>(std::numeric_limits<int>::max());
+    if (src_size > kMax || dst_size > kMax) {
+        if (error_msg) *error_msg = "payload too large for an LZ4 block";
+        return false;
+    }
+
+    const int n = LZ4_decompress_safe(reinterpret_cast<const char*>(src),
+                                      reinterpret_cast<char*>(dst),
+                                      static_cast<int>(src_size), static_cast<int>(dst_size));
+    if (n < 0) {
+        if (error_msg) *error_msg = "malformed LZ4 block";
+        return false;
+    }
+    if (static_cast<size_t>(n) != dst_size) {
+        if (error_msg) {
+            *error_msg = "decoded " + std::to_string(n) + " bytes, expected " +
+                         std::to_string(dst_size);
+        }
+        return false;
+    }
+    return true;
+}
+
+bool decode_brick_payload(std::string_view encoding,
+                          const uint8_t* src, size_t src_size,
+                          uint8_t* dst, size_t dst_size,
+                          std::string* error_msg) {
+    if (encoding == "raw") {
+        if (src_size != dst_size) {
+            if (error_msg) *error_msg = "raw payload size mismatch";
+            return false;
+        }
+        std::memcpy(dst, src, dst_size);
+        return true;
+    }
+    if (encoding == "zstd") return decode_zstd(src, src_size, dst, dst_size, error_msg);
+    if (encoding == "lz4") return decode_lz4(src, src_size, dst, dst_size, error_msg);
+    if (encoding == "sdfp") {
+        if (dst_size % sizeof(float) != 0 ||
+            reinterpret_cast<uintptr_t>(dst) % alignof(float) != 0) {
+            if (error_msg) *error_msg = "destination is not a float array";
+            return false;
+        }
+        return sdfp_decode(src, src_size, reinterpret_cast<float*>(dst),
+                           dst_size / sizeof(float), error_msg);
+    }
+
+    if (error_msg) *error_msg = "unknown encoding: " + std::string(encoding);
+    return false;
+}
+
+// ---------- band quantization ----------
+
+// Branch-free select form so the loop vectorizes.
+template <typename Q>
+static void dequantize_n(const uint8_t* src, size_t n, float band_mm, float saturation_mm,
+                         float* dst) {
+    constexpr int32_t kMax = std::numeric_limits<Q>::max();
+    const float scale = band_mm / static_cast<float>(kMax);
+    for (size_t i = 0; i < n; ++i) {
+        Q q;
+        std::memcpy(&q, src + i * sizeof(Q), sizeof(Q));
+        const int32_t v = q;
+        float d = static_cast<float>(v) * scale;
+        d = v >= kMax ? saturation_mm : d;
+        d = v <= -kMax ? -saturation_mm : d;
+        dst[i] = d;
+    }
+}
+
+template <typename Q>
+static std::vector<uint8_t> quantize_n(const float* src, size_t n, float band_mm) {
+    constexpr float kMax = static_cast<float>(std::numeric_limits<Q>::max());
+    const float inv_scale = kMax / band_mm;
+    std::vector<uint8_t> out(n * sizeof(Q));
+    for (size_t i = 0; i < n; ++i) {
+        const float d = src[i];
+        float q = std::nearbyint(d * inv_scale);
+        if (!(std::fabs(q) < kMax)) q = std::signbit(d) ? -kMax : kMax;  // out of band / NaN
+        const Q v = static_cast<Q>(q);
+        std::memcpy(out.data() + i * sizeof(Q), &v, sizeof(Q));
+    }
+    return out;
+}
+
+void band_dequantize(std::string_view encoding, const uint8_t* src, size_t n,
+                     float band_mm, float saturation_mm, float* dst) {
+    if (encoding == "q8") {
+        dequantize_n<int8_t>(src, n, band_mm, saturation_mm, dst);
+    } else {
+        dequantize_n<int16_t>(src, n, band_mm, saturation_mm, dst);
+    }
+}
+
+std::vector<uint8_t> band_quantize(std::string_view encoding, const float* src, size_t n,
+                                   float band_mm) {
+    return encoding == "q8" ? quantize_n<int8_t>(src, n, band_mm)
+                            : quantize_n<int16_t>(src, n, band_mm);
+}
+
+// ---------- encode ----------
+
+std::vector<uint8_t> encode_brick_payload(std::string_view encoding,
+                                          const uint8_t* src, size_t src_size,
+                                          int level) {
+    std::vector<uint8_t> out;
+
+    if (encoding == "zstd") {
+        out.resize(ZSTD_compressBound(src_size));
+        const size_t n = ZSTD_compress(out.data(), out.size(), src, src_size,
+                                       level != 0 ? level : ZSTD_CLEVEL_DEFAULT);
+        out.resize(ZSTD_isError(n) ? 0 : n);
+    } else if (encoding == "lz4") {
+        out.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(src_size))));
+        const int n = LZ4_compress_fast(reinterpret_cast<const char*>(src),
+                                        reinterpret_cast<char*>(out.data()),
+                                        static_cast<int>(src_size), static_cast<int>(out.size()),
+                                        level > 0 ? level : 1);
+        out.resize(n > 0 ? static_cast<size_t>(n) : 0);
+    } else if (encoding == "sdfp") {
+        const size_t voxels = src_size / sizeof(float);
+        const int B = static_cast<int>(std::lround(std::cbrt(static_cast<double>(voxels))));
+        if (static_cast<size_t>(B) * B * B == voxels && voxels * sizeof(float) == src_size) {
+            std::vector<float> values(voxels);
+            std::memcpy(values.data(), src, src_size);
+            out = sdfp_encode(values.data(), B);
+        }
+    } else if (!is_band_quantized_encoding(encoding)) {
+        out.assign(src, src + src_size);
+    }
+    return out;
+}
+
+}  // namespace genmesh
@@ -1,11 +1,25 @@
 #include "genmesh/bricks_data.h"
+#include "genmesh/brick_arena.h"
+#include "genmesh/brick_codec.h"
+#include "genmesh/crc32.h"
 #include "genmesh/error_code.h"
+#include "genmesh/half.h"
 #include "genmesh/log.h"
+#include "genmesh/mapped_file.h"
+#include "genmesh/positional_file.h"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
+#include <new>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace genmesh {
@@ -18,159 +32,886 @@ static void add_error(BricksDataResult& r, std::string_view code,
     log_error(code, msg, field.empty() ? std::vector<KV>{} : std::vector<KV>{{"field", field}});
 }
 
-/// Software f16 → f32 conversion (IEEE 754 binary16).
-static float half_to_float(uint16_t h) {
-    uint32_t sign = (h >> 15) & 0x1;
-    uint32_t exp  = (h >> 10) & 0x1F;
-    uint32_t mant = h & 0x3FF;
+static std::string to_hex8(uint32_t val) {
+    char buf[9];
+    snprintf(buf, sizeof(buf), "%08x", val);
+    return std::string(buf);
+}
+
+// ---------- per-brick decode ----------
+
+/// Outcome of one index entry. Slots are filled independently (possibly in
+/// parallel) and merged in index order, so errors and brick order are the
+/// same as a serial read.
+struct BrickSlot {
+    BrickData brick;
+    bool ok = false;
+    bool has_range = false;  // lo/hi of the decoded values (NaN skipped)
+    float lo = 0.0f;
+    float hi = 0.0f;
+    std::vector<ValidationError> errors;
+};
+
+/// Read-only state shared by all decode tasks.
+struct DecodeContext {
+    const BricksIndex* index = nullptr;
+    int64_t file_size = 0;
+    int64_t voxels_per_brick = 0;
+    bool is_f16 = false;
+    bool keep_half = false;      // is_f16 and options.keep_half
+    bool verify_crc = true;
+    float band_mm = 0.0f;        // q8/q16 full scale: half_width_voxels * voxel_size
+    float saturation_mm = 0.0f;  // q8/q16 out-of-band value: background_value_mm
+    bool check_summary = false;  // some entry has min/max/crosses_iso
+    float summary_iso = 0.0f;    // level crosses_iso refers to
+    std::shared_ptr<MappedFile> file;      // ReadMode::Mmap
+    std::unique_ptr<PositionalFile> pfile;  // ReadMode::Coalesced
+    std::shared_ptr<BrickArena> arena;       // options.arena: owned floats go into slots
+    std::shared_ptr<BrickArena> half_arena;  // options.arena + keep_half: binary16 slots
+    std::string bin_path;                  // ReadMode::Stream
+    const BrickSink* sink = nullptr;       // stream_bricks_bin(): hand bricks off when decoded
+    std::vector<std::vector<size_t>> sharers;  // sink: entries decoded with each payload
+};
+
+/// Task-local state: own file handle + staging buffers (stored bytes of
+/// f16/compressed/quantized bricks, decompressed f16 payloads).
+struct StreamState {
+    std::ifstream ifs;
+    std::vector<uint8_t> raw;
+    std::vector<uint8_t> unpacked;
+};
+
+static void slot_error(BrickSlot& slot, std::string_view code, const std::string& msg) {
+    slot.errors.push_back({std::string(code), msg, "bricks.bin"});
+}
+
+/// Verify entry.crc32 (if present) against the raw payload.
+static bool check_crc(const BrickEntry& entry, const uint8_t* raw,
+                      const std::string& prefix, BrickSlot& slot) {
+    if (!entry.crc32.has_value()) return true;
 
-    uint32_t f;
-    if (exp == 0) {
-        if (mant == 0) {
-            // zero
-            f = sign << 31;
+    uint32_t expected = 0;
+    if (!parse_crc32_hex(entry.crc32.value(), expected)) {
+        // validate_bricks_index() rejects these; an index built by hand may not
+        slot_error(slot, E1106, prefix + " invalid crc32: " + entry.crc32.value());
+        return false;
+    }
+    uint32_t computed = crc32(raw, static_cast<size_t>(entry.payload_bytes));
+    if (computed != expected) {
+        slot_error(slot, E1106,
+                   prefix + " CRC32 mismatch: computed=" + to_hex8(computed) +
+                   " expected=" + entry.crc32.value());
+        return false;
+    }
+    return true;
+}
+
+/// Owned storage for `n` floats of `bd`: an arena slot behind bd.view when
+/// the reader has an arena, bd.values otherwise.
+static float* own_floats(const DecodeContext& ctx, BrickData& bd, size_t n) {
+    if (ctx.arena && n * sizeof(float) <= ctx.arena->slot_bytes()) {
+        auto slot = ctx.arena->acquire();
+        auto* p = static_cast<float*>(slot.get());
+        bd.view = p;
+        bd.view_size = n;
+        bd.keepalive = std::move(slot);
+        return p;
+    }
+    bd.values.resize(n);
+    return bd.values.data();
+}
+
+/// own_floats() for binary16 storage (bd.half_view / bd.half_values).
+static uint16_t* own_halves(const DecodeContext& ctx, BrickData& bd, size_t n) {
+    if (ctx.half_arena && n * sizeof(uint16_t) <= ctx.half_arena->slot_bytes()) {
+        auto slot = ctx.half_arena->acquire();
+        auto* p = static_cast<uint16_t*>(slot.get());
+        bd.half_view = p;
+        bd.view_size = n;
+        bd.keepalive = std::move(slot);
+        return p;
+    }
+    bd.half_values.resize(n);
+    return bd.half_values.data();
+}
+
+/// Decode a raw payload into owned float storage.
+static void decode_payload(const DecodeContext& ctx, const uint8_t* raw, int64_t voxels,
+                           bool is_f16, BrickData& bd) {
+    float* out = own_floats(ctx, bd, static_cast<size_t>(voxels));
+
+    if (is_f16) {
+        // SIMD kernel picked at runtime (see half.h). An odd payload offset is
+        // copied out first so the kernel only ever sees uint16-aligned input.
+        const size_t n = static_cast<size_t>(voxels);
+        if (reinterpret_cast<uintptr_t>(raw) % alignof(uint16_t) == 0) {
+            half_to_float_n(reinterpret_cast<const uint16_t*>(raw), out, n);
         } else {
-            // denormalized → normalized
-            exp = 1;
-            while (!(mant & 0x400)) {
-                mant <<= 1;
-                exp--;
-            }
-            mant &= 0x3FF;
-            f = (sign << 31) | ((exp + 127 - 15) << 23) | (mant << 13);
+            std::vector<uint16_t> tmp(n);
+            std::memcpy(tmp.data(), raw, n * sizeof(uint16_t));
+            half_to_float_n(tmp.data(), out, n);
         }
-    } else if (exp == 31) {
-        // inf or NaN
-        f = (sign << 31) | 0x7F800000 | (mant << 13);
     } else {
-        // normalized
-        f = (sign << 31) | ((exp + 127 - 15) << 23) | (mant << 13);
+        // f32: direct memcpy (little-endian assumed)
+        std::memcpy(out, raw, static_cast<size_t>(voxels) * sizeof(float));
+    }
+}
+
+/// Keep a raw f16 payload as binary16 (keep_half). The copy also takes care
+/// of odd payload offsets.
+static void store_half(const DecodeContext& ctx, const uint8_t* raw, int64_t voxels,
+                       BrickData& bd) {
+    uint16_t* out = own_halves(ctx, bd, static_cast<size_t>(voxels));
+    std::memcpy(out, raw, static_cast<size_t>(voxels) * sizeof(uint16_t));
+}
+
+const float* brick_floats(const BrickData& bd, std::vector<float>& scratch) {
+    if (bd.constant) return nullptr;
+    if (!bd.is_half()) return bd.data();
+    scratch.resize(bd.size());
+    half_to_float_n(bd.half_data(), scratch.data(), scratch.size());
+    return scratch.data();
+}
+
+BrickView brick_view(const BrickData& bd, std::vector<float>& scratch) {
+    BrickView v;
+    v.bx = bd.bx;
+    v.by = bd.by;
+    v.bz = bd.bz;
+    v.constant = bd.constant;
+    if (!bd.constant) {
+        v.values = brick_floats(bd, scratch);
+        v.size = bd.size();
     }
+    return v;
+}
 
-    float result;
-    std::memcpy(&result, &f, sizeof(float));
-    return result;
+/// Compare the min/max/crosses_iso summary of `entry` with the value range
+/// of the decoded payload (spec §5.4).
+static void check_summary(const DecodeContext& ctx, const BrickEntry& entry,
+                          const std::string& prefix, BrickSlot& slot, const BrickSlot& decoded) {
+    if (!decoded.has_range) return;  // all NaN: nothing to compare
+    if (entry.min && entry.max && (decoded.lo < *entry.min || decoded.hi > *entry.max)) {
+        slot_error(slot, E1108,
+                   prefix + " values [" + std::to_string(decoded.lo) + ", " +
+                   std::to_string(decoded.hi) + "] outside summary [" +
+                   std::to_string(*entry.min) + ", " + std::to_string(*entry.max) + "]");
+        slot.ok = false;
+        return;
+    }
+    if (entry.crosses_iso) {
+        const bool crosses = decoded.lo <= ctx.summary_iso && decoded.hi >= ctx.summary_iso;
+        if (crosses != *entry.crosses_iso) {
+            slot_error(slot, E1108,
+                       prefix + " crosses_iso=" + (*entry.crosses_iso ? "true" : "false") +
+                       " but values [" + std::to_string(decoded.lo) + ", " +
+                       std::to_string(decoded.hi) + "] " + (crosses ? "cross" : "do not cross") +
+                       " iso " + std::to_string(ctx.summary_iso));
+            slot.ok = false;
+        }
+    }
+}
+
+/// Fill slot.lo / slot.hi from the decoded brick.
+static void measure_range(BrickSlot& slot) {
+    const BrickData& bd = slot.brick;
+    if (bd.constant) {
+        slot.has_range = !std::isnan(*bd.constant);
+        slot.lo = slot.hi = *bd.constant;
+        return;
+    }
+    std::vector<float> scratch;
+    const float* v = brick_floats(bd, scratch);
+    float lo = INFINITY, hi = -INFINITY;
+    for (size_t i = 0, n = bd.size(); i < n; ++i) {
+        lo = std::min(lo, v[i]);  // NaN compares false and is skipped
+        hi = std::max(hi, v[i]);
+    }
+    slot.has_range = lo <= hi;
+    slot.lo = lo;
+    slot.hi = hi;
 }
 
-/// CRC32 (ISO 3309 / zlib compatible) for verification.
-static uint32_t crc32_calc(const uint8_t* data, size_t len) {
-    // Standard CRC32 table-based implementation
-    static uint32_t table[256] = {0};
-    static bool table_init = false;
-    if (!table_init) {
-        for (uint32_t i = 0; i < 256; ++i) {
-            uint32_t crc = i;
-            for (int j = 0; j < 8; ++j) {
-                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+/// Range check + read + CRC32 + convert for bricks[bi]. `staged` is the
+/// payload when the coalesced reader has already read it.
+static void read_brick(const DecodeContext& ctx, size_t bi, StreamState* stream,
+                       BrickSlot& slot, const uint8_t* staged) {
+    const auto& entry = ctx.index->bricks[bi];
+    const std::string prefix = "bricks[" + std::to_string(bi) + "]";
+
+    // --- constant: value comes from the index, nothing to read ---
+    if (is_constant_encoding(entry.encoding)) {
+        slot.brick.bx = entry.bx;
+        slot.brick.by = entry.by;
+        slot.brick.bz = entry.bz;
+        slot.brick.constant = entry.value.value_or(0.0f);
+        slot.ok = true;
+        return;
+    }
+
+    // --- range check (§5.6) ---
+    if (entry.offset_bytes + entry.payload_bytes > ctx.file_size) {
+        slot_error(slot, E1105,
+                   prefix + " offset_bytes(" + std::to_string(entry.offset_bytes) +
+                   ") + payload_bytes(" + std::to_string(entry.payload_bytes) +
+                   ") exceeds file size(" + std::to_string(ctx.file_size) + ")");
+        return;
+    }
+
+    BrickData& bd = slot.brick;
+    bd.bx = entry.bx;
+    bd.by = entry.by;
+    bd.bz = entry.bz;
+
+    // Locate the stored payload: in the mapping, or read from the task's stream.
+    // Uncompressed f32 payloads are streamed straight into BrickData::values.
+    const bool quantized = is_band_quantized_encoding(entry.encoding);
+    const bool packed = !is_raw_encoding(entry.encoding) && !quantized;
+    const uint8_t* raw = nullptr;
+    if (staged) {
+        raw = staged;
+    } else if (ctx.file) {
+        raw = ctx.file->data() + entry.offset_bytes;
+    } else {
+        uint8_t* dst;
+        if (ctx.keep_half && !packed && !quantized) {
+            dst = reinterpret_cast<uint8_t*>(
+                own_halves(ctx, bd, static_cast<size_t>(entry.payload_bytes / sizeof(uint16_t))));
+        } else if (ctx.is_f16 || packed || quantized) {
+            stream->raw.resize(static_cast<size_t>(entry.payload_bytes));
+            dst = stream->raw.data();
+        } else {
+            dst = reinterpret_cast<uint8_t*>(
+                own_floats(ctx, bd, static_cast<size_t>(entry.payload_bytes / sizeof(float))));
+        }
+
+        stream->ifs.seekg(entry.offset_bytes, std::ios::beg);
+        stream->ifs.read(reinterpret_cast<char*>(dst), entry.payload_bytes);
+        if (!stream->ifs) {
+            slot_error(slot, E2001,
+                       prefix + " read failed at offset " + std::to_string(entry.offset_bytes));
+            stream->ifs.clear();
+            return;
+        }
+        raw = dst;
+    }
+
+    // --- CRC32 check (§5.6, optional; may be deferred to verify_bricks_crc) ---
+    if (ctx.verify_crc && !check_crc(entry, raw, prefix, slot)) {
+        return;
+    }
+
+    // --- Expand q8 / q16 fixed point straight into floats ---
+    if (quantized) {
+        const size_t n = static_cast<size_t>(ctx.voxels_per_brick);
+        band_dequantize(entry.encoding, raw, n, ctx.band_mm, ctx.saturation_mm,
+                        own_floats(ctx, bd, n));
+        slot.ok = true;
+        return;
+    }
+
+    // --- Decompress (zstd / lz4 / sdfp): each brick is an independent stream ---
+    if (packed) {
+        const size_t elem = ctx.is_f16 ? sizeof(uint16_t) : sizeof(float);
+        const size_t unpacked_bytes = static_cast<size_t>(ctx.voxels_per_brick) * elem;
+
+        uint8_t* dst;
+        if (ctx.keep_half) {
+            dst = reinterpret_cast<uint8_t*>(
+                own_halves(ctx, bd, static_cast<size_t>(ctx.voxels_per_brick)));
+        } else if (ctx.is_f16) {
+            stream->unpacked.resize(unpacked_bytes);
+            dst = stream->unpacked.data();
+        } else {
+            dst = reinterpret_cast<uint8_t*>(
+                own_floats(ctx, bd, static_cast<size_t>(ctx.voxels_per_brick)));
+        }
+
+        std::string why;
+        if (!decode_brick_payload(entry.encoding, raw, static_cast<size_t>(entry.payload_bytes),
+                                  dst, unpacked_bytes, &why)) {
+            slot_error(slot, E1107, prefix + " " + entry.encoding + " decode failed: " + why);
+            return;
+        }
+        if (ctx.is_f16 && !ctx.keep_half) {
+            decode_payload(ctx, dst, ctx.voxels_per_brick, true, bd);
+        }
+        slot.ok = true;
+        return;
+    }
+
+    // --- Keep f16 as is: a view into the mapping, or an owned copy ---
+    if (ctx.keep_half) {
+        if (ctx.file && entry.offset_bytes % static_cast<int64_t>(alignof(uint16_t)) == 0) {
+            bd.half_view = reinterpret_cast<const uint16_t*>(raw);
+            bd.view_size = static_cast<size_t>(ctx.voxels_per_brick);
+            bd.keepalive = ctx.file;
+        } else if (ctx.file || staged) {
+            store_half(ctx, raw, ctx.voxels_per_brick, bd);
+        }
+        // Stream: already read into half_values
+        slot.ok = true;
+        return;
+    }
+
+    // --- Convert to float array ---
+    if (ctx.file) {
+        // f32 payloads at a float-aligned offset are used in place; everything
+        // else (f16, or an odd offset) falls back to an owned buffer.
+        if (!ctx.is_f16 && entry.offset_bytes % static_cast<int64_t>(alignof(float)) == 0) {
+            bd.view = reinterpret_cast<const float*>(raw);
+            bd.view_size = static_cast<size_t>(ctx.voxels_per_brick);
+            bd.keepalive = ctx.file;
+        } else {
+            decode_payload(ctx, raw, ctx.voxels_per_brick, ctx.is_f16, bd);
+        }
+    } else if (staged || ctx.is_f16) {
+        decode_payload(ctx, raw, ctx.voxels_per_brick, ctx.is_f16, bd);
+    }
+
+    slot.ok = true;
+}
+
+/// read_brick() plus the summary check.
+static void decode_brick(const DecodeContext& ctx, size_t bi, StreamState* stream,
+                         BrickSlot& slot, const uint8_t* staged = nullptr) {
+    read_brick(ctx, bi, stream, slot, staged);
+    if (!slot.ok || !ctx.check_summary) return;
+    measure_range(slot);
+    check_summary(ctx, ctx.index->bricks[bi], "bricks[" + std::to_string(bi) + "]", slot, slot);
+}
+
+/// Move owned values behind a shared buffer so copies of `bd` alias them.
+static void share_values(BrickData& bd) {
+    if (bd.view || bd.half_view || bd.constant) return;
+    if (bd.is_half()) {
+        auto shared = std::make_shared<std::vector<uint16_t>>(std::move(bd.half_values));
+        bd.half_values = {};
+        bd.half_view = shared->data();
+        bd.view_size = shared->size();
+        bd.keepalive = std::move(shared);
+        return;
+    }
+    auto shared = std::make_shared<std::vector<float>>(std::move(bd.values));
+    bd.values = {};
+    bd.view = shared->data();
+    bd.view_size = shared->size();
+    bd.keepalive = std::move(shared);
+}
+
+/// stream_bricks_bin(): hand slots[bi], then the entries sharing its payload,
+/// to the sink and release the values. The slots keep status and errors only.
+static void emit_brick(const DecodeContext& ctx, size_t bi, std::vector<BrickSlot>& slots) {
+    BrickSlot& src = slots[bi];
+    if (!src.ok) return;  // a failed payload reports once
+    const auto& sharers = ctx.sharers[bi];
+    if (!sharers.empty()) share_values(src.brick);
+
+    for (size_t si : sharers) {
+        BrickSlot& slot = slots[si];
+        slot.ok = true;
+        if (ctx.check_summary) {
+            check_summary(ctx, ctx.index->bricks[si], "bricks[" + std::to_string(si) + "]",
+                          slot, src);
+        }
+        if (!slot.ok) continue;
+        BrickData bd = src.brick;
+        bd.bx = ctx.index->bricks[si].bx;
+        bd.by = ctx.index->bricks[si].by;
+        bd.bz = ctx.index->bricks[si].bz;
+        (*ctx.sink)(bd);
+    }
+    (*ctx.sink)(src.brick);
+    src.brick = BrickData{};
+}
+
+/// decode_brick(), then the hand-off when streaming.
+static void finish_brick(const DecodeContext& ctx, size_t bi, StreamState* stream,
+                         std::vector<BrickSlot>& slots, const uint8_t* staged = nullptr) {
+    decode_brick(ctx, bi, stream, slots[bi], staged);
+    if (ctx.sink) emit_brick(ctx, bi, slots);
+}
+
+/// Decode bricks[order[begin, end)] with one task-local stream / prefetch cursor.
+static void decode_range(const DecodeContext& ctx, const std::vector<size_t>& order,
+                         size_t begin, size_t end, std::vector<BrickSlot>& slots) {
+    StreamState stream;
+    if (!ctx.file) {
+        stream.ifs.open(ctx.bin_path, std::ios::binary);
+        if (!stream.ifs.is_open()) {
+            for (size_t i = begin; i < end; ++i) {
+                slot_error(slots[order[i]], E2001, "Cannot open bricks.bin: " + ctx.bin_path);
             }
-            table[i] = crc;
+            return;
         }
-        table_init = true;
     }
 
-    uint32_t crc = 0xFFFFFFFF;
-    for (size_t i = 0; i < len; ++i) {
-        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    for (size_t i = begin; i < end; ++i) {
+        const size_t bi = order[i];
+        // Prefetch the next payload while this one is verified / decoded.
+        if (ctx.file && i + 1 < end) {
+            const auto& next = ctx.index->bricks[order[i + 1]];
+            if (next.offset_bytes + next.payload_bytes <= ctx.file_size) {
+                ctx.file->advise(MappedFile::Advice::WillNeed,
+                                 next.offset_bytes, next.payload_bytes);
+            }
+        }
+        finish_brick(ctx, bi, &stream, slots);
     }
-    return crc ^ 0xFFFFFFFF;
 }
 
-static std::string to_hex8(uint32_t val) {
-    char buf[9];
-    snprintf(buf, sizeof(buf), "%08x", val);
-    return std::string(buf);
+// ---------- coalesced reads ----------
+
+/// One positional read covering sorted[first, last).
+struct ReadRun {
+    int64_t begin = 0;  // file range to read (block-aligned for direct I/O)
+    int64_t end = 0;
+    size_t first = 0;
+    size_t last = 0;
+};
+
+// Holes up to kMaxRunGap are read and discarded rather than split into
+// another request; kMaxRunBytes bounds the staging buffer of each task.
+constexpr int64_t kMaxRunGap = 64 * 1024;
+constexpr int64_t kMaxRunBytes = 16 * 1024 * 1024;
+
+/// Merge offset-sorted payloads into runs. `align` > 1 widens each run to
+/// whole blocks (direct I/O).
+static std::vector<ReadRun> plan_runs(const BricksIndex& index, const std::vector<size_t>& sorted,
+                                      int64_t align) {
+    std::vector<ReadRun> runs;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const auto& e = index.bricks[sorted[i]];
+        const int64_t b = e.offset_bytes;
+        const int64_t en = e.offset_bytes + e.payload_bytes;
+        if (!runs.empty()) {
+            ReadRun& r = runs.back();
+            const int64_t merged_end = std::max(r.end, en);
+            if (b <= r.end + kMaxRunGap && merged_end - r.begin <= kMaxRunBytes) {
+                r.end = merged_end;
+                r.last = i + 1;
+                continue;
+            }
+        }
+        runs.push_back({b, en, i, i + 1});
+    }
+
+    if (align > 1) {
+        for (auto& r : runs) {
+            r.begin -= r.begin % align;
+            r.end = (r.end + align - 1) / align * align;  // may pass EOF: the read comes back short
+        }
+    }
+    return runs;
 }
 
-static uint32_t hex_to_u32(const std::string& hex) {
-    return static_cast<uint32_t>(std::stoul(hex, nullptr, 16));
+/// Staging buffer for one task, aligned for direct I/O and reused across runs.
+class RunBuffer {
+public:
+    uint8_t* reserve(size_t bytes) {
+        if (bytes > capacity_) {
+            data_.reset(static_cast<uint8_t*>(
+                ::operator new(bytes, std::align_val_t(PositionalFile::kDirectAlignment))));
+            capacity_ = bytes;
+        }
+        return data_.get();
+    }
+
+private:
+    struct Free {
+        void operator()(uint8_t* p) const {
+            ::operator delete(p, std::align_val_t(PositionalFile::kDirectAlignment));
+        }
+    };
+    std::unique_ptr<uint8_t, Free> data_;
+    size_t capacity_ = 0;
+};
+
+/// Read runs[begin, end) and decode their payloads from the staging buffer.
+static void read_runs(const DecodeContext& ctx, const std::vector<ReadRun>& runs,
+                      const std::vector<size_t>& sorted, size_t begin, size_t end,
+                      std::vector<BrickSlot>& slots) {
+    RunBuffer buffer;
+    StreamState stream;  // staging for f16 decompression only; no handle
+
+    for (size_t ri = begin; ri < end; ++ri) {
+        const ReadRun& run = runs[ri];
+        uint8_t* data = buffer.reserve(static_cast<size_t>(run.end - run.begin));
+        std::string why;
+        const int64_t got = ctx.pfile->read_at(data, static_cast<size_t>(run.end - run.begin),
+                                               run.begin, &why);
+
+        for (size_t i = run.first; i < run.last; ++i) {
+            const size_t bi = sorted[i];
+            const auto& entry = ctx.index->bricks[bi];
+            if (got < entry.offset_bytes + entry.payload_bytes - run.begin) {
+                slot_error(slots[bi], E2001,
+                           "bricks[" + std::to_string(bi) + "] read failed at offset " +
+                           std::to_string(entry.offset_bytes) + (why.empty() ? "" : " (" + why + ")"));
+                continue;
+            }
+            finish_brick(ctx, bi, &stream, slots, data + (entry.offset_bytes - run.begin));
+        }
+    }
+}
+
+/// ReadMode::Coalesced: sort by offset, merge neighbours into runs, and keep
+/// one positional read in flight per worker while other workers decode.
+static void load_coalesced(const DecodeContext& ctx, const std::vector<size_t>& unique,
+                           bool parallel, std::vector<BrickSlot>& slots) {
+    // Constant and out-of-range entries need no I/O; decode_brick() settles them.
+    std::vector<size_t> sorted;
+    sorted.reserve(unique.size());
+    for (size_t bi : unique) {
+        const auto& e = ctx.index->bricks[bi];
+        if (is_constant_encoding(e.encoding) || e.offset_bytes + e.payload_bytes > ctx.file_size) {
+            finish_brick(ctx, bi, nullptr, slots);
+        } else {
+            sorted.push_back(bi);
+        }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+        return ctx.index->bricks[a].offset_bytes < ctx.index->bricks[b].offset_bytes;
+    });
+
+    const int64_t align =
+        ctx.pfile->direct() ? static_cast<int64_t>(PositionalFile::kDirectAlignment) : 1;
+    const auto runs = plan_runs(*ctx.index, sorted, align);
+
+    if (parallel && runs.size() > 1) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, runs.size()),
+                          [&](const tbb::blocked_range<size_t>& r) {
+                              read_runs(ctx, runs, sorted, r.begin(), r.end(), slots);
+                          });
+    } else {
+        read_runs(ctx, runs, sorted, 0, runs.size(), slots);
+    }
+
+    int64_t bytes_read = 0;
+    for (const auto& r : runs) bytes_read += r.end - r.begin;
+    log_info("GENMESH_I0009", "bricks.bin coalesced read", {
+        {"payloads", std::to_string(sorted.size())},
+        {"runs", std::to_string(runs.size())},
+        {"bytes_read", std::to_string(bytes_read)},
+        {"direct_io", ctx.pfile->direct() ? "true" : "false"},
+    });
+}
+
+// ---------- shared payloads ----------
+
+/// Entries that point at the same stored payload (same offset_bytes,
+/// payload_bytes, encoding and crc32) are decoded once. canonical[bi] is the
+/// first such entry; `unique` lists the entries to read, in index order.
+/// Entries marked in `skip` (culled) take no part.
+static void find_shared_payloads(const BricksIndex& index, std::vector<size_t>& canonical,
+                                 std::vector<size_t>& unique,
+                                 const std::vector<BrickCull>* skip = nullptr) {
+    const size_t n = index.bricks.size();
+    canonical.resize(n);
+    unique.clear();
+    unique.reserve(n);
+
+    std::unordered_map<int64_t, size_t> first_at_offset;
+    for (size_t bi = 0; bi < n; ++bi) {
+        const auto& e = index.bricks[bi];
+        canonical[bi] = bi;
+        if (skip && (*skip)[bi] != BrickCull::Keep) continue;
+        if (!is_constant_encoding(e.encoding)) {
+            auto [it, inserted] = first_at_offset.emplace(e.offset_bytes, bi);
+            const auto& f = index.bricks[it->second];
+            if (!inserted && f.payload_bytes == e.payload_bytes && f.encoding == e.encoding &&
+                f.crc32 == e.crc32) {
+                canonical[bi] = it->second;
+                continue;
+            }
+        }
+        unique.push_back(bi);
+    }
+}
+
+// ---------- culling ----------
+
+BrickCull classify_brick(const BrickEntry& entry, const Manifest& manifest) {
+    if (is_constant_encoding(entry.encoding) || !entry.min || !entry.max) {
+        return BrickCull::Keep;
+    }
+    const float surface = manifest.iso + manifest.offset_mm;
+    const float band = static_cast<float>(manifest.half_width_voxels) * manifest.voxel_size +
+                       std::fabs(manifest.offset_mm);
+    if (*entry.min > surface + band) return BrickCull::Outside;
+    if (*entry.max < surface - band) return BrickCull::Inside;
+    return BrickCull::Keep;
 }
 
 // ---------- load ----------
 
+/// load_bricks_bin() / stream_bricks_bin(): with a sink, bricks are handed
+/// off as they are decoded instead of collected into result.bricks.
+static BricksDataResult read_bricks(const std::string& bin_path, const BricksIndex& index,
+                                    const Manifest& manifest, const BricksReadOptions& options,
+                                    const BrickSink* sink) {
+    BricksDataResult result;
+
+    DecodeContext ctx;
+    ctx.index = &index;
+    ctx.bin_path = bin_path;
+    ctx.verify_crc = options.verify_crc;
+    ctx.sink = sink;
+
+    if (options.mode == ReadMode::Mmap) {
+        std::string map_error;
+        ctx.file = MappedFile::open(bin_path, &map_error);
+        if (!ctx.file) {
+            add_error(result, E2001, "Cannot map bricks.bin: " + bin_path + " (" + map_error + ")");
+            result.exit_code = ExitCode::IoError;
+            return result;
+        }
+        ctx.file_size = ctx.file->size();
+
+        // Bricks are normally laid out in index order; let the kernel read ahead.
+        ctx.file->advise(MappedFile::Advice::Sequential);
+    } else if (options.mode == ReadMode::Coalesced) {
+        std::string open_error;
+        ctx.pfile = PositionalFile::open(bin_path, options.direct_io, &open_error);
+        if (!ctx.pfile) {
+            add_error(result, E2001, "Cannot open bricks.bin: " + bin_path + " (" + open_error + ")");
+            result.exit_code = ExitCode::IoError;
+            return result;
+        }
+        if (options.direct_io && !ctx.pfile->direct()) {
+            log_warn(W2002, "Direct I/O not supported for bricks.bin; using buffered reads",
+                     {{"path", bin_path}});
+        }
+        ctx.file_size = ctx.pfile->size();
+    } else {
+        // Open once up front to report a missing file and learn its size;
+        // decode tasks open their own handles.
+        std::ifstream ifs(bin_path, std::ios::binary | std::ios::ate);
+        if (!ifs.is_open()) {
+            add_error(result, E2001, "Cannot open bricks.bin: " + bin_path);
+            result.exit_code = ExitCode::IoError;
+            return result;
+        }
+        ctx.file_size = static_cast<int64_t>(ifs.tellg());
+    }
+
+    const int B = index.brick_size;
+    ctx.voxels_per_brick = static_cast<int64_t>(B) * B * B;
+    ctx.is_f16 = (index.dtype == "f16");
+    ctx.keep_half = ctx.is_f16 && options.keep_half;
+    ctx.band_mm = static_cast<float>(manifest.half_width_voxels) * manifest.voxel_size;
+    ctx.saturation_mm = manifest.background_value_mm;
+    ctx.summary_iso = options.summary_iso.value_or(manifest.iso);
+    for (const auto& e : index.bricks) {
+        if (e.min || e.max || e.crosses_iso) {
+            ctx.check_summary = true;
+            break;
+        }
+    }
+
+    const size_t n = index.bricks.size();
+    std::vector<BrickSlot> slots(n);
+
+    // --- cull from the summaries alone (no I/O for dropped bricks) ---
+    std::vector<BrickCull> cull;
+    if (options.cull) {
+        cull.resize(n);
+        for (size_t bi = 0; bi < n; ++bi) {
+            const auto& e = index.bricks[bi];
+            cull[bi] = classify_brick(e, manifest);
+            if (cull[bi] == BrickCull::Outside) {
+                ++result.culled_outside;
+            } else if (cull[bi] == BrickCull::Inside) {
+                slots[bi].brick.bx = e.bx;
+                slots[bi].brick.by = e.by;
+                slots[bi].brick.bz = e.bz;
+                slots[bi].brick.constant = *e.max;
+                slots[bi].ok = true;
+                ++result.culled_inside;
+                if (sink) (*sink)(slots[bi].brick);
+            }
+        }
+    }
+
+    // --- decode (range check, read, CRC32, f16 conversion), once per payload ---
+    std::vector<size_t> canonical, unique;
+    find_shared_payloads(index, canonical, unique, cull.empty() ? nullptr : &cull);
+    if (options.arena) {
+        // Collected: one slab with a slot per payload. Streamed: slots for a
+        // couple of bricks per worker, recycled as the sink releases them.
+        // With keep_half, raw and zstd/lz4 payloads stay binary16 and take
+        // half-sized slots of their own; only q8/q16 decode to floats. Slabs
+        // are allocated on first use, so an arena nobody needs costs nothing.
+        size_t float_slots = 0, half_slots = 0;
+        for (size_t bi : unique) {
+            const auto& e = index.bricks[bi];
+            if (is_constant_encoding(e.encoding)) continue;
+            if (ctx.keep_half && !is_band_quantized_encoding(e.encoding)) {
+                ++half_slots;
+            } else {
+                ++float_slots;
+            }
+        }
+        if (sink) {
+            const size_t per_worker =
+                2 * static_cast<size_t>(tbb::this_task_arena::max_concurrency());
+            float_slots = std::min(float_slots, per_worker);
+            half_slots = std::min(half_slots, per_worker);
+        }
+        const auto voxels = static_cast<size_t>(ctx.voxels_per_brick);
+        ctx.arena = BrickArena::create(voxels * sizeof(float), float_slots, options.huge_pages);
+        if (ctx.keep_half) {
+            ctx.half_arena =
+                BrickArena::create(voxels * sizeof(uint16_t), half_slots, options.huge_pages);
+        }
+    }
+    if (sink) {
+        ctx.sharers.resize(n);
+        for (size_t bi = 0; bi < n; ++bi) {
+            if (canonical[bi] != bi) ctx.sharers[canonical[bi]].push_back(bi);
+        }
+    }
+
+    if (ctx.pfile) {
+        load_coalesced(ctx, unique, options.parallel, slots);
+    } else if (options.parallel && unique.size() > 1) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, unique.size()),
+                          [&](const tbb::blocked_range<size_t>& r) {
+                              decode_range(ctx, unique, r.begin(), r.end(), slots);
+                          });
+    } else {
+        decode_range(ctx, unique, 0, unique.size(), slots);
+    }
+
+    // --- hand shared payloads to the other entries (no copy; streamed already) ---
+    for (size_t bi = 0; bi < n && !sink; ++bi) {
+        BrickSlot& src = slots[canonical[bi]];
+        if (canonical[bi] == bi || !src.ok) continue;  // a failed payload reports once
+        share_values(src.brick);
+
+        BrickData& bd = slots[bi].brick;
+        bd = src.brick;
+        bd.bx = index.bricks[bi].bx;
+        bd.by = index.bricks[bi].by;
+        bd.bz = index.bricks[bi].bz;
+        slots[bi].ok = true;
+        if (ctx.check_summary) {
+            check_summary(ctx, index.bricks[bi], "bricks[" + std::to_string(bi) + "]",
+                          slots[bi], src);
+        }
+    }
+    result.unique_payloads = unique.size();
+    if (ctx.arena) {
+        result.arena_bytes = ctx.arena->slab_bytes();
+        if (ctx.half_arena) result.arena_bytes += ctx.half_arena->slab_bytes();
+        log_info("GENMESH_I0014", "brick arena", {
+            {"slabs", std::to_string(ctx.arena->slab_count() +
+                                     (ctx.half_arena ? ctx.half_arena->slab_count() : 0))},
+            {"slot_bytes", std::to_string(ctx.arena->slot_bytes())},
+            {"half_slot_bytes",
+             std::to_string(ctx.half_arena ? ctx.half_arena->slot_bytes() : 0)},
+            {"slab_bytes", std::to_string(result.arena_bytes)},
+            {"huge_pages", ctx.arena->huge_pages() ||
+                                   (ctx.half_arena && ctx.half_arena->huge_pages())
+                               ? "true"
+                               : "false"},
+        });
+    }
+    if (options.cull) {
+        log_info("GENMESH_I0011", "bricks culled by min/max summary", {
+            {"outside", std::to_string(result.culled_outside)},
+            {"inside", std::to_string(result.culled_inside)},
+            {"kept", std::to_string(n - result.culled_outside - result.culled_inside)},
+        });
+    }
+
+    // --- merge in index order (deterministic errors + brick order) ---
+    if (!sink) result.bricks.reserve(n);
+    for (auto& slot : slots) {
+        for (const auto& e : slot.errors) {
+            add_error(result, e.code, e.message, e.field);
+        }
+        if (slot.ok && !sink) {
+            result.bricks.push_back(std::move(slot.brick));
+        }
+    }
+
+    // --- final result ---
+    if (result.errors.empty()) {
+        result.ok = true;
+        result.exit_code = ExitCode::Success;
+    } else {
+        result.ok = false;
+        result.exit_code = ExitCode::ValidationFailure;
+    }
+
+    return result;
+}
+
 BricksDataResult load_bricks_bin(const std::string& bin_path,
                                  const BricksIndex& index,
-                                 const Manifest& manifest) {
+                                 const Manifest& manifest,
+                                 const BricksReadOptions& options) {
+    return read_bricks(bin_path, index, manifest, options, nullptr);
+}
+
+BricksDataResult stream_bricks_bin(const std::string& bin_path,
+                                   const BricksIndex& index,
+                                   const Manifest& manifest,
+                                   const BricksReadOptions& options,
+                                   const BrickSink& sink) {
+    return read_bricks(bin_path, index, manifest, options, &sink);
+}
+
+// ---------- deferred CRC verification ----------
+
+BricksDataResult verify_bricks_crc(const std::string& bin_path,
+                                   const BricksIndex& index,
+                                   bool parallel) {
     BricksDataResult result;
 
-    // Open binary file
-    std::ifstream ifs(bin_path, std::ios::binary | std::ios::ate);
-    if (!ifs.is_open()) {
-        add_error(result, E2001, "Cannot open bricks.bin: " + bin_path);
+    std::string map_error;
+    auto file = MappedFile::open(bin_path, &map_error);
+    if (!file) {
+        add_error(result, E2001, "Cannot map bricks.bin: " + bin_path + " (" + map_error + ")");
         result.exit_code = ExitCode::IoError;
         return result;
     }
 
-    const int64_t file_size = static_cast<int64_t>(ifs.tellg());
-    ifs.seekg(0, std::ios::beg);
+    const size_t n = index.bricks.size();
+    std::vector<BrickSlot> slots(n);
+    std::vector<size_t> canonical, unique;
+    find_shared_payloads(index, canonical, unique);
 
-    const int B = index.brick_size;
-    const int64_t voxels_per_brick = static_cast<int64_t>(B) * B * B;
-    const bool is_f16 = (index.dtype == "f16");
-    const int sizeof_dtype = is_f16 ? 2 : 4;
-
-    result.bricks.reserve(index.bricks.size());
-
-    for (size_t bi = 0; bi < index.bricks.size(); ++bi) {
-        const auto& entry = index.bricks[bi];
-        std::string prefix = "bricks[" + std::to_string(bi) + "]";
-
-        // --- range check (§5.6) ---
-        if (entry.offset_bytes + entry.payload_bytes > file_size) {
-            add_error(result, E1105,
-                      prefix + " offset_bytes(" + std::to_string(entry.offset_bytes) +
-                      ") + payload_bytes(" + std::to_string(entry.payload_bytes) +
-                      ") exceeds file size(" + std::to_string(file_size) + ")",
-                      "bricks.bin");
-            continue;
-        }
-
-        // Read raw payload
-        std::vector<uint8_t> raw(static_cast<size_t>(entry.payload_bytes));
-        ifs.seekg(entry.offset_bytes, std::ios::beg);
-        ifs.read(reinterpret_cast<char*>(raw.data()), entry.payload_bytes);
-        if (!ifs) {
-            add_error(result, E2001,
-                      prefix + " read failed at offset " + std::to_string(entry.offset_bytes),
-                      "bricks.bin");
-            continue;
-        }
-
-        // --- CRC32 check (§5.6, optional) ---
-        if (entry.crc32.has_value()) {
-            uint32_t computed = crc32_calc(raw.data(), raw.size());
-            uint32_t expected = hex_to_u32(entry.crc32.value());
-            if (computed != expected) {
-                add_error(result, E1106,
-                          prefix + " CRC32 mismatch: computed=" + to_hex8(computed) +
-                          " expected=" + entry.crc32.value(),
-                          "bricks.bin");
-                continue;
-            }
-        }
+    auto verify_range = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const size_t bi = unique[i];
+            const auto& entry = index.bricks[bi];
+            if (!entry.crc32.has_value()) continue;
 
-        // --- Convert to float array ---
-        BrickData bd;
-        bd.bx = entry.bx;
-        bd.by = entry.by;
-        bd.bz = entry.bz;
-        bd.values.resize(static_cast<size_t>(voxels_per_brick));
+            // Out-of-range entries are reported by load_bricks_bin(); skip them here.
+            if (entry.offset_bytes + entry.payload_bytes > file->size()) continue;
 
-        if (is_f16) {
-            for (int64_t i = 0; i < voxels_per_brick; ++i) {
-                uint16_t h;
-                std::memcpy(&h, raw.data() + i * 2, 2);
-                bd.values[static_cast<size_t>(i)] = half_to_float(h);
-            }
-        } else {
-            // f32: direct memcpy (little-endian assumed)
-            std::memcpy(bd.values.data(), raw.data(),
-                        static_cast<size_t>(voxels_per_brick) * sizeof(float));
+            const std::string prefix = "bricks[" + std::to_string(bi) + "]";
+            check_crc(entry, file->data() + entry.offset_bytes, prefix, slots[bi]);
         }
+    };
 
-        result.bricks.push_back(std::move(bd));
+    if (parallel && unique.size() > 1) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, unique.size()),
+                          [&](const tbb::blocked_range<size_t>& r) {
+                              verify_range(r.begin(), r.end());
+                          });
+    } else {
+        verify_range(0, unique.size());
+    }
+
+    for (const auto& slot : slots) {
+        for (const auto& e : slot.errors) {
+            add_error(result, e.code, e.message, e.field);
+        }
     }
 
-    // --- final result ---
     if (result.errors.empty()) {
         result.ok = true;
         result.exit_code = ExitCode::Success;
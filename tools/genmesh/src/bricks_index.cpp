@@ -1,13 +1,20 @@
 #include "genmesh/bricks_index.h"
+#include "genmesh/brick_codec.h"
+#include "genmesh/crc32.h"
 #include "genmesh/error_code.h"
 #include "genmesh/log.h"
 
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <fstream>
+#include <iterator>
 #include <set>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace genmesh {
 
@@ -21,34 +28,345 @@ static void add_error(BricksIndexResult& r, std::string_view code,
     log_error(code, msg, field.empty() ? std::vector<KV>{} : std::vector<KV>{{"field", field}});
 }
 
-// ---------- load + validate ----------
+static bool is_hex_digest(const std::string& s) {
+    if (s.size() < 8 || s.size() > 128) return false;
+    for (char c : s) {
+        if (!std::isxdigit(static_cast<unsigned char>(c))) return false;
+    }
+    return true;
+}
 
-BricksIndexResult load_bricks_index(const std::string& path,
-                                    const Manifest& manifest) {
-    BricksIndexResult result;
+// ---------- streaming parse ----------
+//
+// bricks.index.json is read with a SAX handler that fills BricksIndex
+// directly; no DOM is built. Which fields were present / well-typed is
+// recorded as bit flags and validated afterwards, so diagnostics come out
+// in the same order as a field-by-field walk of the document (and header
+// fields may appear after "bricks"). Repeated keys: the last one wins.
+
+namespace {
+
+// Header fields (bit set in ParsedIndex::header)
+constexpr uint32_t kVersion = 1u << 0;
+constexpr uint32_t kBrickSize = 1u << 1;
+constexpr uint32_t kDtype = 1u << 2;
+constexpr uint32_t kAxisOrder = 1u << 3;
+constexpr uint32_t kDims = 1u << 4;
+constexpr uint32_t kBricks = 1u << 5;
+
+// Brick fields (bit set per entry in ParsedIndex::fields)
+constexpr uint16_t kBx = 1u << 0;
+constexpr uint16_t kBy = 1u << 1;
+constexpr uint16_t kBz = 1u << 2;
+constexpr uint16_t kOffset = 1u << 3;
+constexpr uint16_t kPayload = 1u << 4;
+constexpr uint16_t kEncoding = 1u << 5;
+constexpr uint16_t kHashPresent = 1u << 6;
+constexpr uint16_t kValuePresent = 1u << 7;
+constexpr uint16_t kMinPresent = 1u << 8;
+constexpr uint16_t kMaxPresent = 1u << 9;
+constexpr uint16_t kCrossesPresent = 1u << 10;
+constexpr uint16_t kCrcPresent = 1u << 11;
+
+struct ParsedIndex {
+    BricksIndex idx;
+    uint32_t header = 0;
+    std::vector<uint16_t> fields;  // parallel to idx.bricks
+};
+
+/// A scalar JSON value, or a marker for an object/array in its place.
+struct Scalar {
+    enum class Type { Null, Bool, Int, Uint, Float, String, Container };
+    Type type = Type::Null;
+    int64_t i = 0;
+    uint64_t u = 0;
+    double f = 0.0;
+    std::string* s = nullptr;
+
+    bool is_integer() const { return type == Type::Int || type == Type::Uint; }
+    bool is_number() const { return is_integer() || type == Type::Float; }
+    bool is_string() const { return type == Type::String; }
+    template <typename T>
+    T as() const {
+        switch (type) {
+            case Type::Bool:
+            case Type::Int: return static_cast<T>(i);
+            case Type::Uint: return static_cast<T>(u);
+            case Type::Float: return static_cast<T>(f);
+            default: return T{};
+        }
+    }
+};
 
-    // --- read file ---
-    std::ifstream ifs(path);
-    if (!ifs.is_open()) {
-        add_error(result, E2003, "Cannot open bricks index: " + path);
-        result.exit_code = ExitCode::IoError;
-        return result;
+class IndexSaxHandler : public nlohmann::json_sax<json> {
+public:
+    explicit IndexSaxHandler(ParsedIndex& out) : out_(out) {}
+
+    std::string parse_error_msg;
+
+    bool null() override { return value(Scalar{}); }
+    bool boolean(bool v) override {
+        Scalar s = make(Scalar::Type::Bool);
+        s.i = v ? 1 : 0;
+        return value(s);
+    }
+    bool number_integer(number_integer_t v) override {
+        Scalar s = make(Scalar::Type::Int);
+        s.i = v;
+        return value(s);
+    }
+    bool number_unsigned(number_unsigned_t v) override {
+        Scalar s = make(Scalar::Type::Uint);
+        s.u = v;
+        return value(s);
+    }
+    bool number_float(number_float_t v, const string_t&) override {
+        Scalar s = make(Scalar::Type::Float);
+        s.f = v;
+        return value(s);
+    }
+    bool string(string_t& v) override {
+        Scalar s = make(Scalar::Type::String);
+        s.s = &v;
+        return value(s);
+    }
+    bool binary(binary_t&) override { return value(make(Scalar::Type::Container)); }
+
+    bool start_object(std::size_t) override {
+        switch (context()) {
+            case Ctx::None:
+                stack_.push_back(Ctx::Top);
+                return true;
+            case Ctx::Bricks:
+                new_brick();
+                stack_.push_back(Ctx::Brick);
+                return true;
+            default:
+                value(make(Scalar::Type::Container));
+                stack_.push_back(Ctx::Skip);
+                return true;
+        }
     }
 
-    json j;
-    try {
-        j = json::parse(ifs);
-    } catch (const json::parse_error& e) {
-        add_error(result, E2003, std::string("bricks.index.json parse error: ") + e.what());
-        result.exit_code = ExitCode::ValidationFailure;
-        return result;
+    bool start_array(std::size_t) override {
+        if (context() == Ctx::Top && key_ == "dims") {
+            out_.header &= ~kDims;
+            out_.idx.dims = {};
+            dims_count_ = 0;
+            dims_valid_ = true;
+            stack_.push_back(Ctx::Dims);
+            return true;
+        }
+        if (context() == Ctx::Top && key_ == "bricks") {
+            out_.header |= kBricks;
+            out_.idx.bricks.clear();
+            out_.fields.clear();
+            stack_.push_back(Ctx::Bricks);
+            return true;
+        }
+        // a root that is not an object has no fields at all
+        if (context() != Ctx::None) value(make(Scalar::Type::Container));
+        stack_.push_back(Ctx::Skip);
+        return true;
+    }
+
+    bool key(string_t& k) override {
+        if (context() == Ctx::Top || context() == Ctx::Brick) key_ = std::move(k);
+        return true;
+    }
+
+    bool end_object() override {
+        stack_.pop_back();
+        return true;
     }
 
+    bool end_array() override {
+        if (context() == Ctx::Dims) {
+            if (dims_valid_ && dims_count_ == 3) {
+                out_.header |= kDims;
+            } else {
+                out_.idx.dims = {};
+            }
+        }
+        stack_.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception& ex) override {
+        parse_error_msg = ex.what();
+        return false;
+    }
+
+private:
+    enum class Ctx { None, Top, Dims, Bricks, Brick, Skip };
+
+    Ctx context() const { return stack_.empty() ? Ctx::None : stack_.back(); }
+
+    static Scalar make(Scalar::Type t) {
+        Scalar s;
+        s.type = t;
+        return s;
+    }
+
+    void new_brick() {
+        out_.idx.bricks.emplace_back();
+        out_.fields.push_back(0);
+    }
+
+    bool value(const Scalar& v) {
+        switch (context()) {
+            case Ctx::None: break;  // scalar document
+            case Ctx::Top: set_header(v); break;
+            case Ctx::Dims: add_dim(v); break;
+            case Ctx::Bricks: new_brick(); break;  // not an object: no fields
+            case Ctx::Brick: set_brick_field(v); break;
+            case Ctx::Skip: break;
+        }
+        return true;
+    }
+
+    // Assign on a well-typed value, otherwise reset to the default: the
+    // last occurrence of a key decides, as with a DOM lookup.
+    template <typename T>
+    static void assign(bool ok, T& dst, T val, uint32_t& flags, uint32_t bit) {
+        dst = ok ? val : T{};
+        flags = ok ? (flags | bit) : (flags & ~bit);
+    }
+
+    void set_header(const Scalar& v) {
+        auto& idx = out_.idx;
+        uint32_t& h = out_.header;
+        if (key_ == "version") {
+            assign(v.is_integer(), idx.version, v.as<int>(), h, kVersion);
+        } else if (key_ == "brick_size") {
+            assign(v.is_integer(), idx.brick_size, v.as<int>(), h, kBrickSize);
+        } else if (key_ == "dtype") {
+            assign(v.is_string(), idx.dtype, v.is_string() ? std::move(*v.s) : std::string(), h,
+                   kDtype);
+        } else if (key_ == "axis_order") {
+            assign(v.is_string(), idx.axis_order, v.is_string() ? std::move(*v.s) : std::string(),
+                   h, kAxisOrder);
+        } else if (key_ == "dims") {
+            h &= ~kDims;  // arrays go through start_array()
+            idx.dims = {};
+        } else if (key_ == "bricks") {
+            h &= ~kBricks;
+            idx.bricks.clear();
+            out_.fields.clear();
+        }
+    }
+
+    void add_dim(const Scalar& v) {
+        // int conversion of numbers and booleans; anything else is invalid
+        if (dims_count_ < 3) out_.idx.dims[dims_count_] = v.as<int>();
+        dims_valid_ = dims_valid_ && (v.is_number() || v.type == Scalar::Type::Bool);
+        ++dims_count_;
+    }
+
+    void set_brick_field(const Scalar& v) {
+        BrickEntry& e = out_.idx.bricks.back();
+        uint32_t f = out_.fields.back();
+        if (key_ == "bx") {
+            assign(v.is_integer(), e.bx, v.as<int>(), f, kBx);
+        } else if (key_ == "by") {
+            assign(v.is_integer(), e.by, v.as<int>(), f, kBy);
+        } else if (key_ == "bz") {
+            assign(v.is_integer(), e.bz, v.as<int>(), f, kBz);
+        } else if (key_ == "offset_bytes") {
+            assign(v.is_integer(), e.offset_bytes, v.as<int64_t>(), f, kOffset);
+        } else if (key_ == "payload_bytes") {
+            assign(v.is_integer(), e.payload_bytes, v.as<int64_t>(), f, kPayload);
+        } else if (key_ == "encoding") {
+            assign(v.is_string(), e.encoding, v.is_string() ? std::move(*v.s) : std::string(), f,
+                   kEncoding);
+        } else if (key_ == "crc32") {
+            // presence alone matters for the diagnostic; only valid values are kept
+            f |= kCrcPresent;
+            uint32_t crc = 0;
+            e.crc32 = (v.is_string() && parse_crc32_hex(*v.s, crc))
+                          ? std::optional<std::string>(std::move(*v.s))
+                          : std::nullopt;
+        } else if (key_ == "content_hash") {
+            // presence alone matters for the diagnostic; only valid digests are kept
+            f |= kHashPresent;
+            e.content_hash = (v.is_string() && is_hex_digest(*v.s))
+                                 ? std::optional<std::string>(std::move(*v.s))
+                                 : std::nullopt;
+        } else if (key_ == "value") {
+            f |= kValuePresent;
+            e.value = v.is_number() ? std::optional<float>(v.as<float>()) : std::nullopt;
+        } else if (key_ == "min") {
+            f |= kMinPresent;
+            e.min = v.is_number() ? std::optional<float>(v.as<float>()) : std::nullopt;
+        } else if (key_ == "max") {
+            f |= kMaxPresent;
+            e.max = v.is_number() ? std::optional<float>(v.as<float>()) : std::nullopt;
+        } else if (key_ == "crosses_iso") {
+            f |= kCrossesPresent;
+            e.crosses_iso = v.type == Scalar::Type::Bool ? std::optional<bool>(v.i != 0)
+                                                         : std::nullopt;
+        }
+        out_.fields.back() = static_cast<uint16_t>(f);
+    }
+
+    ParsedIndex& out_;
+    std::vector<Ctx> stack_;
+    std::string key_;
+    size_t dims_count_ = 0;
+    bool dims_valid_ = true;
+};
+
+/// Set of brick coordinates for the duplicate check. Coordinates that fit
+/// 21 bits per axis are packed into one key of an open-addressing table
+/// sized up front; anything else (already an E1103) goes to a fallback set.
+class CoordSet {
+public:
+    explicit CoordSet(size_t expected) {
+        size_t cap = 16;
+        while (cap < expected * 2) cap <<= 1;
+        slots_.assign(cap, 0);
+        mask_ = cap - 1;
+    }
+
+    /// Returns false if (bx, by, bz) was already inserted.
+    bool insert(int bx, int by, int bz) {
+        constexpr int kLimit = 1 << 21;
+        if (bx < 0 || by < 0 || bz < 0 || bx >= kLimit || by >= kLimit || bz >= kLimit) {
+            return overflow_.insert(std::make_tuple(bx, by, bz)).second;
+        }
+        // +1 keeps 0 free as the empty marker
+        const uint64_t key = (static_cast<uint64_t>(bx) | static_cast<uint64_t>(by) << 21 |
+                              static_cast<uint64_t>(bz) << 42) + 1;
+        size_t i = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+        while (slots_[i] != 0) {
+            if (slots_[i] == key) return false;
+            i = (i + 1) & mask_;
+        }
+        slots_[i] = key;
+        return true;
+    }
+
+private:
+    std::vector<uint64_t> slots_;
+    size_t mask_ = 0;
+    std::set<std::tuple<int, int, int>> overflow_;
+};
+
+}  // namespace
+
+// ---------- validate ----------
+
+// Validate `parsed` (moved into result.index) and cross-check it against
+// the manifest; sets ok / exit_code.
+static void validate_index(BricksIndexResult& result, ParsedIndex& parsed,
+                           const Manifest& manifest) {
+    result.index = std::move(parsed.idx);
     auto& idx = result.index;
+    const uint32_t header = parsed.header;
 
     // --- version ---
-    if (j.contains("version") && j["version"].is_number_integer()) {
-        idx.version = j["version"].get<int>();
+    if (header & kVersion) {
         if (idx.version != 1) {
             add_error(result, E1101,
                       "Unsupported bricks index version: " + std::to_string(idx.version),
@@ -59,22 +377,17 @@ BricksIndexResult load_bricks_index(const std::string& path,
     }
 
     // --- brick_size ---
-    if (j.contains("brick_size") && j["brick_size"].is_number_integer()) {
-        idx.brick_size = j["brick_size"].get<int>();
-    } else {
+    if (!(header & kBrickSize)) {
         add_error(result, E1101, "Missing or invalid field: brick_size", "brick_size");
     }
 
     // --- dtype ---
-    if (j.contains("dtype") && j["dtype"].is_string()) {
-        idx.dtype = j["dtype"].get<std::string>();
-    } else {
+    if (!(header & kDtype)) {
         add_error(result, E1101, "Missing or invalid field: dtype", "dtype");
     }
 
     // --- axis_order ---
-    if (j.contains("axis_order") && j["axis_order"].is_string()) {
-        idx.axis_order = j["axis_order"].get<std::string>();
+    if (header & kAxisOrder) {
         if (idx.axis_order != "x-fastest") {
             add_error(result, E1101,
                       "axis_order must be \"x-fastest\", got: " + idx.axis_order,
@@ -85,11 +398,7 @@ BricksIndexResult load_bricks_index(const std::string& path,
     }
 
     // --- dims ---
-    if (j.contains("dims") && j["dims"].is_array() && j["dims"].size() == 3) {
-        for (int i = 0; i < 3; ++i) {
-            idx.dims[i] = j["dims"][i].get<int>();
-        }
-    } else {
+    if (!(header & kDims)) {
         add_error(result, E1101, "Missing or invalid field: dims (expected int[3])", "dims");
     }
 
@@ -128,7 +437,7 @@ BricksIndexResult load_bricks_index(const std::string& path,
         }
     }
 
-    // ========== Parse bricks array ==========
+    // ========== Validate bricks array ==========
 
     const int B = idx.brick_size > 0 ? idx.brick_size : manifest.brick_size;
     const int sizeof_dtype = (idx.dtype == "f16" || manifest.dtype == "f16") ? 2 : 4;
@@ -143,67 +452,141 @@ BricksIndexResult load_bricks_index(const std::string& path,
     const int max_by = max_bcoord(1);
     const int max_bz = max_bcoord(2);
 
-    if (j.contains("bricks") && j["bricks"].is_array()) {
+    if (header & kBricks) {
         // Duplicate detection
-        std::set<std::tuple<int, int, int>> seen;
-
-        for (size_t bi = 0; bi < j["bricks"].size(); ++bi) {
-            const auto& bj = j["bricks"][bi];
-            BrickEntry entry;
-
-            std::string prefix = "bricks[" + std::to_string(bi) + "]";
-
-            if (bj.contains("bx") && bj["bx"].is_number_integer()) {
-                entry.bx = bj["bx"].get<int>();
-            } else {
-                add_error(result, E1101, prefix + ".bx missing or invalid", "bricks");
+        CoordSet seen(idx.bricks.size());
+        // Shared payloads (dedup): first entry per offset_bytes
+        std::unordered_map<int64_t, size_t> first_at_offset;
+        bool has_band_quantized = false;
+
+        for (size_t bi = 0; bi < idx.bricks.size(); ++bi) {
+            BrickEntry& entry = idx.bricks[bi];
+            const uint16_t fields = parsed.fields[bi];
+
+            // only built when a diagnostic needs it
+            std::string prefix_buf;
+            auto prefix = [&]() -> const std::string& {
+                if (prefix_buf.empty()) prefix_buf = "bricks[" + std::to_string(bi) + "]";
+                return prefix_buf;
+            };
+
+            if (!(fields & kBx)) {
+                add_error(result, E1101, prefix() + ".bx missing or invalid", "bricks");
             }
-
-            if (bj.contains("by") && bj["by"].is_number_integer()) {
-                entry.by = bj["by"].get<int>();
-            } else {
-                add_error(result, E1101, prefix + ".by missing or invalid", "bricks");
+            if (!(fields & kBy)) {
+                add_error(result, E1101, prefix() + ".by missing or invalid", "bricks");
             }
-
-            if (bj.contains("bz") && bj["bz"].is_number_integer()) {
-                entry.bz = bj["bz"].get<int>();
-            } else {
-                add_error(result, E1101, prefix + ".bz missing or invalid", "bricks");
+            if (!(fields & kBz)) {
+                add_error(result, E1101, prefix() + ".bz missing or invalid", "bricks");
+            }
+            if (!(fields & kOffset)) {
+                add_error(result, E1101, prefix() + ".offset_bytes missing or invalid", "bricks");
+            }
+            if (!(fields & kPayload)) {
+                add_error(result, E1101, prefix() + ".payload_bytes missing or invalid", "bricks");
             }
 
-            if (bj.contains("offset_bytes") && bj["offset_bytes"].is_number_integer()) {
-                entry.offset_bytes = bj["offset_bytes"].get<int64_t>();
+            if (fields & kEncoding) {
+                if (!is_known_encoding(entry.encoding)) {
+                    add_error(result, E1101,
+                              prefix() + ".encoding must be \"raw\", \"zstd\", \"lz4\", \"sdfp\", " +
+                              "\"q8\", \"q16\" or \"constant\", got: " + entry.encoding,
+                              "bricks");
+                } else if (!idx.dtype.empty() && !encoding_supports_dtype(entry.encoding, idx.dtype)) {
+                    add_error(result, E1101,
+                              prefix() + ".encoding " + entry.encoding + " requires dtype f32, got: " +
+                              idx.dtype,
+                              "bricks");
+                }
             } else {
-                add_error(result, E1101, prefix + ".offset_bytes missing or invalid", "bricks");
+                add_error(result, E1101, prefix() + ".encoding missing or invalid", "bricks");
             }
 
-            if (bj.contains("payload_bytes") && bj["payload_bytes"].is_number_integer()) {
-                entry.payload_bytes = bj["payload_bytes"].get<int64_t>();
-            } else {
-                add_error(result, E1101, prefix + ".payload_bytes missing or invalid", "bricks");
+            if ((fields & kHashPresent) && !entry.content_hash) {
+                add_error(result, E1101,
+                          prefix() + ".content_hash must be a hex string of 8-128 digits",
+                          "bricks");
+            }
+            uint32_t crc = 0;
+            if ((fields & kCrcPresent) && !(entry.crc32 && parse_crc32_hex(*entry.crc32, crc))) {
+                add_error(result, E1101, prefix() + ".crc32 must be a hex string of 8 digits",
+                          "bricks");
             }
 
-            if (bj.contains("encoding") && bj["encoding"].is_string()) {
-                entry.encoding = bj["encoding"].get<std::string>();
-                if (entry.encoding != "raw") {
+            // --- constant bricks carry their value here (§5.4) ---
+            if (is_constant_encoding(entry.encoding)) {
+                if (entry.value) {
+                    if (!std::isfinite(*entry.value)) {
+                        add_error(result, E1101, prefix() + ".value must be finite", "bricks");
+                    }
+                } else {
                     add_error(result, E1101,
-                              prefix + ".encoding must be \"raw\", got: " + entry.encoding,
+                              prefix() + ".value missing or invalid (required for encoding constant)",
                               "bricks");
                 }
             } else {
-                add_error(result, E1101, prefix + ".encoding missing or invalid", "bricks");
+                entry.value.reset();
+                if (fields & kValuePresent) {
+                    add_error(result, E1101,
+                              prefix() + ".value is only allowed with encoding constant", "bricks");
+                }
             }
 
-            if (bj.contains("crc32") && bj["crc32"].is_string()) {
-                entry.crc32 = bj["crc32"].get<std::string>();
+            // --- optional value summary (§5.4) ---
+            if ((fields & kMinPresent) && !(entry.min && std::isfinite(*entry.min))) {
+                add_error(result, E1101, prefix() + ".min must be a finite number", "bricks");
+            }
+            if ((fields & kMaxPresent) && !(entry.max && std::isfinite(*entry.max))) {
+                add_error(result, E1101, prefix() + ".max must be a finite number", "bricks");
+            }
+            if ((fields & kCrossesPresent) && !entry.crosses_iso) {
+                add_error(result, E1101, prefix() + ".crosses_iso must be a boolean", "bricks");
+            }
+            if (((fields & kMinPresent) != 0) != ((fields & kMaxPresent) != 0)) {
+                add_error(result, E1101, prefix() + ".min and .max must be given together",
+                          "bricks");
+            } else if (entry.min && entry.max && *entry.min > *entry.max) {
+                add_error(result, E1101,
+                          prefix() + ".min=" + std::to_string(*entry.min) + " > .max=" +
+                          std::to_string(*entry.max),
+                          "bricks");
+            } else if (entry.value && entry.min && entry.max &&
+                       (*entry.value < *entry.min || *entry.value > *entry.max)) {
+                add_error(result, E1101, prefix() + ".value lies outside [min, max]", "bricks");
             }
 
             // --- payload_bytes check (§5.6) ---
-            if (entry.encoding == "raw" && entry.payload_bytes != expected_payload) {
+            if (is_constant_encoding(entry.encoding)) {
+                if (entry.payload_bytes != 0) {
+                    add_error(result, E1104,
+                              prefix() + ".payload_bytes=" + std::to_string(entry.payload_bytes) +
+                              " must be 0 for encoding constant",
+                              "bricks");
+                }
+            } else if (is_band_quantized_encoding(entry.encoding)) {
+                // fixed point: size is implied by B and the encoding, not dtype
+                has_band_quantized = true;
+                const int64_t expected_q = static_cast<int64_t>(B) * B * B *
+                                           static_cast<int64_t>(band_quantized_value_bytes(entry.encoding));
+                if (entry.payload_bytes != expected_q) {
+                    add_error(result, E1104,
+                              prefix() + ".payload_bytes=" + std::to_string(entry.payload_bytes) +
+                              " != B^3*" + std::to_string(band_quantized_value_bytes(entry.encoding)) +
+                              "=" + std::to_string(expected_q) + " for encoding " + entry.encoding,
+                              "bricks");
+                }
+            } else if (is_raw_encoding(entry.encoding) && entry.payload_bytes != expected_payload) {
                 add_error(result, E1104,
-                          prefix + ".payload_bytes=" + std::to_string(entry.payload_bytes) +
+                          prefix() + ".payload_bytes=" + std::to_string(entry.payload_bytes) +
                           " != B^3*sizeof(dtype)=" + std::to_string(expected_payload),
                           "bricks");
+            } else if (is_known_encoding(entry.encoding) && !is_raw_encoding(entry.encoding) &&
+                       entry.payload_bytes <= 0) {
+                // compressed: stored size is free, but never empty
+                add_error(result, E1104,
+                          prefix() + ".payload_bytes=" + std::to_string(entry.payload_bytes) +
+                          " must be > 0 for encoding " + entry.encoding,
+                          "bricks");
             }
 
             // --- brick coordinate range check (§5.4) ---
@@ -211,7 +594,7 @@ BricksIndexResult load_bricks_index(const std::string& path,
                 entry.by < 0 || entry.by > max_by ||
                 entry.bz < 0 || entry.bz > max_bz) {
                 add_error(result, E1103,
-                          prefix + " brick (" + std::to_string(entry.bx) + "," +
+                          prefix() + " brick (" + std::to_string(entry.bx) + "," +
                           std::to_string(entry.by) + "," + std::to_string(entry.bz) +
                           ") out of range [0," + std::to_string(max_bx) + "]x[0," +
                           std::to_string(max_by) + "]x[0," + std::to_string(max_bz) + "]",
@@ -219,15 +602,42 @@ BricksIndexResult load_bricks_index(const std::string& path,
             }
 
             // --- duplicate check (§5.6) ---
-            auto key = std::make_tuple(entry.bx, entry.by, entry.bz);
-            if (!seen.insert(key).second) {
+            if (!seen.insert(entry.bx, entry.by, entry.bz)) {
                 add_error(result, E1102,
-                          prefix + " duplicate brick (" + std::to_string(entry.bx) + "," +
+                          prefix() + " duplicate brick (" + std::to_string(entry.bx) + "," +
                           std::to_string(entry.by) + "," + std::to_string(entry.bz) + ")",
                           "bricks");
             }
 
-            idx.bricks.push_back(std::move(entry));
+            // --- shared payload check (§5.4): same bytes, same description ---
+            if (!is_constant_encoding(entry.encoding)) {
+                auto [it, inserted] = first_at_offset.emplace(entry.offset_bytes, bi);
+                if (!inserted) {
+                    const auto& first = idx.bricks[it->second];
+                    if (first.payload_bytes != entry.payload_bytes ||
+                        first.encoding != entry.encoding || first.crc32 != entry.crc32 ||
+                        first.content_hash != entry.content_hash) {
+                        add_error(result, E1101,
+                                  prefix() + " shares offset_bytes=" + std::to_string(entry.offset_bytes) +
+                                  " with bricks[" + std::to_string(it->second) +
+                                  "] but differs in payload_bytes/encoding/crc32/content_hash",
+                                  "bricks");
+                    }
+                }
+            }
+        }
+
+        // q8/q16 keep only the sign outside the band, so the surface the
+        // mesher extracts (iso, shifted by offset_mm) must lie inside it.
+        if (has_band_quantized) {
+            const float band = static_cast<float>(manifest.half_width_voxels) * manifest.voxel_size;
+            const float reach = std::fabs(manifest.iso) + std::fabs(manifest.offset_mm);
+            if (!(reach < band)) {
+                add_error(result, E1101,
+                          "band-quantized bricks need |iso|+|offset_mm| (" + std::to_string(reach) +
+                          ") < half_width_voxels*voxel_size (" + std::to_string(band) + ")",
+                          "bricks");
+            }
         }
     } else {
         add_error(result, E1101, "Missing or invalid field: bricks", "bricks");
@@ -241,8 +651,120 @@ BricksIndexResult load_bricks_index(const std::string& path,
         result.ok = false;
         result.exit_code = ExitCode::ValidationFailure;
     }
+}
 
+// ---------- load ----------
+
+BricksIndexResult load_bricks_index(const std::string& path,
+                                    const Manifest& manifest) {
+    BricksIndexResult result;
+
+    // --- read file ---
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) {
+        add_error(result, E2003, "Cannot open bricks index: " + path);
+        result.exit_code = ExitCode::IoError;
+        return result;
+    }
+    const std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    ParsedIndex parsed;
+    {
+        IndexSaxHandler handler(parsed);
+        if (!json::sax_parse(text, &handler)) {
+            add_error(result, E2003,
+                      std::string("bricks.index.json parse error: ") + handler.parse_error_msg);
+            result.exit_code = ExitCode::ValidationFailure;
+            return result;
+        }
+    }
+
+    validate_index(result, parsed, manifest);
+    return result;
+}
+
+BricksIndexResult validate_bricks_index(BricksIndex index, const Manifest& manifest) {
+    ParsedIndex parsed;
+    parsed.idx = std::move(index);
+    parsed.header = kVersion | kBrickSize | kDtype | kAxisOrder | kDims | kBricks;
+    parsed.fields.reserve(parsed.idx.bricks.size());
+    for (const auto& e : parsed.idx.bricks) {
+        uint16_t f = kBx | kBy | kBz | kOffset | kPayload | kEncoding;
+        if (e.content_hash) f |= kHashPresent;
+        if (e.value) f |= kValuePresent;
+        if (e.min) f |= kMinPresent;
+        if (e.max) f |= kMaxPresent;
+        if (e.crosses_iso) f |= kCrossesPresent;
+        if (e.crc32) f |= kCrcPresent;
+        parsed.fields.push_back(f);
+    }
+
+    BricksIndexResult result;
+    validate_index(result, parsed, manifest);
     return result;
 }
 
+int clip_margin_voxels(const Manifest& manifest, float shell_mm) {
+    const double vs = manifest.voxel_size;
+    return manifest.half_width_voxels + 1 +
+           static_cast<int>(std::ceil(std::fabs(manifest.offset_mm) / vs)) +
+           static_cast<int>(std::ceil(std::max(shell_mm, 0.0f) / vs));
+}
+
+BrickClipStats clip_bricks_index(BricksIndex& index, const Manifest& manifest,
+                                 const WorldBox& box, int margin_voxels) {
+    // box -> inclusive voxel range, widened to whole voxels plus the margin
+    std::array<int64_t, 3> lo{}, hi{};
+    for (int a = 0; a < 3; ++a) {
+        const double vs = manifest.voxel_size;
+        lo[a] = static_cast<int64_t>(std::floor((box.min[a] - manifest.aabb_min[a]) / vs)) -
+                margin_voxels;
+        hi[a] = static_cast<int64_t>(std::ceil((box.max[a] - manifest.aabb_min[a]) / vs)) +
+                margin_voxels;
+    }
+
+    const int64_t B = index.brick_size;
+    auto intersects = [&](const BrickEntry& e) {
+        const int64_t c[3] = {e.bx, e.by, e.bz};
+        for (int a = 0; a < 3; ++a) {
+            if (c[a] * B > hi[a] || c[a] * B + B - 1 < lo[a]) return false;
+        }
+        return true;
+    };
+
+    BrickClipStats stats;
+    std::vector<BrickEntry> kept;
+    std::vector<const BrickEntry*> dropped;
+    std::unordered_set<int64_t> kept_offsets;
+    for (auto& e : index.bricks) {
+        if (intersects(e)) {
+            if (!is_constant_encoding(e.encoding)) kept_offsets.insert(e.offset_bytes);
+            kept.push_back(std::move(e));
+        } else {
+            dropped.push_back(&e);
+        }
+    }
+
+    // a payload shared with a kept entry is still read
+    std::unordered_set<int64_t> counted;
+    for (const BrickEntry* e : dropped) {
+        if (is_constant_encoding(e->encoding) || kept_offsets.count(e->offset_bytes) ||
+            !counted.insert(e->offset_bytes).second) {
+            continue;
+        }
+        stats.bytes_skipped += e->payload_bytes;
+    }
+
+    stats.kept = static_cast<int64_t>(kept.size());
+    stats.skipped = static_cast<int64_t>(dropped.size());
+    index.bricks = std::move(kept);
+
+    log_info("GENMESH_I0012", "bricks.index.json clipped to bbox", {
+        {"kept", std::to_string(stats.kept)},
+        {"skipped", std::to_string(stats.skipped)},
+        {"bytes_skipped", std::to_string(stats.bytes_skipped)},
+    });
+    return stats;
+}
+
 }  // namespace genmesh
@@ -0,0 +1,476 @@
+#include "genmesh/bricks_pack.h"
+#include "genmesh/brick_codec.h"
+#include "genmesh/crc32.h"
+#include "genmesh/error_code.h"
+#include "genmesh/log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace genmesh {
+
+// ---------- helpers ----------
+
+static void add_error(BricksPackResult& r, std::string_view code,
+                      const std::string& msg, const std::string& field = "") {
+    r.errors.push_back({std::string(code), msg, field});
+    log_error(code, msg, field.empty() ? std::vector<KV>{} : std::vector<KV>{{"field", field}});
+}
+
+static void set_error(std::string* error_msg, const std::string& msg) {
+    if (error_msg) *error_msg = msg;
+}
+
+static constexpr const char* kEncodingNames[] = {
+    "raw", "zstd", "lz4", "sdfp", "q8", "q16", "constant",
+};
+static constexpr size_t kEncodingCount = sizeof(kEncodingNames) / sizeof(kEncodingNames[0]);
+
+static int encoding_id(std::string_view name) {
+    for (size_t i = 0; i < kEncodingCount; ++i) {
+        if (name == kEncodingNames[i]) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+static std::string to_hex8(uint32_t val) {
+    char buf[9];
+    snprintf(buf, sizeof(buf), "%08x", val);
+    return std::string(buf);
+}
+
+static uint64_t align_up(uint64_t v, uint64_t a) { return (v + a - 1) / a * a; }
+
+static uint64_t bricks_per_axis(int dim, int brick_size) {
+    return (dim > 0 && brick_size > 0) ? (static_cast<uint64_t>(dim) + brick_size - 1) / brick_size
+                                       : 0;
+}
+
+// ---------- Morton code ----------
+
+// Spread the low 21 bits of v so that bit i lands on bit 3i.
+static uint64_t spread_bits3(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffull;
+    v = (v | v << 16) & 0x1f0000ff0000ffull;
+    v = (v | v << 8) & 0x100f00f00f00f00full;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+    v = (v | v << 2) & 0x1249249249249249ull;
+    return v;
+}
+
+static uint32_t compact_bits3(uint64_t v) {
+    v &= 0x1249249249249249ull;
+    v = (v ^ (v >> 2)) & 0x10c30c30c30c30c3ull;
+    v = (v ^ (v >> 4)) & 0x100f00f00f00f00full;
+    v = (v ^ (v >> 8)) & 0x1f0000ff0000ffull;
+    v = (v ^ (v >> 16)) & 0x1f00000000ffffull;
+    v = (v ^ (v >> 32)) & 0x1fffff;
+    return static_cast<uint32_t>(v);
+}
+
+uint64_t morton3_encode(uint32_t x, uint32_t y, uint32_t z) {
+    return spread_bits3(x) | spread_bits3(y) << 1 | spread_bits3(z) << 2;
+}
+
+void morton3_decode(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) {
+    x = compact_bits3(code);
+    y = compact_bits3(code >> 1);
+    z = compact_bits3(code >> 2);
+}
+
+// ---------- BricksPack ----------
+
+std::shared_ptr<BricksPack> BricksPack::open(std::shared_ptr<MappedFile> file,
+                                             std::string* error_msg) {
+    const uint64_t size = static_cast<uint64_t>(file->size());
+    if (size < sizeof(PackHeader)) {
+        set_error(error_msg, "file too small for a bricks.pack header");
+        return nullptr;
+    }
+
+    std::shared_ptr<BricksPack> pack(new BricksPack());
+    PackHeader& h = pack->header_;
+    std::memcpy(&h, file->data(), sizeof(PackHeader));
+
+    if (std::memcmp(h.magic, kPackMagic, sizeof(kPackMagic)) != 0) {
+        set_error(error_msg, "not a bricks.pack (bad magic)");
+        return nullptr;
+    }
+    if (h.version != kPackVersion) {
+        set_error(error_msg, "unsupported bricks.pack version: " + std::to_string(h.version));
+        return nullptr;
+    }
+    if (h.header_bytes != sizeof(PackHeader)) {
+        set_error(error_msg, "header_bytes=" + std::to_string(h.header_bytes) + " != " +
+                             std::to_string(sizeof(PackHeader)));
+        return nullptr;
+    }
+    if (h.file_bytes != size) {
+        set_error(error_msg, "file_bytes=" + std::to_string(h.file_bytes) +
+                             " but file size is " + std::to_string(size) + " (truncated?)");
+        return nullptr;
+    }
+
+    // sections must lie inside the file; each bound is checked before use
+    auto in_file = [&](uint64_t offset, uint64_t count, uint64_t elem) {
+        return offset <= size && count <= (size - offset) / elem;
+    };
+    const uint64_t grid_max = 1u << 21;  // Morton code range
+    if (h.grid[0] > grid_max || h.grid[1] > grid_max || h.grid[2] > grid_max) {
+        set_error(error_msg, "brick grid too large");
+        return nullptr;
+    }
+    const uint64_t cells = static_cast<uint64_t>(h.grid[0]) * h.grid[1] * h.grid[2];
+    if (!in_file(h.manifest_offset, h.manifest_bytes, 1)) {
+        set_error(error_msg, "manifest section outside the file");
+        return nullptr;
+    }
+    if (h.directory_offset % alignof(PackDirEntry) != 0 ||
+        !in_file(h.directory_offset, h.brick_count, sizeof(PackDirEntry))) {
+        set_error(error_msg, "directory section misaligned or outside the file");
+        return nullptr;
+    }
+    if (h.slots_offset % alignof(uint32_t) != 0 ||
+        !in_file(h.slots_offset, cells, sizeof(uint32_t))) {
+        set_error(error_msg, "slot table misaligned or outside the file");
+        return nullptr;
+    }
+    if (h.data_offset % kPackAlignment != 0 || h.data_offset > size) {
+        set_error(error_msg, "data_offset misaligned or outside the file");
+        return nullptr;
+    }
+    if (h.brick_count > cells) {
+        set_error(error_msg, "brick_count=" + std::to_string(h.brick_count) +
+                             " exceeds the brick grid");
+        return nullptr;
+    }
+
+    pack->directory_ = reinterpret_cast<const PackDirEntry*>(file->data() + h.directory_offset);
+    pack->slots_ = reinterpret_cast<const uint32_t*>(file->data() + h.slots_offset);
+    pack->file_ = std::move(file);
+    return pack;
+}
+
+std::string_view BricksPack::manifest_json() const {
+    return {reinterpret_cast<const char*>(file_->data() + header_.manifest_offset),
+            static_cast<size_t>(header_.manifest_bytes)};
+}
+
+uint32_t BricksPack::slot(int bx, int by, int bz) const {
+    if (bx < 0 || by < 0 || bz < 0 || static_cast<uint32_t>(bx) >= header_.grid[0] ||
+        static_cast<uint32_t>(by) >= header_.grid[1] ||
+        static_cast<uint32_t>(bz) >= header_.grid[2]) {
+        return 0;
+    }
+    const uint64_t cell = (static_cast<uint64_t>(bz) * header_.grid[1] + by) * header_.grid[0] + bx;
+    return slots_[cell];
+}
+
+const PackDirEntry* BricksPack::find(int bx, int by, int bz) const {
+    const uint32_t s = slot(bx, by, bz);
+    if (s == 0 || s > header_.brick_count) return nullptr;
+    const PackDirEntry& e = directory_[s - 1];
+    // a stale slot never resolves to another brick
+    if (e.morton != morton3_encode(bx, by, bz)) return nullptr;
+    return &e;
+}
+
+const uint8_t* BricksPack::payload(const PackDirEntry& e) const {
+    if (e.encoding == static_cast<uint8_t>(PackEncoding::Constant)) return nullptr;
+    if (e.offset_bytes > static_cast<uint64_t>(file_->size()) ||
+        e.payload_bytes > static_cast<uint64_t>(file_->size()) - e.offset_bytes) {
+        return nullptr;
+    }
+    return file_->data() + e.offset_bytes;
+}
+
+// ---------- load ----------
+
+BricksPackResult load_bricks_pack(const std::string& path) {
+    BricksPackResult result;
+
+    std::string map_err;
+    auto file = MappedFile::open(path, &map_err);
+    if (!file) {
+        add_error(result, E2003, "Cannot open bricks pack: " + path + " (" + map_err + ")");
+        result.exit_code = ExitCode::IoError;
+        return result;
+    }
+
+    std::string pack_err;
+    auto pack = BricksPack::open(file, &pack_err);
+    if (!pack) {
+        add_error(result, E1101, "Invalid bricks.pack: " + pack_err, "bricks.pack");
+        result.exit_code = ExitCode::ValidationFailure;
+        return result;
+    }
+    const PackHeader& h = pack->header();
+
+    // --- manifest ---
+    auto mr = parse_manifest(pack->manifest_json());
+    if (!mr.ok) {
+        result.errors = std::move(mr.errors);
+        result.exit_code = mr.exit_code;
+        return result;
+    }
+    result.manifest = std::move(mr.manifest);
+    const Manifest& m = result.manifest;
+
+    // --- header vs manifest ---
+    if (static_cast<int>(h.brick_size) != m.brick_size) {
+        add_error(result, E1101,
+                  "brick_size mismatch: pack=" + std::to_string(h.brick_size) +
+                  " manifest=" + std::to_string(m.brick_size),
+                  "brick_size");
+    }
+    for (int i = 0; i < 3; ++i) {
+        const uint64_t expected = bricks_per_axis(m.dims[i], m.brick_size);
+        if (h.grid[i] != expected) {
+            add_error(result, E1101,
+                      "grid[" + std::to_string(i) + "]=" + std::to_string(h.grid[i]) +
+                      " != ceil(dims/brick_size)=" + std::to_string(expected),
+                      "bricks.pack");
+        }
+    }
+    if (!result.errors.empty()) {
+        result.exit_code = ExitCode::ValidationFailure;
+        return result;
+    }
+
+    // --- directory → BricksIndex ---
+    BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = m.brick_size;
+    idx.dtype = m.dtype;
+    idx.axis_order = m.axis_order;
+    idx.dims = m.dims;
+    idx.bricks.resize(pack->brick_count());
+
+    uint64_t prev_morton = 0;
+    for (size_t i = 0; i < pack->brick_count(); ++i) {
+        const PackDirEntry& d = pack->entry(i);
+        BrickEntry& e = idx.bricks[i];
+        auto prefix = [i] { return "bricks[" + std::to_string(i) + "]"; };
+
+        uint32_t x, y, z;
+        morton3_decode(d.morton, x, y, z);
+        e.bx = static_cast<int>(x);
+        e.by = static_cast<int>(y);
+        e.bz = static_cast<int>(z);
+        e.offset_bytes = static_cast<int64_t>(d.offset_bytes);
+        e.payload_bytes = d.payload_bytes;
+        // unknown ids stay visible in the encoding diagnostic
+        e.encoding = d.encoding < kEncodingCount ? std::string(kEncodingNames[d.encoding])
+                                                 : "#" + std::to_string(d.encoding);
+        if (d.flags & kPackHasCrc32) e.crc32 = to_hex8(d.crc32);
+        if (is_constant_encoding(e.encoding)) e.value = d.value;
+        if (d.flags & kPackHasRange) {
+            e.min = d.min;
+            e.max = d.max;
+        }
+        if (d.flags & kPackHasCrossesIso) e.crosses_iso = (d.flags & kPackCrossesIso) != 0;
+
+        // equal codes are duplicates, reported as E1102 below
+        if (i > 0 && d.morton < prev_morton) {
+            add_error(result, E1101, prefix() + " directory is not in Morton order", "bricks.pack");
+        }
+        prev_morton = d.morton;
+
+        if (pack->slot(e.bx, e.by, e.bz) != i + 1) {
+            // out-of-grid coordinates have no slot; let E1103 speak for them
+            if (x < h.grid[0] && y < h.grid[1] && z < h.grid[2]) {
+                add_error(result, E1101, prefix() + " slot table does not point back to it",
+                          "bricks.pack");
+            }
+        }
+        if (!is_constant_encoding(e.encoding) && d.offset_bytes % kPackAlignment != 0) {
+            add_error(result, E1101,
+                      prefix() + ".offset_bytes=" + std::to_string(d.offset_bytes) +
+                      " is not " + std::to_string(kPackAlignment) + "-byte aligned",
+                      "bricks.pack");
+        }
+    }
+
+    // --- same checks as bricks.index.json ---
+    auto ir = validate_bricks_index(std::move(idx), m);
+    result.index = std::move(ir.index);
+    result.errors.insert(result.errors.end(), ir.errors.begin(), ir.errors.end());
+
+    if (result.errors.empty()) {
+        result.ok = true;
+        result.exit_code = ExitCode::Success;
+    } else {
+        result.ok = false;
+        result.exit_code = ExitCode::ValidationFailure;
+    }
+
+    log_info("GENMESH_I0010", "bricks.pack loaded", {
+        {"path", path},
+        {"bricks", std::to_string(result.index.bricks.size())},
+    });
+    return result;
+}
+
+// ---------- write ----------
+
+bool write_bricks_pack(const std::string& path, std::string_view manifest_json,
+                       const Manifest& manifest, const BricksIndex& index,
+                       const std::string& bin_path, std::string* error_msg) {
+    const int B = manifest.brick_size;
+    uint32_t grid[3];
+    for (int i = 0; i < 3; ++i) {
+        const uint64_t n = bricks_per_axis(manifest.dims[i], B);
+        if (n == 0 || n > (1u << 21)) {
+            set_error(error_msg, "dims / brick_size out of range for a bricks.pack");
+            return false;
+        }
+        grid[i] = static_cast<uint32_t>(n);
+    }
+    const uint64_t cells = static_cast<uint64_t>(grid[0]) * grid[1] * grid[2];
+
+    // --- directory in Morton order ---
+    std::vector<size_t> order(index.bricks.size());
+    std::vector<PackDirEntry> dir(index.bricks.size());
+    for (size_t i = 0; i < index.bricks.size(); ++i) {
+        const BrickEntry& e = index.bricks[i];
+        if (e.bx < 0 || e.by < 0 || e.bz < 0 || static_cast<uint32_t>(e.bx) >= grid[0] ||
+            static_cast<uint32_t>(e.by) >= grid[1] || static_cast<uint32_t>(e.bz) >= grid[2]) {
+            set_error(error_msg, "bricks[" + std::to_string(i) + "] outside the brick grid");
+            return false;
+        }
+        if (e.payload_bytes < 0 || e.payload_bytes > UINT32_MAX) {
+            set_error(error_msg, "bricks[" + std::to_string(i) + "] payload_bytes out of range");
+            return false;
+        }
+        const int enc = encoding_id(e.encoding);
+        if (enc < 0) {
+            set_error(error_msg, "bricks[" + std::to_string(i) + "] unknown encoding: " + e.encoding);
+            return false;
+        }
+        PackDirEntry& d = dir[i];
+        d = {};
+        d.morton = morton3_encode(e.bx, e.by, e.bz);
+        d.payload_bytes = static_cast<uint32_t>(e.payload_bytes);
+        d.encoding = static_cast<uint8_t>(enc);
+        if (e.crc32) {
+            if (!parse_crc32_hex(*e.crc32, d.crc32)) {
+                set_error(error_msg,
+                          "bricks[" + std::to_string(i) + "] invalid crc32: " + *e.crc32);
+                return false;
+            }
+            d.flags |= kPackHasCrc32;
+        }
+        if (e.value) d.value = *e.value;
+        if (e.min && e.max) {
+            d.min = *e.min;
+            d.max = *e.max;
+            d.flags |= kPackHasRange;
+        }
+        if (e.crosses_iso) {
+            d.flags |= kPackHasCrossesIso;
+            if (*e.crosses_iso) d.flags |= kPackCrossesIso;
+        }
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return dir[a].morton < dir[b].morton; });
+
+    PackHeader h = {};
+    std::memcpy(h.magic, kPackMagic, sizeof(kPackMagic));
+    h.version = kPackVersion;
+    h.header_bytes = sizeof(PackHeader);
+    h.brick_size = static_cast<uint32_t>(B);
+    for (int i = 0; i < 3; ++i) h.grid[i] = grid[i];
+    h.manifest_offset = sizeof(PackHeader);
+    h.manifest_bytes = manifest_json.size();
+    h.directory_offset = align_up(h.manifest_offset + h.manifest_bytes, alignof(PackDirEntry));
+    h.brick_count = dir.size();
+    h.slots_offset = h.directory_offset + h.brick_count * sizeof(PackDirEntry);
+    h.data_offset = align_up(h.slots_offset + cells * sizeof(uint32_t), kPackAlignment);
+
+    // --- payload placement: one aligned copy per stored payload ---
+    std::unordered_map<int64_t, uint64_t> placed;  // bricks.bin offset -> pack offset
+    std::vector<size_t> writes;                     // index entries whose bytes get copied
+    uint64_t cursor = h.data_offset;
+    std::vector<PackDirEntry> sorted(dir.size());
+    std::vector<uint32_t> slots(static_cast<size_t>(cells), 0);
+    for (size_t k = 0; k < order.size(); ++k) {
+        const size_t i = order[k];
+        const BrickEntry& e = index.bricks[i];
+        PackDirEntry d = dir[i];
+        if (!is_constant_encoding(e.encoding)) {
+            auto [it, inserted] = placed.emplace(e.offset_bytes, cursor);
+            if (inserted) {
+                writes.push_back(i);
+                cursor = align_up(cursor + static_cast<uint64_t>(e.payload_bytes), kPackAlignment);
+            }
+            d.offset_bytes = it->second;
+        }
+        sorted[k] = d;
+        const uint64_t cell =
+            (static_cast<uint64_t>(e.bz) * grid[1] + e.by) * grid[0] + e.bx;
+        slots[static_cast<size_t>(cell)] = static_cast<uint32_t>(k + 1);
+    }
+    h.file_bytes = std::max(cursor, h.data_offset);
+
+    std::ifstream bin;
+    if (!writes.empty()) {
+        bin.open(bin_path, std::ios::binary);
+        if (!bin.is_open()) {
+            set_error(error_msg, "Cannot open bricks.bin: " + bin_path);
+            return false;
+        }
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        set_error(error_msg, "Cannot create bricks.pack: " + path);
+        return false;
+    }
+
+    auto pad_to = [&](uint64_t offset) {
+        static const char zeros[kPackAlignment] = {};
+        uint64_t pos = static_cast<uint64_t>(out.tellp());
+        while (pos < offset) {
+            const uint64_t n = std::min<uint64_t>(offset - pos, sizeof(zeros));
+            out.write(zeros, static_cast<std::streamsize>(n));
+            pos += n;
+        }
+    };
+
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(manifest_json.data(), static_cast<std::streamsize>(manifest_json.size()));
+    pad_to(h.directory_offset);
+    out.write(reinterpret_cast<const char*>(sorted.data()),
+              static_cast<std::streamsize>(sorted.size() * sizeof(PackDirEntry)));
+    out.write(reinterpret_cast<const char*>(slots.data()),
+              static_cast<std::streamsize>(slots.size() * sizeof(uint32_t)));
+
+    std::vector<char> buf;
+    for (size_t i : writes) {
+        const BrickEntry& e = index.bricks[i];
+        pad_to(placed.at(e.offset_bytes));
+        buf.resize(static_cast<size_t>(e.payload_bytes));
+        bin.seekg(e.offset_bytes);
+        bin.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!bin) {
+            set_error(error_msg, "Short read from bricks.bin at offset " +
+                                 std::to_string(e.offset_bytes));
+            return false;
+        }
+        out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    }
+    pad_to(h.file_bytes);
+
+    out.close();
+    if (!out) {
+        set_error(error_msg, "Write failed: " + path);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace genmesh
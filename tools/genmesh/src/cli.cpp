@@ -1,6 +1,8 @@
 #include "genmesh/cli.h"
 #include "genmesh/exit_code.h"
+#include "genmesh/tpms.h"
 
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <string_view>
@@ -11,10 +13,12 @@ namespace genmesh {
 void print_usage() {
     std::cerr <<
 R"(Usage: genmesh --manifest <path> --in <path> --out <dir> [options]
+       genmesh --pack <path> --out <dir> [options]
 
 Required:
   --manifest <path>       Path to manifest (project.json)
   --in <path>             Input directory containing bricks.bin + bricks.index.json
+  --pack <path>           Single-file bricks.pack (instead of --manifest / --in)
   --out <dir>             Output directory (created if missing)
 
 Options:
@@ -23,8 +27,23 @@ Options:
   --write-vdb             Write volume.vdb (default: false)
   --iso <float>           Iso-surface value (default: manifest.iso or 0.0)
   --adaptivity <float>    Mesh adaptivity 0.0-1.0 (default: manifest.adaptivity or 0.0)
+  --clip-bbox <box>       Mesh only x0,y0,z0..x1,y1,z1 (world mm); reads only bricks in it
   --force                 Overwrite existing output files
   --log-level <level>     error|warn|info|debug (default: info)
+  --read-mode <mode>      bricks.bin reader: stream|mmap|coalesced (default: stream)
+  --direct-io             Bypass the page cache (O_DIRECT); needs --read-mode coalesced
+  --crc-verify <mode>     CRC32 check: inline|background (default: inline)
+  --cull-bricks           Skip bricks whose index min/max keep them off the surface
+  --narrow-band           Keep only voxels near the surface active, flood-fill the sign
+  --half                  Keep f16 bricks in half precision; write volume.vdb as half
+  --shell <mm>            Hollow the part, keeping a wall of this thickness
+  --drain-hole <seg>      Drill x0,y0,z0..x1,y1,z1 (world mm) through the shell; repeatable
+  --drain-radius <mm>     Drain hole radius (default: 1.5)
+  --infill <surface>      Fill the shell with a TPMS lattice: gyroid|schwarz-p|diamond
+  --infill-cell <mm>      Lattice period (default: 8)
+  --infill-wall <mm>      Lattice wall thickness (default: 0.8)
+  --huge-pages            Back the decoded brick arena with transparent huge pages
+  --threads <n>           Worker threads, 0 = all cores (default: 0)
   --debug-generate <shape> Generate test distance field: sphere|box
   --help                  Show this help
 )";
@@ -41,6 +60,24 @@ static bool need_value(int i, int argc, const char* flag, ParseResult& result) {
     return true;
 }
 
+// helper: "x,y,z" -> three floats
+static bool parse_vec3(std::string_view text, std::array<float, 3>& out) {
+    for (int a = 0; a < 3; ++a) {
+        const size_t comma = text.find(',');
+        if ((a < 2) == (comma == std::string_view::npos)) return false;
+        const std::string item(text.substr(0, comma));
+        size_t used = 0;
+        try {
+            out[a] = std::stof(item, &used);
+        } catch (...) {
+            return false;
+        }
+        if (used != item.size()) return false;
+        text = a < 2 ? text.substr(comma + 1) : std::string_view{};
+    }
+    return true;
+}
+
 ParseResult parse_args(int argc, char* argv[]) {
     ParseResult result;
     result.ok = true;
@@ -53,6 +90,7 @@ ParseResult parse_args(int argc, char* argv[]) {
 
     bool has_manifest = false;
     bool has_in = false;
+    bool has_pack = false;
     bool has_out = false;
     bool explicit_write_stl = false;
 
@@ -74,6 +112,11 @@ ParseResult parse_args(int argc, char* argv[]) {
             result.args.in_dir = argv[++i];
             has_in = true;
         }
+        else if (arg == "--pack") {
+            if (!need_value(i, argc, "--pack", result)) return result;
+            result.args.pack_path = argv[++i];
+            has_pack = true;
+        }
         else if (arg == "--out") {
             if (!need_value(i, argc, "--out", result)) return result;
             result.args.out_dir = argv[++i];
@@ -101,6 +144,103 @@ ParseResult parse_args(int argc, char* argv[]) {
                 return result;
             }
         }
+        else if (arg == "--clip-bbox") {
+            if (!need_value(i, argc, "--clip-bbox", result)) return result;
+            const std::string_view val = argv[++i];
+            const size_t sep = val.find("..");
+            std::array<float, 3> lo{}, hi{};
+            bool ok = sep != std::string_view::npos && parse_vec3(val.substr(0, sep), lo) &&
+                      parse_vec3(val.substr(sep + 2), hi);
+            for (int a = 0; ok && a < 3; ++a) ok = lo[a] < hi[a];
+            if (!ok) {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid value for --clip-bbox: " + std::string(val) +
+                                   " (expected x0,y0,z0..x1,y1,z1 with min < max)";
+                return result;
+            }
+            result.args.clip_min = lo;
+            result.args.clip_max = hi;
+        }
+        else if (arg == "--shell") {
+            if (!need_value(i, argc, "--shell", result)) return result;
+            float val = 0.0f;
+            try {
+                val = std::stof(argv[++i]);
+            } catch (...) {
+                val = 0.0f;
+            }
+            if (!(val > 0.0f) || !std::isfinite(val)) {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid value for --shell (expected thickness_mm > 0)";
+                return result;
+            }
+            result.args.shell_mm = val;
+        }
+        else if (arg == "--drain-hole") {
+            if (!need_value(i, argc, "--drain-hole", result)) return result;
+            const std::string_view val = argv[++i];
+            const size_t sep = val.find("..");
+            DrainSegment seg{};
+            if (sep == std::string_view::npos || !parse_vec3(val.substr(0, sep), seg.from) ||
+                !parse_vec3(val.substr(sep + 2), seg.to)) {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid value for --drain-hole: " + std::string(val) +
+                                   " (expected x0,y0,z0..x1,y1,z1)";
+                return result;
+            }
+            result.args.drain_holes.push_back(seg);
+        }
+        else if (arg == "--drain-radius") {
+            if (!need_value(i, argc, "--drain-radius", result)) return result;
+            float val = 0.0f;
+            try {
+                val = std::stof(argv[++i]);
+            } catch (...) {
+                val = 0.0f;
+            }
+            if (!(val > 0.0f) || !std::isfinite(val)) {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid value for --drain-radius (expected radius_mm > 0)";
+                return result;
+            }
+            result.args.drain_radius_mm = val;
+        }
+        else if (arg == "--infill") {
+            if (!need_value(i, argc, "--infill", result)) return result;
+            std::string val = argv[++i];
+            TpmsSurface surface;
+            if (!parse_tpms_surface(val, surface)) {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg =
+                    "Invalid infill surface: " + val + " (expected gyroid|schwarz-p|diamond)";
+                return result;
+            }
+            result.args.infill = val;
+        }
+        else if (arg == "--infill-cell" || arg == "--infill-wall") {
+            const std::string flag(arg);
+            if (!need_value(i, argc, flag.c_str(), result)) return result;
+            float val = 0.0f;
+            try {
+                val = std::stof(argv[++i]);
+            } catch (...) {
+                val = 0.0f;
+            }
+            if (!(val > 0.0f) || !std::isfinite(val)) {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid value for " + flag + " (expected mm > 0)";
+                return result;
+            }
+            float& dst = arg == "--infill-cell" ? result.args.infill_cell_mm
+                                                : result.args.infill_wall_mm;
+            dst = val;
+        }
         else if (arg == "--adaptivity") {
             if (!need_value(i, argc, "--adaptivity", result)) return result;
             try {
@@ -126,6 +266,60 @@ ParseResult parse_args(int argc, char* argv[]) {
             }
             result.args.log_level = val;
         }
+        else if (arg == "--read-mode") {
+            if (!need_value(i, argc, "--read-mode", result)) return result;
+            std::string val = argv[++i];
+            if (val != "stream" && val != "mmap" && val != "coalesced") {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid read mode: " + val + " (expected stream|mmap|coalesced)";
+                return result;
+            }
+            result.args.read_mode = val;
+        }
+        else if (arg == "--direct-io") {
+            result.args.direct_io = true;
+        }
+        else if (arg == "--huge-pages") {
+            result.args.huge_pages = true;
+        }
+        else if (arg == "--cull-bricks") {
+            result.args.cull_bricks = true;
+        }
+        else if (arg == "--narrow-band") {
+            result.args.narrow_band = true;
+        }
+        else if (arg == "--half") {
+            result.args.half = true;
+        }
+        else if (arg == "--crc-verify") {
+            if (!need_value(i, argc, "--crc-verify", result)) return result;
+            std::string val = argv[++i];
+            if (val != "inline" && val != "background") {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid CRC verify mode: " + val + " (expected inline|background)";
+                return result;
+            }
+            result.args.crc_verify = val;
+        }
+        else if (arg == "--threads") {
+            if (!need_value(i, argc, "--threads", result)) return result;
+            const std::string val = argv[++i];
+            size_t used = 0;
+            try {
+                result.args.threads = std::stoi(val, &used);
+            } catch (...) {
+                result.args.threads = -1;
+            }
+            if (used != val.size()) result.args.threads = -1;  // e.g. "4abc"
+            if (result.args.threads < 0) {
+                result.ok = false;
+                result.exit_code = static_cast<int>(ExitCode::General);
+                result.error_msg = "Invalid value for --threads";
+                return result;
+            }
+        }
         else if (arg == "--debug-generate") {
             if (!need_value(i, argc, "--debug-generate", result)) return result;
             std::string val = argv[++i];
@@ -145,6 +339,34 @@ ParseResult parse_args(int argc, char* argv[]) {
         }
     }
 
+    if (!result.args.drain_holes.empty() && !result.args.shell_mm) {
+        result.ok = false;
+        result.exit_code = static_cast<int>(ExitCode::General);
+        result.error_msg = "--drain-hole requires --shell";
+        return result;
+    }
+
+    if (!result.args.infill.empty() && !result.args.shell_mm) {
+        result.ok = false;
+        result.exit_code = static_cast<int>(ExitCode::General);
+        result.error_msg = "--infill requires --shell";
+        return result;
+    }
+
+    if (result.args.infill_wall_mm >= result.args.infill_cell_mm) {
+        result.ok = false;
+        result.exit_code = static_cast<int>(ExitCode::General);
+        result.error_msg = "--infill-wall must be smaller than --infill-cell";
+        return result;
+    }
+
+    if (result.args.direct_io && result.args.read_mode != "coalesced") {
+        result.ok = false;
+        result.exit_code = static_cast<int>(ExitCode::General);
+        result.error_msg = "--direct-io requires --read-mode coalesced";
+        return result;
+    }
+
     // --debug-generate relaxes required args (manifest/in not needed)
     if (!result.args.debug_generate.empty()) {
         if (!has_out) {
@@ -156,6 +378,23 @@ ParseResult parse_args(int argc, char* argv[]) {
         return result;
     }
 
+    // bricks.pack carries the manifest and index itself
+    if (has_pack) {
+        if (has_manifest || has_in) {
+            result.ok = false;
+            result.exit_code = static_cast<int>(ExitCode::General);
+            result.error_msg = "--pack cannot be combined with --manifest / --in";
+            return result;
+        }
+        if (!has_out) {
+            result.ok = false;
+            result.exit_code = static_cast<int>(ExitCode::ValidationFailure);
+            result.error_msg = "Missing required argument: --out";
+            return result;
+        }
+        return result;
+    }
+
     // Validate required args
     if (!has_manifest || !has_in || !has_out) {
         result.ok = false;
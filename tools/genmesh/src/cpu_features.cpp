@@ -0,0 +1,79 @@
+#include "genmesh/cpu_features.h"
+
+#include <cstdint>
+
+#if GENMESH_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace genmesh {
+
+#if GENMESH_X86
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#ifdef _MSC_VER
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static uint64_t xgetbv0() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+static CpuFeatures detect() {
+    CpuFeatures f;
+
+    uint32_t r[4];
+    cpuid(0, 0, r);
+    const uint32_t max_leaf = r[0];
+    if (max_leaf < 1) return f;
+
+    cpuid(1, 0, r);
+    const uint32_t ecx1 = r[2];
+    f.sse41  = (ecx1 >> 19) & 1;
+    f.pclmul = (ecx1 >> 1) & 1;
+
+    // AVX state must be enabled by the OS (OSXSAVE + XCR0 bits).
+    const bool osxsave = (ecx1 >> 27) & 1;
+    const bool avx = (ecx1 >> 28) & 1;
+    const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    const bool ymm_ok = avx && (xcr0 & 0x6) == 0x6;
+    const bool zmm_ok = ymm_ok && (xcr0 & 0xE0) == 0xE0;
+
+    f.f16c = ymm_ok && ((ecx1 >> 29) & 1);
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, r);
+        const uint32_t ebx7 = r[1];
+        f.avx2    = ymm_ok && ((ebx7 >> 5) & 1);
+        f.avx512f = zmm_ok && ((ebx7 >> 16) & 1);
+    }
+    return f;
+}
+
+#else
+
+static CpuFeatures detect() { return {}; }
+
+#endif
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+}  // namespace genmesh
@@ -0,0 +1,245 @@
+#include "genmesh/crc32.h"
+#include "genmesh/cpu_features.h"
+
+#include <charconv>
+#include <cstring>
+
+#if GENMESH_X86
+#include <immintrin.h>
+#endif
+
+namespace genmesh {
+
+// ---------- slice-by-16 ----------
+
+namespace {
+
+/// T[0] is the classic byte table; T[k][i] advances T[k-1][i] by one more
+/// zero byte, so 16 input bytes resolve with 16 independent lookups.
+struct Crc32Tables {
+    uint32_t t[16][256];
+};
+
+constexpr Crc32Tables make_tables() {
+    Crc32Tables tab{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+        }
+        tab.t[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int k = 1; k < 16; ++k) {
+            const uint32_t prev = tab.t[k - 1][i];
+            tab.t[k][i] = (prev >> 8) ^ tab.t[0][prev & 0xFF];
+        }
+    }
+    return tab;
+}
+
+constexpr Crc32Tables kTables = make_tables();
+
+static_assert(kTables.t[0][1] == 0x77073096u, "CRC32 table mismatch");
+
+inline uint32_t load_le32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));  // little-endian host assumed (as bricks.bin)
+    return v;
+}
+
+}  // namespace
+
+/// Operates on the inverted register (no pre/post conditioning).
+static uint32_t crc32_slice16_raw(const uint8_t* p, size_t len, uint32_t crc) {
+    const auto& T = kTables.t;
+
+    while (len >= 16) {
+        const uint32_t a = load_le32(p) ^ crc;
+        const uint32_t b = load_le32(p + 4);
+        const uint32_t c = load_le32(p + 8);
+        const uint32_t d = load_le32(p + 12);
+        crc = T[15][a & 0xFF] ^ T[14][(a >> 8) & 0xFF] ^ T[13][(a >> 16) & 0xFF] ^ T[12][a >> 24] ^
+              T[11][b & 0xFF] ^ T[10][(b >> 8) & 0xFF] ^ T[9][(b >> 16) & 0xFF]  ^ T[8][b >> 24] ^
+              T[7][c & 0xFF]  ^ T[6][(c >> 8) & 0xFF]  ^ T[5][(c >> 16) & 0xFF]  ^ T[4][c >> 24] ^
+              T[3][d & 0xFF]  ^ T[2][(d >> 8) & 0xFF]  ^ T[1][(d >> 16) & 0xFF]  ^ T[0][d >> 24];
+        p += 16;
+        len -= 16;
+    }
+    while (len--) {
+        crc = T[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// ---------- PCLMULQDQ folding ----------
+
+#if GENMESH_X86
+
+// Folding per Gopal et al., "Fast CRC Computation for Generic Polynomials
+// Using PCLMULQDQ Instruction" (Intel, 2009), bit-reflected constants for
+// the zlib polynomial. Requires len >= 64 and len % 16 == 0; operates on the
+// inverted register like crc32_slice16_raw().
+GENMESH_TARGET("pclmul,sse4.1")
+static uint32_t crc32_pclmul_raw(const uint8_t* buf, size_t len, uint32_t crc) {
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    buf += 64;
+    len -= 64;
+
+    // Fold four 128-bit lanes in parallel, 64 bytes per step.
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the four lanes into one.
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Remaining 16-byte blocks.
+    while (len >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        buf += 16;
+        len -= 16;
+    }
+
+    // 128 → 64 bits.
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits.
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+#endif
+
+// ---------- dispatch ----------
+
+static Crc32Kernel resolve_auto() {
+    static const Crc32Kernel best = crc32_kernel_supported(Crc32Kernel::Pclmul)
+                                        ? Crc32Kernel::Pclmul
+                                        : Crc32Kernel::Slice16;
+    return best;
+}
+
+bool crc32_kernel_supported(Crc32Kernel kernel) {
+    switch (kernel) {
+        case Crc32Kernel::Auto:
+        case Crc32Kernel::Slice16:
+            return true;
+        case Crc32Kernel::Pclmul:
+#if GENMESH_X86
+            return cpu_features().pclmul && cpu_features().sse41;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* crc32_kernel_name() {
+    return resolve_auto() == Crc32Kernel::Pclmul ? "pclmul" : "slice16";
+}
+
+uint32_t crc32(const void* data, size_t len, uint32_t crc, Crc32Kernel kernel) {
+    if (kernel == Crc32Kernel::Auto) {
+        kernel = resolve_auto();
+    } else if (!crc32_kernel_supported(kernel)) {
+        kernel = Crc32Kernel::Slice16;
+    }
+
+    const auto* p = static_cast<const uint8_t*>(data);
+    uint32_t state = ~crc;
+
+#if GENMESH_X86
+    if (kernel == Crc32Kernel::Pclmul && len >= 64) {
+        const size_t chunk = len & ~static_cast<size_t>(15);
+        state = crc32_pclmul_raw(p, chunk, state);
+        p += chunk;
+        len -= chunk;
+    }
+#endif
+
+    state = crc32_slice16_raw(p, len, state);
+    return ~state;
+}
+
+bool parse_crc32_hex(std::string_view hex, uint32_t& out) {
+    // from_chars takes no sign, prefix or whitespace for unsigned types; the
+    // length check rejects short values and anything wider than 32 bits
+    if (hex.size() != 8) return false;
+    uint32_t v = 0;
+    const char* end = hex.data() + hex.size();
+    auto [ptr, ec] = std::from_chars(hex.data(), end, v, 16);
+    if (ec != std::errc() || ptr != end) return false;
+    out = v;
+    return true;
+}
+
+}  // namespace genmesh
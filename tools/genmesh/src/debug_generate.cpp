@@ -1,9 +1,11 @@
 #include "genmesh/debug_generate.h"
+#include "genmesh/brick_arena.h"
 #include "genmesh/error_code.h"
 #include "genmesh/log.h"
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -37,25 +39,11 @@ static float sdf_box(float x, float y, float z,
 
 // ---------- generate ----------
 
-DebugGenerateResult debug_generate(const std::string& shape,
-                                   int dims,
-                                   float voxel_size) {
-    DebugGenerateResult result;
-
-    if (shape != "sphere" && shape != "box") {
-        result.ok = false;
-        result.exit_code = ExitCode::General;
-        result.error_msg = "Unknown debug shape: " + shape;
-        log_error(E9001, result.error_msg);
-        return result;
-    }
-
-    const int B = 64;  // brick size
-    const int N = dims; // grid dims per axis (assume cubic)
+Manifest debug_manifest(int dims, float voxel_size) {
+    const int N = dims;  // grid dims per axis (assume cubic)
     const float vs = voxel_size;
 
-    // --- Build manifest ---
-    auto& m = result.manifest;
+    Manifest m;
     m.version = 1;
     m.handedness = "right";
     m.up_axis = "Y";
@@ -71,9 +59,34 @@ DebugGenerateResult debug_generate(const std::string& shape,
     m.iso = 0.0f;
     m.adaptivity = 0.0f;
     m.half_width_voxels = 3;
-    m.brick_size = B;
+    m.brick_size = 64;
     m.dtype = "f32";
     m.background_value_mm = 1000.0f;
+    return m;
+}
+
+/// Generate the bricks of `shape` one at a time and hand each to `emit`.
+/// With `arena`, each brick is computed into an arena slot (a view with the
+/// slot as keepalive) instead of its own vector.
+static DebugGenerateResult generate(const std::string& shape, int dims, float voxel_size,
+                                    BrickArena* arena,
+                                    const std::function<void(BrickData&&)>& emit) {
+    DebugGenerateResult result;
+
+    if (shape != "sphere" && shape != "box") {
+        result.ok = false;
+        result.exit_code = ExitCode::General;
+        result.error_msg = "Unknown debug shape: " + shape;
+        log_error(E9001, result.error_msg);
+        return result;
+    }
+
+    // --- Build manifest ---
+    result.manifest = debug_manifest(dims, voxel_size);
+    const auto& m = result.manifest;
+    const int B = m.brick_size;
+    const int N = dims;
+    const float vs = voxel_size;
 
     // --- SDF parameters ---
     const float extent = N * vs;
@@ -105,7 +118,18 @@ DebugGenerateResult debug_generate(const std::string& shape,
                 // Actual voxels in this brick (handle boundary bricks)
                 const int local_B = B;  // always dense B^3
 
-                bd.values.resize(static_cast<size_t>(local_B) * local_B * local_B);
+                const size_t voxels = static_cast<size_t>(local_B) * local_B * local_B;
+                float* dst;
+                if (arena) {
+                    auto slot = arena->acquire();
+                    dst = static_cast<float*>(slot.get());
+                    bd.view = dst;
+                    bd.view_size = voxels;
+                    bd.keepalive = std::move(slot);
+                } else {
+                    bd.values.resize(voxels);
+                    dst = bd.values.data();
+                }
 
                 bool all_background = true;
                 const float band = m.half_width_voxels * vs;
@@ -144,14 +168,15 @@ DebugGenerateResult debug_generate(const std::string& shape,
 
                             // x-fastest: index = lx + B*(ly + B*lz)
                             size_t idx = static_cast<size_t>(lx + local_B * (ly + local_B * lz));
-                            bd.values[idx] = d;
+                            dst[idx] = d;
                         }
                     }
                 }
 
                 // Sparse optimization: skip all-background bricks
                 if (!all_background) {
-                    result.bricks.push_back(std::move(bd));
+                    emit(std::move(bd));
+                    ++result.brick_count;
                 }
             }
         }
@@ -159,7 +184,7 @@ DebugGenerateResult debug_generate(const std::string& shape,
 
     log_info("GENMESH_I0001", "debug-generate complete", {
         {"total_bricks", std::to_string(bricks_per_axis * bricks_per_axis * bricks_per_axis)},
-        {"active_bricks", std::to_string(result.bricks.size())},
+        {"active_bricks", std::to_string(result.brick_count)},
     });
 
     result.ok = true;
@@ -167,4 +192,25 @@ DebugGenerateResult debug_generate(const std::string& shape,
     return result;
 }
 
+DebugGenerateResult debug_generate(const std::string& shape,
+                                   int dims,
+                                   float voxel_size) {
+    std::vector<BrickData> bricks;
+    auto result = generate(shape, dims, voxel_size, nullptr,
+                           [&](BrickData&& bd) { bricks.push_back(std::move(bd)); });
+    result.bricks = std::move(bricks);
+    return result;
+}
+
+DebugGenerateResult debug_generate(const std::string& shape,
+                                   int dims,
+                                   float voxel_size,
+                                   const BrickSink& sink) {
+    // Bricks are emitted one at a time from this thread, so a single slot
+    // is recycled for the whole grid.
+    const int B = debug_manifest(dims, voxel_size).brick_size;
+    auto arena = BrickArena::create(static_cast<size_t>(B) * B * B * sizeof(float), 1);
+    return generate(shape, dims, voxel_size, arena.get(), [&](BrickData&& bd) { sink(bd); });
+}
+
 }  // namespace genmesh
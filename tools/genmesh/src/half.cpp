@@ -0,0 +1,160 @@
+#include "genmesh/half.h"
+#include "genmesh/cpu_features.h"
+
+#include <cstring>
+
+#if GENMESH_X86
+#include <immintrin.h>
+#endif
+
+namespace genmesh {
+
+// ---------- scalar ----------
+
+float half_to_float(uint16_t h) {
+    // Shift exponent+mantissa into place and rebias; only Inf/NaN and
+    // denormals need a fix-up, so there is no per-bit normalization loop.
+    uint32_t f = static_cast<uint32_t>(h & 0x7FFF) << 13;
+    const uint32_t exp = f & (0x1Fu << 23);
+    f += (127 - 15) << 23;
+
+    if (exp == (0x1Fu << 23)) {
+        // inf or NaN: exponent all ones, payload kept as-is
+        f += (128 - 16) << 23;
+    } else if (exp == 0) {
+        // zero / denormal: renormalize exactly via float subtraction
+        f += 1 << 23;
+        float tmp;
+        std::memcpy(&tmp, &f, sizeof(float));
+        tmp -= 6.103515625e-05f;  // 2^-14
+        std::memcpy(&f, &tmp, sizeof(float));
+    }
+
+    f |= static_cast<uint32_t>(h & 0x8000) << 16;
+
+    float result;
+    std::memcpy(&result, &f, sizeof(float));
+    return result;
+}
+
+static void convert_scalar(const uint16_t* src, float* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = half_to_float(src[i]);
+    }
+}
+
+// ---------- x86 SIMD ----------
+
+#if GENMESH_X86
+
+// VCVTPH2PS quiets signaling NaNs; lanes holding a NaN are patched with the
+// exact bit pattern half_to_float() produces.
+
+GENMESH_TARGET("avx2,f16c")
+static void convert_f16c(const uint16_t* src, float* dst, size_t count) {
+    const __m256i abs_mask  = _mm256_set1_epi32(0x7FFF);
+    const __m256i inf_half  = _mm256_set1_epi32(0x7C00);
+    const __m256i sign_mask = _mm256_set1_epi32(0x8000);
+    const __m256i mant_mask = _mm256_set1_epi32(0x03FF);
+    const __m256i exp_f32   = _mm256_set1_epi32(0x7F800000);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m256 f = _mm256_cvtph_ps(h);
+
+        const __m256i h32 = _mm256_cvtepu16_epi32(h);
+        const __m256i is_nan = _mm256_cmpgt_epi32(_mm256_and_si256(h32, abs_mask), inf_half);
+        if (!_mm256_testz_si256(is_nan, is_nan)) {
+            const __m256i nan_bits = _mm256_or_si256(
+                _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(h32, sign_mask), 16), exp_f32),
+                _mm256_slli_epi32(_mm256_and_si256(h32, mant_mask), 13));
+            f = _mm256_blendv_ps(f, _mm256_castsi256_ps(nan_bits), _mm256_castsi256_ps(is_nan));
+        }
+        _mm256_storeu_ps(dst + i, f);
+    }
+    convert_scalar(src + i, dst + i, count - i);
+}
+
+GENMESH_TARGET("avx512f")
+static void convert_avx512(const uint16_t* src, float* dst, size_t count) {
+    const __m512i abs_mask  = _mm512_set1_epi32(0x7FFF);
+    const __m512i inf_half  = _mm512_set1_epi32(0x7C00);
+    const __m512i sign_mask = _mm512_set1_epi32(0x8000);
+    const __m512i mant_mask = _mm512_set1_epi32(0x03FF);
+    const __m512i exp_f32   = _mm512_set1_epi32(0x7F800000);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m512 f = _mm512_cvtph_ps(h);
+
+        const __m512i h32 = _mm512_cvtepu16_epi32(h);
+        const __mmask16 is_nan = _mm512_cmpgt_epi32_mask(_mm512_and_si512(h32, abs_mask), inf_half);
+        if (is_nan) {
+            const __m512i nan_bits = _mm512_or_si512(
+                _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(h32, sign_mask), 16), exp_f32),
+                _mm512_slli_epi32(_mm512_and_si512(h32, mant_mask), 13));
+            f = _mm512_mask_mov_ps(f, is_nan, _mm512_castsi512_ps(nan_bits));
+        }
+        _mm512_storeu_ps(dst + i, f);
+    }
+    convert_scalar(src + i, dst + i, count - i);
+}
+
+#endif
+
+// ---------- dispatch ----------
+
+static HalfKernel resolve_auto() {
+    static const HalfKernel best = [] {
+        if (half_kernel_supported(HalfKernel::Avx512)) return HalfKernel::Avx512;
+        if (half_kernel_supported(HalfKernel::F16C)) return HalfKernel::F16C;
+        return HalfKernel::Scalar;
+    }();
+    return best;
+}
+
+bool half_kernel_supported(HalfKernel kernel) {
+    switch (kernel) {
+        case HalfKernel::Auto:
+        case HalfKernel::Scalar:
+            return true;
+#if GENMESH_X86
+        case HalfKernel::F16C:
+            return cpu_features().f16c && cpu_features().avx2;
+        case HalfKernel::Avx512:
+            return cpu_features().avx512f;
+#else
+        default:
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* half_kernel_name() {
+    switch (resolve_auto()) {
+        case HalfKernel::Avx512: return "avx512";
+        case HalfKernel::F16C:   return "f16c";
+        default:                 return "scalar";
+    }
+}
+
+void half_to_float_n(const uint16_t* src, float* dst, size_t count, HalfKernel kernel) {
+    if (kernel == HalfKernel::Auto) {
+        kernel = resolve_auto();
+    } else if (!half_kernel_supported(kernel)) {
+        kernel = HalfKernel::Scalar;
+    }
+
+    switch (kernel) {
+#if GENMESH_X86
+        case HalfKernel::Avx512: convert_avx512(src, dst, count); return;
+        case HalfKernel::F16C:   convert_f16c(src, dst, count); return;
+#endif
+        default:                 convert_scalar(src, dst, count); return;
+    }
+}
+
+}  // namespace genmesh
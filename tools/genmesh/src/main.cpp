@@ -1,11 +1,19 @@
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include <tbb/global_control.h>
+
 #include "genmesh/bricks_data.h"
 #include "genmesh/bricks_index.h"
+#include "genmesh/bricks_pack.h"
 #include "genmesh/cli.h"
 #include "genmesh/debug_generate.h"
 #include "genmesh/error_code.h"
@@ -61,9 +69,18 @@ int main(int argc, char* argv[]) {
     // Set global log level
     min_log_level() = parse_log_level(args.log_level);
 
+    // Cap the TBB pool (brick decode, OpenVDB tools) if requested
+    std::unique_ptr<tbb::global_control> thread_limit;
+    if (args.threads > 0) {
+        thread_limit = std::make_unique<tbb::global_control>(
+            tbb::global_control::max_allowed_parallelism,
+            static_cast<size_t>(args.threads));
+    }
+
     log_info("GENMESH_I0000", "genmesh v0.1.0 starting", {
         {"manifest", args.manifest_path},
         {"in", args.in_dir},
+        {"pack", args.pack_path},
         {"out", args.out_dir},
     });
 
@@ -74,6 +91,7 @@ int main(int argc, char* argv[]) {
     report.stage = Stage::Write;  // updated on failure
     report.inputs.manifest_path = args.manifest_path;
     report.inputs.in_dir = args.in_dir;
+    report.inputs.bricks_path = args.pack_path;
 
     // ---- 2. Prepare output directory ----
     auto out_res = prepare_output_dir(args.out_dir, args.write_stl, args.write_vdb, args.force);
@@ -84,9 +102,35 @@ int main(int argc, char* argv[]) {
 
     fs::path out_dir(args.out_dir);
 
-    // ---- 3. Acquire manifest + brick data ----
+    // OpenVDB comes first: bricks go into the grid as they are produced (3)
+    if (!vdb_init()) {
+        fail_report(report, Stage::VdbBuild, std::string(E3001),
+                    "env", "openvdb::initialize() failed");
+        try_write_report(report, out_dir, total_timer);
+        return static_cast<int>(ExitCode::EnvironmentError);
+    }
+    VdbBuildOptions vdb_opts;
+    vdb_opts.narrow_band = args.narrow_band;
+
+    // ---- 3. Acquire manifest + stream bricks into the grid ----
+    // Each brick is inserted as soon as it is read (or generated) and then
+    // released, so the bricks are never all resident next to the grid.
     Manifest manifest;
-    std::vector<BrickData> bricks;
+    std::unique_ptr<VdbStreamBuilder> builder;
+    auto add_brick = [&builder](const BrickData& bd) { builder->add(bd); };
+
+    // --clip-bbox: region of interest in world mm
+    std::optional<WorldBox> clip_box;
+    if (args.clip_min && args.clip_max) {
+        clip_box = WorldBox{*args.clip_min, *args.clip_max};
+        report.stats.has_clip = true;
+        report.stats.clip_min = *args.clip_min;
+        report.stats.clip_max = *args.clip_max;
+    }
+
+    // --crc-verify background: CRC32 runs alongside the VDB build (joined in 4)
+    BricksIndex bricks_index;
+    std::future<BricksDataResult> crc_job;
 
     {
         ScopedTimer validate_timer;
@@ -96,7 +140,10 @@ int main(int argc, char* argv[]) {
                 {"shape", args.debug_generate},
             });
 
-            auto dg = debug_generate(args.debug_generate);
+            manifest = debug_manifest();
+            builder = std::make_unique<VdbStreamBuilder>(manifest, vdb_opts);
+            auto dg = debug_generate(args.debug_generate, manifest.dims[0],
+                                     manifest.voxel_size, add_brick);
             if (!dg.ok) {
                 log_error(E9001, dg.error_msg);
                 fail_report(report, Stage::Validate, std::string(E9001),
@@ -104,31 +151,53 @@ int main(int argc, char* argv[]) {
                 try_write_report(report, out_dir, total_timer);
                 return static_cast<int>(dg.exit_code);
             }
-            manifest = std::move(dg.manifest);
-            bricks = std::move(dg.bricks);
 
             report.timing_ms.validate = validate_timer.elapsed_ms();
             // debug-generate has no read phase
             report.timing_ms.read = 0.0;
         } else {
-            // 3a. Load manifest
-            auto mr = load_manifest(args.manifest_path);
-            if (!mr.ok) {
-                for (const auto& e : mr.errors) {
-                    log_error(e.code, e.message, {{"field", e.field}});
-                    report.errors.push_back({e.code, e.message, "validation",
-                                             "", {{"field", e.field}}, ""});
+            // 3a. Load manifest (bricks.pack: manifest + index in one go)
+            BricksIndex idx;
+            std::string bin_path;
+            if (!args.pack_path.empty()) {
+                auto pr = load_bricks_pack(args.pack_path);
+                if (!pr.ok) {
+                    for (const auto& e : pr.errors) {
+                        log_error(e.code, e.message, {{"field", e.field}});
+                        report.errors.push_back({e.code, e.message, "validation",
+                                                 "", {{"field", e.field}}, ""});
+                    }
+                    report.status = "failure";
+                    report.stage = Stage::Validate;
+                    report.has_progress = true;
+                    report.progress.stage = Stage::Validate;
+                    try_write_report(report, out_dir, total_timer);
+                    return static_cast<int>(pr.exit_code);
                 }
-                report.status = "failure";
-                report.stage = Stage::Validate;
-                report.has_progress = true;
-                report.progress.stage = Stage::Validate;
-                try_write_report(report, out_dir, total_timer);
-                return static_cast<int>(mr.exit_code);
+                manifest = std::move(pr.manifest);
+                idx = std::move(pr.index);
+                bin_path = args.pack_path;
+            } else {
+                auto mr = load_manifest(args.manifest_path);
+                if (!mr.ok) {
+                    for (const auto& e : mr.errors) {
+                        log_error(e.code, e.message, {{"field", e.field}});
+                        report.errors.push_back({e.code, e.message, "validation",
+                                                 "", {{"field", e.field}}, ""});
+                    }
+                    report.status = "failure";
+                    report.stage = Stage::Validate;
+                    report.has_progress = true;
+                    report.progress.stage = Stage::Validate;
+                    try_write_report(report, out_dir, total_timer);
+                    return static_cast<int>(mr.exit_code);
+                }
+                manifest = std::move(mr.manifest);
             }
-            manifest = std::move(mr.manifest);
 
-            // Apply CLI overrides
+            // Apply CLI overrides (crosses_iso summaries refer to the file's iso;
+            // --cull-bricks classifies from min/max against the overridden one)
+            const float summary_iso = manifest.iso;
             if (args.iso.has_value()) manifest.iso = args.iso.value();
             if (args.adaptivity.has_value()) manifest.adaptivity = args.adaptivity.value();
 
@@ -137,25 +206,71 @@ int main(int argc, char* argv[]) {
             // 3b. Load bricks index + binary
             ScopedTimer read_timer;
 
-            auto idx_path = (fs::path(args.in_dir) / "bricks.index.json").string();
-            auto ir = load_bricks_index(idx_path, manifest);
-            if (!ir.ok) {
-                for (const auto& e : ir.errors) {
-                    log_error(e.code, e.message, {{"field", e.field}});
-                    report.errors.push_back({e.code, e.message, "validation",
-                                             "", {{"field", e.field}}, ""});
+            if (args.pack_path.empty()) {
+                auto idx_path = (fs::path(args.in_dir) / "bricks.index.json").string();
+                auto ir = load_bricks_index(idx_path, manifest);
+                if (!ir.ok) {
+                    for (const auto& e : ir.errors) {
+                        log_error(e.code, e.message, {{"field", e.field}});
+                        report.errors.push_back({e.code, e.message, "validation",
+                                                 "", {{"field", e.field}}, ""});
+                    }
+                    report.status = "failure";
+                    report.stage = Stage::Read;
+                    report.has_progress = true;
+                    report.progress.stage = Stage::Read;
+                    report.timing_ms.read = read_timer.elapsed_ms();
+                    try_write_report(report, out_dir, total_timer);
+                    return static_cast<int>(ir.exit_code);
                 }
-                report.status = "failure";
-                report.stage = Stage::Read;
-                report.has_progress = true;
-                report.progress.stage = Stage::Read;
-                report.timing_ms.read = read_timer.elapsed_ms();
-                try_write_report(report, out_dir, total_timer);
-                return static_cast<int>(ir.exit_code);
+                idx = std::move(ir.index);
+                bin_path = (fs::path(args.in_dir) / "bricks.bin").string();
+            }
+
+            // 3c. --clip-bbox: only bricks touching the region are read. The
+            // margin keeps the band the offset, the shell erosion and the
+            // mesher look at.
+            if (clip_box) {
+                const int margin = clip_margin_voxels(manifest, args.shell_mm.value_or(0.0f));
+                auto cs = clip_bricks_index(idx, manifest, *clip_box, margin);
+                report.stats.clip_bricks_skipped = cs.skipped;
+                report.stats.clip_bytes_skipped = cs.bytes_skipped;
+            }
+
+            // bricks.pack payload offsets are absolute, so it reads like bricks.bin
+            BricksReadOptions read_opts;
+            if (args.read_mode == "mmap") {
+                read_opts.mode = ReadMode::Mmap;
+            } else if (args.read_mode == "coalesced") {
+                read_opts.mode = ReadMode::Coalesced;
+            }
+            read_opts.direct_io = args.direct_io;
+            read_opts.verify_crc = (args.crc_verify != "background");
+            read_opts.cull = args.cull_bricks;
+            read_opts.summary_iso = summary_iso;
+            read_opts.keep_half = args.half;
+            read_opts.arena = true;
+            read_opts.huge_pages = args.huge_pages;
+            // --crc-verify background: verify alongside reading and inserting
+            // the bricks, which both happen inside stream_bricks_bin(), and
+            // join after the grid is finished
+            if (!read_opts.verify_crc) {
+                bricks_index = idx;
+                // culled bricks are never read; don't read them for the CRC either
+                if (read_opts.cull) {
+                    auto& v = bricks_index.bricks;
+                    v.erase(std::remove_if(v.begin(), v.end(), [&](const BrickEntry& e) {
+                                return classify_brick(e, manifest) != BrickCull::Keep;
+                            }),
+                            v.end());
+                }
+                crc_job = std::async(std::launch::async, [bin_path, &bricks_index] {
+                    return verify_bricks_crc(bin_path, bricks_index);
+                });
             }
 
-            auto bin_path = (fs::path(args.in_dir) / "bricks.bin").string();
-            auto br = load_bricks_bin(bin_path, ir.index, manifest);
+            builder = std::make_unique<VdbStreamBuilder>(manifest, vdb_opts);
+            auto br = stream_bricks_bin(bin_path, idx, manifest, read_opts, add_brick);
             if (!br.ok) {
                 for (const auto& e : br.errors) {
                     log_error(e.code, e.message, {{"field", e.field}});
@@ -170,9 +285,14 @@ int main(int argc, char* argv[]) {
                 try_write_report(report, out_dir, total_timer);
                 return static_cast<int>(br.exit_code);
             }
-            bricks = std::move(br.bricks);
-
+            // timing_ms.read covers voxel insertion as well (streamed build);
+            // timing_ms.vdb_build is only finish()
             report.timing_ms.read = read_timer.elapsed_ms();
+            log_info("GENMESH_I0008", "bricks.bin loaded and inserted", {
+                {"bricks", std::to_string(idx.bricks.size() - br.culled_outside)},
+                {"unique_payloads", std::to_string(br.unique_payloads)},
+                {"read_insert_ms", std::to_string(report.timing_ms.read)},
+            });
         }
     }
 
@@ -189,20 +309,13 @@ int main(int argc, char* argv[]) {
         manifest.aabb_min[1] + manifest.aabb_size[1],
         manifest.aabb_min[2] + manifest.aabb_size[2],
     };
-    report.stats.brick_count = static_cast<int64_t>(bricks.size());
 
-    // ---- 4. OpenVDB init + build grid ----
+    // ---- 4. Finish grid (merge, constant bricks, flood fill, prune) ----
     {
         ScopedTimer vdb_timer;
 
-        if (!vdb_init()) {
-            fail_report(report, Stage::VdbBuild, std::string(E3001),
-                        "env", "openvdb::initialize() failed");
-            try_write_report(report, out_dir, total_timer);
-            return static_cast<int>(ExitCode::EnvironmentError);
-        }
-
-        auto vdb_res = build_vdb(manifest, bricks);
+        auto vdb_res = builder->finish();
+        builder.reset();
         if (!vdb_res.ok) {
             fail_report(report, Stage::VdbBuild, vdb_res.error_code,
                         "vdb", vdb_res.error_msg);
@@ -212,16 +325,107 @@ int main(int argc, char* argv[]) {
         }
 
         report.timing_ms.vdb_build = vdb_timer.elapsed_ms();
+
+        if (args.narrow_band && !vdb_res.narrow_band) {
+            report.warnings.push_back({
+                std::string(W4001), "Narrow band unavailable; grid built dense", "vdb",
+                "iso + offset_mm must lie within the band around 0", {}, ""
+            });
+        }
+
+        // Join background CRC32 verification before anything is derived from the grid
+        if (crc_job.valid()) {
+            ScopedTimer wait_timer;
+            auto cr = crc_job.get();
+            log_info("GENMESH_I0007", "Background CRC32 verification finished", {
+                {"ok", cr.ok ? "true" : "false"},
+                {"wait_ms", std::to_string(wait_timer.elapsed_ms())},
+            });
+            if (!cr.ok) {
+                for (const auto& e : cr.errors) {
+                    report.errors.push_back({e.code, e.message, "io",
+                                             "", {{"field", e.field}}, ""});
+                }
+                report.status = "failure";
+                report.stage = Stage::Read;
+                report.has_progress = true;
+                report.progress.stage = Stage::Read;
+                try_write_report(report, out_dir, total_timer);
+                return static_cast<int>(cr.exit_code);
+            }
+        }
+
+        report.stats.brick_count = vdb_res.brick_count;
         report.stats.active_voxel_count = vdb_res.active_voxel_count;
+        report.stats.has_grid = true;
+        report.stats.grid_leaf_count = vdb_res.leaf_count;
+        report.stats.grid_uniform_tiles = vdb_res.uniform_tiles;
+        report.stats.grid_memory_bytes = vdb_res.memory_bytes;
+        report.stats.grid_memory_saved_bytes = vdb_res.memory_saved_bytes;
 
         // ---- 4.5. Apply level set offset (if requested) ----
+        // Past the band the band is extended by fast sweeping first.
         if (manifest.offset_mm != 0.0f) {
-            if (!apply_offset(vdb_res.grid, manifest.offset_mm)) {
+            const float band_mm = manifest.half_width_voxels * manifest.voxel_size;
+            auto off = offset_grid(vdb_res.grid, manifest.offset_mm, band_mm);
+            if (!off.ok) {
                 fail_report(report, Stage::VdbBuild, std::string(E4001),
                             "vdb", "levelSetOffset failed");
                 try_write_report(report, out_dir, total_timer);
                 return static_cast<int>(ExitCode::ProcessingError);
             }
+            report.stats.has_offset = true;
+            report.stats.offset_mm = manifest.offset_mm;
+            report.stats.offset_method = offset_method_name(off.method);
+            report.stats.offset_dilated_voxels = off.dilated_voxels;
+            report.stats.offset_ms = off.ms;
+        }
+
+        // ---- 4.6. Hollow to a shell with drain holes and infill (if requested) ----
+        if (args.shell_mm) {
+            std::vector<DrainHole> holes;
+            for (const auto& seg : args.drain_holes) {
+                holes.push_back({seg.from, seg.to, args.drain_radius_mm});
+            }
+            const float band_mm = manifest.half_width_voxels * manifest.voxel_size;
+            std::optional<TpmsParams> infill;
+            if (!args.infill.empty()) {
+                TpmsParams p;
+                parse_tpms_surface(args.infill, p.surface);  // validated by parse_args
+                p.cell_mm = args.infill_cell_mm;
+                p.wall_mm = args.infill_wall_mm;
+                infill = p;
+            }
+            auto sh = make_shell(vdb_res.grid, *args.shell_mm, holes, band_mm, infill);
+            if (!sh.ok) {
+                fail_report(report, Stage::VdbBuild, std::string(E4001),
+                            "vdb", "shell failed");
+                try_write_report(report, out_dir, total_timer);
+                return static_cast<int>(ExitCode::ProcessingError);
+            }
+            report.stats.has_shell = true;
+            report.stats.shell_thickness_mm = *args.shell_mm;
+            report.stats.shell_method = offset_method_name(sh.erode_method);
+            report.stats.shell_drain_holes = sh.drain_holes;
+            report.stats.shell_ms = sh.ms;
+            if (infill) {
+                report.stats.has_infill = true;
+                report.stats.infill_surface = args.infill;
+                report.stats.infill_cell_mm = infill->cell_mm;
+                report.stats.infill_wall_mm = infill->wall_mm;
+                report.stats.infill_leaves = sh.infill_leaves;
+                report.stats.infill_ms = sh.infill_ms;
+            }
+        }
+
+        // ---- 4.7. Clip to the region of interest (if requested) ----
+        if (clip_box) {
+            if (!clip_grid(vdb_res.grid, *clip_box)) {
+                fail_report(report, Stage::VdbBuild, std::string(E4001),
+                            "vdb", "tools::clip failed");
+                try_write_report(report, out_dir, total_timer);
+                return static_cast<int>(ExitCode::ProcessingError);
+            }
         }
 
         // ---- 5. Mesh extraction ----
@@ -294,7 +498,7 @@ int main(int argc, char* argv[]) {
 
         // 6b. VDB
         if (args.write_vdb) {
-            auto vdb_wr = write_vdb(out_dir / "volume.vdb", vdb_res.grid);
+            auto vdb_wr = write_vdb(out_dir / "volume.vdb", vdb_res.grid, args.half);
             if (!vdb_wr.ok) {
                 fail_report(report, Stage::Write, vdb_wr.error_code,
                             "io", vdb_wr.error_msg);
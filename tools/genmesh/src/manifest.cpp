@@ -61,19 +61,25 @@ static bool require_string_const(const json& j, const std::string& key,
 // ---------- parse + validate ----------
 
 ManifestResult load_manifest(const std::string& path) {
-    ManifestResult result;
-
     // --- read file ---
     std::ifstream ifs(path);
     if (!ifs.is_open()) {
+        ManifestResult result;
         add_error(result, E2002, "Cannot open manifest: " + path);
         result.exit_code = ExitCode::IoError;
         return result;
     }
+    std::ostringstream text;
+    text << ifs.rdbuf();
+    return parse_manifest(text.str());
+}
+
+ManifestResult parse_manifest(std::string_view text) {
+    ManifestResult result;
 
     json j;
     try {
-        j = json::parse(ifs);
+        j = json::parse(text);
     } catch (const json::parse_error& e) {
         add_error(result, E2002, std::string("Manifest JSON parse error: ") + e.what());
         result.exit_code = ExitCode::ValidationFailure;
@@ -0,0 +1,141 @@
+#include "genmesh/mapped_file.h"
+
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace genmesh {
+
+static void set_error(std::string* error_msg, const std::string& msg) {
+    if (error_msg) *error_msg = msg;
+}
+
+#ifdef _WIN32
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path,
+                                             std::string* error_msg) {
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+
+    const std::wstring wpath = std::filesystem::path(path).wstring();
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        set_error(error_msg, "CreateFile failed (error " + std::to_string(GetLastError()) + ")");
+        return nullptr;
+    }
+    mf->file_handle_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        set_error(error_msg, "GetFileSizeEx failed (error " + std::to_string(GetLastError()) + ")");
+        return nullptr;
+    }
+    mf->size_ = static_cast<int64_t>(size.QuadPart);
+
+    // Zero-length files cannot be mapped; expose an empty range instead.
+    if (mf->size_ == 0) {
+        return mf;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        set_error(error_msg, "CreateFileMapping failed (error " + std::to_string(GetLastError()) + ")");
+        return nullptr;
+    }
+    mf->mapping_handle_ = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        set_error(error_msg, "MapViewOfFile failed (error " + std::to_string(GetLastError()) + ")");
+        return nullptr;
+    }
+    mf->data_ = static_cast<const uint8_t*>(view);
+    return mf;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    if (file_handle_) CloseHandle(static_cast<HANDLE>(file_handle_));
+}
+
+void MappedFile::advise(Advice, int64_t, int64_t) const {
+    // FILE_FLAG_SEQUENTIAL_SCAN is set at open time; per-range hints are not used.
+}
+
+#else  // POSIX
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path,
+                                             std::string* error_msg) {
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        set_error(error_msg, std::string("open failed: ") + std::strerror(errno));
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        set_error(error_msg, std::string("fstat failed: ") + std::strerror(errno));
+        ::close(fd);
+        return nullptr;
+    }
+    mf->size_ = static_cast<int64_t>(st.st_size);
+
+    // Zero-length files cannot be mapped; expose an empty range instead.
+    if (mf->size_ == 0) {
+        ::close(fd);
+        return mf;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(mf->size_), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        set_error(error_msg, std::string("mmap failed: ") + std::strerror(errno));
+        return nullptr;
+    }
+    mf->data_ = static_cast<const uint8_t*>(addr);
+    return mf;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+}
+
+void MappedFile::advise(Advice advice, int64_t offset, int64_t length) const {
+    if (!data_ || offset < 0 || offset >= size_) return;
+    if (length < 0 || offset + length > size_) length = size_ - offset;
+
+    // madvise requires a page-aligned start address.
+    static const int64_t page = static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+    const int64_t aligned = offset - (offset % page);
+    length += offset - aligned;
+
+    int flag = MADV_NORMAL;
+    switch (advice) {
+        case Advice::Normal:     flag = MADV_NORMAL; break;
+        case Advice::Sequential: flag = MADV_SEQUENTIAL; break;
+        case Advice::WillNeed:   flag = MADV_WILLNEED; break;
+    }
+    // Hints only: failures are harmless and intentionally ignored.
+    (void)madvise(const_cast<uint8_t*>(data_) + aligned, static_cast<size_t>(length), flag);
+}
+
+#endif
+
+}  // namespace genmesh
@@ -215,7 +215,8 @@ StlWriteResult write_stl(const std::filesystem::path& path,
 }
 
 VdbWriteResult write_vdb(const std::filesystem::path& path,
-                         const openvdb::FloatGrid::Ptr& grid) {
+                         const openvdb::FloatGrid::Ptr& grid,
+                         bool save_as_half) {
     VdbWriteResult result;
 
     if (!grid) {
@@ -227,21 +228,27 @@ VdbWriteResult write_vdb(const std::filesystem::path& path,
         return result;
     }
 
+    // per-grid write flag; restored so the caller's grid is unchanged
+    const bool was_half = grid->saveFloatAsHalf();
     try {
+        grid->setSaveFloatAsHalf(save_as_half);
         openvdb::io::File file(path.string());
         openvdb::GridPtrVec grids;
         grids.push_back(grid);
         file.write(grids);
         file.close();
+        grid->setSaveFloatAsHalf(was_half);
 
         log_info("GENMESH_I0005", "VDB written", {
             {"path", path.string()},
+            {"half", save_as_half ? "true" : "false"},
         });
 
         result.ok = true;
         result.exit_code = ExitCode::Success;
 
     } catch (const std::exception& e) {
+        grid->setSaveFloatAsHalf(was_half);
         result.ok = false;
         result.exit_code = ExitCode::IoError;
         result.error_code = std::string(E2103);
@@ -0,0 +1,171 @@
+#include "genmesh/positional_file.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace genmesh {
+
+static void set_error(std::string* error_msg, const std::string& msg) {
+    if (error_msg) *error_msg = msg;
+}
+
+#ifdef _WIN32
+
+std::unique_ptr<PositionalFile> PositionalFile::open(const std::string& path, bool direct,
+                                                     std::string* error_msg) {
+    std::unique_ptr<PositionalFile> pf(new PositionalFile());
+
+    // Overlapped handle: concurrent reads at different offsets are not
+    // serialized on the file object.
+    const std::wstring wpath = std::filesystem::path(path).wstring();
+    const DWORD flags = FILE_FLAG_OVERLAPPED | FILE_FLAG_RANDOM_ACCESS;
+    HANDLE file = INVALID_HANDLE_VALUE;
+    if (direct) {
+        file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           flags | FILE_FLAG_NO_BUFFERING, nullptr);
+        pf->direct_ = (file != INVALID_HANDLE_VALUE);
+    }
+    if (file == INVALID_HANDLE_VALUE) {
+        file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           flags, nullptr);
+    }
+    if (file == INVALID_HANDLE_VALUE) {
+        set_error(error_msg, "CreateFile failed (error " + std::to_string(GetLastError()) + ")");
+        return nullptr;
+    }
+    pf->handle_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        set_error(error_msg, "GetFileSizeEx failed (error " + std::to_string(GetLastError()) + ")");
+        return nullptr;
+    }
+    pf->size_ = static_cast<int64_t>(size.QuadPart);
+    return pf;
+}
+
+PositionalFile::~PositionalFile() {
+    if (handle_) CloseHandle(static_cast<HANDLE>(handle_));
+}
+
+int64_t PositionalFile::read_at(void* dst, size_t length, int64_t offset,
+                                std::string* error_msg) const {
+    HANDLE event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!event) {
+        set_error(error_msg, "CreateEvent failed (error " + std::to_string(GetLastError()) + ")");
+        return -1;
+    }
+
+    size_t done = 0;
+    int64_t result = 0;
+    while (done < length) {
+        const DWORD chunk = static_cast<DWORD>(std::min<size_t>(length - done, 1u << 30));
+        const uint64_t pos = static_cast<uint64_t>(offset) + done;
+        OVERLAPPED ov = {};
+        ov.Offset = static_cast<DWORD>(pos);
+        ov.OffsetHigh = static_cast<DWORD>(pos >> 32);
+        ov.hEvent = event;
+
+        DWORD got = 0;
+        if (!ReadFile(static_cast<HANDLE>(handle_), static_cast<uint8_t*>(dst) + done, chunk,
+                      nullptr, &ov) &&
+            GetLastError() != ERROR_IO_PENDING) {
+            if (GetLastError() == ERROR_HANDLE_EOF) break;
+            set_error(error_msg, "ReadFile failed (error " + std::to_string(GetLastError()) + ")");
+            result = -1;
+            break;
+        }
+        if (!GetOverlappedResult(static_cast<HANDLE>(handle_), &ov, &got, TRUE)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) break;
+            set_error(error_msg, "ReadFile failed (error " + std::to_string(GetLastError()) + ")");
+            result = -1;
+            break;
+        }
+        if (got == 0) break;  // end of file
+        done += got;
+    }
+
+    CloseHandle(event);
+    return result < 0 ? -1 : static_cast<int64_t>(done);
+}
+
+#else  // POSIX
+
+std::unique_ptr<PositionalFile> PositionalFile::open(const std::string& path, bool direct,
+                                                     std::string* error_msg) {
+    std::unique_ptr<PositionalFile> pf(new PositionalFile());
+
+    int fd = -1;
+#ifdef O_DIRECT
+    if (direct) {
+        // tmpfs and some network filesystems refuse O_DIRECT (EINVAL).
+        fd = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+        pf->direct_ = (fd >= 0);
+    }
+#endif
+    if (fd < 0) {
+        fd = ::open(path.c_str(), O_RDONLY);
+    }
+    if (fd < 0) {
+        set_error(error_msg, std::string("open failed: ") + std::strerror(errno));
+        return nullptr;
+    }
+    pf->fd_ = fd;
+
+#if defined(__APPLE__)
+    // No O_DIRECT on macOS; F_NOCACHE keeps reads out of the unified buffer cache.
+    if (direct) {
+        pf->direct_ = (fcntl(fd, F_NOCACHE, 1) == 0);
+    }
+#endif
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        set_error(error_msg, std::string("fstat failed: ") + std::strerror(errno));
+        return nullptr;
+    }
+    pf->size_ = static_cast<int64_t>(st.st_size);
+    return pf;
+}
+
+PositionalFile::~PositionalFile() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+int64_t PositionalFile::read_at(void* dst, size_t length, int64_t offset,
+                                std::string* error_msg) const {
+    size_t done = 0;
+    while (done < length) {
+        const ssize_t n = ::pread(fd_, static_cast<uint8_t*>(dst) + done, length - done,
+                                  static_cast<off_t>(offset + static_cast<int64_t>(done)));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            set_error(error_msg, std::string("pread failed: ") + std::strerror(errno));
+            return -1;
+        }
+        if (n == 0) break;  // end of file
+        done += static_cast<size_t>(n);
+        // A direct read that stops off-block hit EOF; another pread from an
+        // unaligned offset would fail with EINVAL instead of returning 0.
+        if (direct_ && done % kDirectAlignment != 0) break;
+    }
+    return static_cast<int64_t>(done);
+}
+
+#endif
+
+}  // namespace genmesh
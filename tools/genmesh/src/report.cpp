@@ -107,6 +107,47 @@ nlohmann::json report_to_json(const Report& report) {
         if (report.stats.active_voxel_count >= 0) {
             s["active_voxel_count"] = report.stats.active_voxel_count;
         }
+        if (report.stats.has_grid) {
+            s["grid"] = {
+                {"leaf_count", report.stats.grid_leaf_count},
+                {"uniform_tiles", report.stats.grid_uniform_tiles},
+                {"memory_bytes", report.stats.grid_memory_bytes},
+                {"memory_saved_bytes", report.stats.grid_memory_saved_bytes},
+            };
+        }
+        if (report.stats.has_clip) {
+            s["clip"] = {
+                {"bbox_min", {report.stats.clip_min[0], report.stats.clip_min[1], report.stats.clip_min[2]}},
+                {"bbox_max", {report.stats.clip_max[0], report.stats.clip_max[1], report.stats.clip_max[2]}},
+                {"bricks_skipped", report.stats.clip_bricks_skipped},
+                {"bytes_skipped", report.stats.clip_bytes_skipped},
+            };
+        }
+        if (report.stats.has_offset) {
+            s["offset"] = {
+                {"offset_mm", report.stats.offset_mm},
+                {"method", report.stats.offset_method},
+                {"dilated_voxels", report.stats.offset_dilated_voxels},
+                {"ms", report.stats.offset_ms},
+            };
+        }
+        if (report.stats.has_shell) {
+            s["shell"] = {
+                {"thickness_mm", report.stats.shell_thickness_mm},
+                {"method", report.stats.shell_method},
+                {"drain_holes", report.stats.shell_drain_holes},
+                {"ms", report.stats.shell_ms},
+            };
+            if (report.stats.has_infill) {
+                s["shell"]["infill"] = {
+                    {"surface", report.stats.infill_surface},
+                    {"cell_mm", report.stats.infill_cell_mm},
+                    {"wall_mm", report.stats.infill_wall_mm},
+                    {"leaves", report.stats.infill_leaves},
+                    {"ms", report.stats.infill_ms},
+                };
+            }
+        }
         j["stats"] = s;
     }
 
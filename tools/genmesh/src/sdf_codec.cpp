@@ -0,0 +1,414 @@
+#include "genmesh/sdf_codec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace genmesh {
+
+namespace {
+
+constexpr size_t kHeaderBytes = 8;
+constexpr uint8_t kModeLossless = 0;
+constexpr uint8_t kModeBounded = 1;
+
+constexpr uint32_t kZeroRow = 31;     // Rice parameter code: all residuals 0
+constexpr uint32_t kMaxRiceK = 30;
+constexpr uint32_t kEscapeZeros = 24;  // unary prefix that announces a raw 32-bit value
+constexpr int32_t kMaxQuant = 1 << 27;  // keeps Lorenzo sums inside int32
+
+inline int ctz64(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+inline uint32_t zigzag(uint32_t r) { return (r << 1) ^ (0u - (r >> 31)); }
+inline uint32_t unzigzag(uint32_t z) { return (z >> 1) ^ (0u - (z & 1)); }
+
+// ---------- bit I/O (LSB-first) ----------
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    /// Append the low `bits` bits of v (bits <= 32, v < 2^bits).
+    void put(uint32_t v, uint32_t bits) {
+        acc_ |= static_cast<uint64_t>(v) << fill_;
+        fill_ += bits;
+        while (fill_ >= 8) {
+            out_.push_back(static_cast<uint8_t>(acc_));
+            acc_ >>= 8;
+            fill_ -= 8;
+        }
+    }
+
+    void flush() {
+        if (fill_ > 0) out_.push_back(static_cast<uint8_t>(acc_));
+        acc_ = 0;
+        fill_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    uint32_t fill_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* p, size_t n) : begin_(p), p_(p), end_(p + n) {}
+
+    /// Ensure at least 56 buffered bits (zero-padded past the end).
+    /// Invariant: p_ is the byte that starts at bit `fill_` of buf_.
+    void refill() {
+        if (end_ - p_ >= 8) {
+            uint64_t w;
+            std::memcpy(&w, p_, sizeof(w));
+            buf_ |= w << fill_;
+            p_ += (63 - fill_) >> 3;
+            fill_ |= 56;
+        } else {
+            while (fill_ <= 56) {
+                uint64_t b = 0;
+                if (p_ < end_) {
+                    b = *p_++;
+                } else {
+                    ++pad_bytes_;
+                }
+                buf_ |= b << fill_;
+                fill_ += 8;
+            }
+        }
+    }
+
+    uint32_t bits() const { return fill_; }
+    uint64_t peek() const { return buf_; }
+
+    void skip(uint32_t bits) {
+        buf_ >>= bits;
+        fill_ -= bits;
+    }
+
+    uint32_t get(uint32_t bits) {
+        const uint32_t v = static_cast<uint32_t>(buf_ & ((uint64_t(1) << bits) - 1));
+        skip(bits);
+        return v;
+    }
+
+    /// Whether more bits were consumed than the stream holds.
+    bool overrun() const {
+        const size_t loaded = static_cast<size_t>(p_ - begin_) + pad_bytes_;
+        return loaded * 8 - fill_ > static_cast<size_t>(end_ - begin_) * 8;
+    }
+
+private:
+    const uint8_t* begin_;
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t buf_ = 0;
+    uint32_t fill_ = 0;
+    size_t pad_bytes_ = 0;
+};
+
+// ---------- Rice coding ----------
+
+inline uint64_t rice_cost(const uint32_t* u, int n, uint32_t k) {
+    uint64_t bits = 0;
+    for (int i = 0; i < n; ++i) {
+        const uint32_t q = u[i] >> k;
+        bits += q < kEscapeZeros ? q + 1 + k : kEscapeZeros + 32;
+    }
+    return bits;
+}
+
+void encode_row(BitWriter& bw, const uint32_t* u, int n) {
+    uint64_t sum = 0;
+    for (int i = 0; i < n; ++i) sum += u[i];
+    if (sum == 0) {
+        bw.put(kZeroRow, 5);
+        return;
+    }
+
+    // Start from log2(mean) and probe the neighbours.
+    uint32_t k0 = 0;
+    for (uint64_t mean = sum / static_cast<uint64_t>(n); mean > 1; mean >>= 1) ++k0;
+    uint32_t best_k = k0 > kMaxRiceK ? kMaxRiceK : k0;
+    uint64_t best = rice_cost(u, n, best_k);
+    for (uint32_t k : {k0 - 1, k0 + 1}) {
+        if (k > kMaxRiceK) continue;  // also catches k0 - 1 wrapping
+        const uint64_t c = rice_cost(u, n, k);
+        if (c < best) {
+            best = c;
+            best_k = k;
+        }
+    }
+
+    bw.put(best_k, 5);
+    const uint32_t k = best_k;
+    for (int i = 0; i < n; ++i) {
+        const uint32_t q = u[i] >> k;
+        if (q < kEscapeZeros) {
+            bw.put(1u << q, q + 1);  // q zeros, then a one
+            if (k) bw.put(u[i] & ((1u << k) - 1), k);
+        } else {
+            bw.put(0, kEscapeZeros);
+            bw.put(u[i], 32);
+        }
+    }
+}
+
+/// Decode n Rice codes with parameter k (<= kMaxRiceK). Refills only when
+/// fewer bits are buffered than the longest non-escape code.
+void decode_row(BitReader& reader, uint32_t k, uint32_t* u, int n) {
+    BitReader br = reader;  // local copy stays in registers (u may alias members)
+    const uint32_t longest = kEscapeZeros + k;
+    const uint64_t low_mask = (uint64_t(1) << k) - 1;
+    for (int i = 0; i < n; ++i) {
+        if (br.bits() < longest) br.refill();
+        const uint64_t buf = br.peek();
+        const uint32_t zeros = buf ? static_cast<uint32_t>(ctz64(buf)) : 64;
+        if (zeros >= kEscapeZeros) {
+            br.skip(kEscapeZeros);
+            br.refill();
+            u[i] = br.get(32);
+            continue;
+        }
+        u[i] = (zeros << k) | static_cast<uint32_t>((buf >> (zeros + 1)) & low_mask);
+        br.skip(zeros + 1 + k);
+    }
+    reader = br;
+}
+
+// ---------- prediction policies ----------
+
+/// Lossless: predict in float, code the difference of order-preserving
+/// integer images. The operation order below is part of the format.
+struct FloatPolicy {
+    using T = float;
+
+    static uint32_t key(float f) {
+        uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+    }
+    static float unkey(uint32_t k) {
+        const uint32_t u = (k & 0x80000000u) ? (k & 0x7FFFFFFFu) : ~k;
+        float f;
+        std::memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+
+    /// Lorenzo terms from the previous row/slice (vectorizable per row).
+    static float partial(float b, float c, float bc, float ab, float ac, float abc) {
+        return ((((b + c) - bc) - ab) - ac) + abc;
+    }
+    /// Add the previous-x neighbour last: the only term on the serial path.
+    static float predict(float part, float a) {
+        const float p = part + a;
+        uint32_t u;
+        std::memcpy(&u, &p, sizeof(u));
+        return (u & 0x7F800000u) == 0x7F800000u ? 0.0f : p;  // Inf/NaN never predicted
+    }
+    static uint32_t residual(float v, float p) { return zigzag(key(v) - key(p)); }
+    static float apply(float p, uint32_t z) { return unkey(key(p) + unzigzag(z)); }
+};
+
+/// Bounded: predict quantization indices exactly in int32.
+struct QuantPolicy {
+    using T = int32_t;
+
+    // Wrapping arithmetic: a corrupt stream must not hit signed overflow.
+    static int32_t partial(int32_t b, int32_t c, int32_t bc, int32_t ab, int32_t ac,
+                           int32_t abc) {
+        const uint32_t p = static_cast<uint32_t>(b) + static_cast<uint32_t>(c) -
+                           static_cast<uint32_t>(bc) - static_cast<uint32_t>(ab) -
+                           static_cast<uint32_t>(ac) + static_cast<uint32_t>(abc);
+        return static_cast<int32_t>(p);
+    }
+    static int32_t predict(int32_t part, int32_t a) {
+        return static_cast<int32_t>(static_cast<uint32_t>(part) + static_cast<uint32_t>(a));
+    }
+    static uint32_t residual(int32_t v, int32_t p) {
+        return zigzag(static_cast<uint32_t>(v) - static_cast<uint32_t>(p));
+    }
+    static int32_t apply(int32_t p, uint32_t z) {
+        return static_cast<int32_t>(static_cast<uint32_t>(p) + unzigzag(z));
+    }
+};
+
+inline float dequantize(int32_t q, float step) { return static_cast<float>(q) * step; }
+
+/// Walk the B*B rows of a brick with the Lorenzo neighbour rows resolved
+/// (rows outside the brick read as zeros).
+template <class T, class F>
+void for_each_row(T* base, int B, F&& fn) {
+    const std::vector<T> zeros(static_cast<size_t>(B), T(0));
+    const size_t row = static_cast<size_t>(B);
+    const size_t slice = row * row;
+    for (int z = 0; z < B; ++z) {
+        for (int y = 0; y < B; ++y) {
+            T* cur = base + static_cast<size_t>(z) * slice + static_cast<size_t>(y) * row;
+            const T* ry = y > 0 ? cur - row : zeros.data();
+            const T* rz = z > 0 ? cur - slice : zeros.data();
+            const T* ryz = (y > 0 && z > 0) ? cur - row - slice : zeros.data();
+            fn(cur, ry, rz, ryz);
+        }
+    }
+}
+
+/// Lorenzo terms that do not depend on the current row: part[x] for x in [0, B).
+template <class P>
+void row_partials(const typename P::T* ry, const typename P::T* rz, const typename P::T* ryz,
+                  int B, typename P::T* part) {
+    using T = typename P::T;
+    part[0] = P::partial(ry[0], rz[0], ryz[0], T(0), T(0), T(0));
+    for (int x = 1; x < B; ++x) {
+        part[x] = P::partial(ry[x], rz[x], ryz[x], ry[x - 1], rz[x - 1], ryz[x - 1]);
+    }
+}
+
+template <class P>
+void encode_residuals(const typename P::T* values, int B, BitWriter& bw) {
+    using T = typename P::T;
+    std::vector<uint32_t> u(static_cast<size_t>(B));
+    std::vector<T> part(static_cast<size_t>(B));
+    for_each_row(const_cast<T*>(values), B, [&](const T* cur, const T* ry, const T* rz,
+                                                const T* ryz) {
+        row_partials<P>(ry, rz, ryz, B, part.data());
+        u[0] = P::residual(cur[0], P::predict(part[0], T(0)));
+        for (int x = 1; x < B; ++x) {
+            u[static_cast<size_t>(x)] = P::residual(cur[x], P::predict(part[x], cur[x - 1]));
+        }
+        encode_row(bw, u.data(), B);
+    });
+}
+
+/// Per row: Rice codes → residuals, previous-row partials, then the short
+/// serial recurrence along x.
+template <class P>
+bool decode_residuals(typename P::T* out, int B, BitReader& br) {
+    using T = typename P::T;
+    std::vector<uint32_t> u(static_cast<size_t>(B));
+    std::vector<T> part(static_cast<size_t>(B));
+    bool ok = true;
+    for_each_row(out, B, [&](T* cur, const T* ry, const T* rz, const T* ryz) {
+        if (!ok) return;
+        br.refill();
+        const uint32_t k = br.get(5);
+        if (k == kZeroRow) {
+            std::fill(u.begin(), u.end(), 0u);
+        } else if (k <= kMaxRiceK) {
+            decode_row(br, k, u.data(), B);
+        } else {
+            ok = false;
+            return;
+        }
+
+        row_partials<P>(ry, rz, ryz, B, part.data());
+        T prev = T(0);
+        for (int x = 0; x < B; ++x) {
+            prev = P::apply(P::predict(part[x], prev), u[static_cast<size_t>(x)]);
+            cur[x] = prev;
+        }
+    });
+    return ok && !br.overrun();
+}
+
+void write_header(std::vector<uint8_t>& out, uint8_t mode, int B, float step) {
+    out.resize(kHeaderBytes);
+    out[0] = mode;
+    out[1] = 0;
+    const uint16_t b16 = static_cast<uint16_t>(B);
+    std::memcpy(out.data() + 2, &b16, sizeof(b16));
+    std::memcpy(out.data() + 4, &step, sizeof(step));
+}
+
+/// Quantize to multiples of `step`; false if any voxel would break the bound.
+bool quantize(const float* values, size_t n, float step, float bound, std::vector<int32_t>& q) {
+    q.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const float v = values[i];
+        if (!std::isfinite(v)) return false;
+        const double qi = std::nearbyint(static_cast<double>(v) / step);
+        if (qi > kMaxQuant || qi < -kMaxQuant) return false;
+        q[i] = static_cast<int32_t>(qi);
+        if (std::fabs(dequantize(q[i], step) - v) > bound) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+std::vector<uint8_t> sdfp_encode(const float* values, int brick_size,
+                                 const SdfpOptions& options) {
+    const int B = brick_size;
+    const size_t n = static_cast<size_t>(B) * B * B;
+
+    std::vector<uint8_t> out;
+    out.reserve(n);  // typical result is well under 1 byte/voxel
+
+    if (options.max_error_mm > 0.0f) {
+        const float step = 2.0f * options.max_error_mm;
+        std::vector<int32_t> q;
+        if (quantize(values, n, step, options.max_error_mm, q)) {
+            write_header(out, kModeBounded, B, step);
+            BitWriter bw(out);
+            encode_residuals<QuantPolicy>(q.data(), B, bw);
+            bw.flush();
+            return out;
+        }
+    }
+
+    write_header(out, kModeLossless, B, 0.0f);
+    BitWriter bw(out);
+    encode_residuals<FloatPolicy>(values, B, bw);
+    bw.flush();
+    return out;
+}
+
+bool sdfp_decode(const uint8_t* src, size_t src_size, float* dst, size_t voxels,
+                 std::string* error_msg) {
+    auto fail = [&](const char* why) {
+        if (error_msg) *error_msg = why;
+        return false;
+    };
+
+    if (src_size < kHeaderBytes) return fail("truncated header");
+
+    const uint8_t mode = src[0];
+    uint16_t b16;
+    float step;
+    std::memcpy(&b16, src + 2, sizeof(b16));
+    std::memcpy(&step, src + 4, sizeof(step));
+    const int B = b16;
+
+    if (B == 0 || static_cast<size_t>(B) * B * B != voxels) return fail("brick size mismatch");
+
+    BitReader br(src + kHeaderBytes, src_size - kHeaderBytes);
+
+    if (mode == kModeLossless) {
+        if (!decode_residuals<FloatPolicy>(dst, B, br)) return fail("corrupt bitstream");
+        return true;
+    }
+    if (mode == kModeBounded) {
+        if (!(step > 0.0f) || !std::isfinite(step)) return fail("invalid quantization step");
+        thread_local std::vector<int32_t> q;
+        q.resize(voxels);
+        if (!decode_residuals<QuantPolicy>(q.data(), B, br)) return fail("corrupt bitstream");
+        for (size_t i = 0; i < voxels; ++i) dst[i] = dequantize(q[i], step);
+        return true;
+    }
+    return fail("unknown mode");
+}
+
+}  // namespace genmesh
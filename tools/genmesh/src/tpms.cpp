@@ -0,0 +1,257 @@
+#include "genmesh/tpms.h"
+#include "genmesh/cpu_features.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if GENMESH_X86
+#include <immintrin.h>
+#endif
+
+namespace genmesh {
+
+static constexpr int kDim = kTpmsBlockDim;
+static constexpr double kTwoPi = 6.283185307179586;
+
+// Floor for |grad g| / k: the TPMS functions have critical points (away
+// from the surface) where the first-order estimate would blow up.
+static constexpr float kMinGrad = 0.05f;
+
+bool parse_tpms_surface(std::string_view name, TpmsSurface& out) {
+    if (name == "gyroid") {
+        out = TpmsSurface::Gyroid;
+    } else if (name == "schwarz-p") {
+        out = TpmsSurface::SchwarzP;
+    } else if (name == "diamond") {
+        out = TpmsSurface::Diamond;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* tpms_surface_name(TpmsSurface surface) {
+    switch (surface) {
+        case TpmsSurface::SchwarzP: return "schwarz-p";
+        case TpmsSurface::Diamond:  return "diamond";
+        default:                    return "gyroid";
+    }
+}
+
+/// sin/cos of k * (origin + i * voxel) for the 8 samples of one block axis.
+struct AxisTable {
+    float s[kDim];
+    float c[kDim];
+};
+
+static void axis_table(double k, double origin, double voxel, int n, AxisTable& t) {
+    for (int i = 0; i < n; ++i) {
+        const double a = k * (origin + i * voxel);
+        t.s[i] = static_cast<float>(std::sin(a));
+        t.c[i] = static_cast<float>(std::cos(a));
+    }
+}
+
+/// Per-block constants shared by every kernel.
+struct BlockSetup {
+    AxisTable x, y, z;
+    float inv_k;
+    float half_wall;
+};
+
+static BlockSetup block_setup(const TpmsParams& p, const std::array<double, 3>& origin,
+                              double voxel) {
+    const double k = kTwoPi / p.cell_mm;
+    BlockSetup b;
+    axis_table(k, origin[0], voxel, kDim, b.x);
+    axis_table(k, origin[1], voxel, kDim, b.y);
+    axis_table(k, origin[2], voxel, kDim, b.z);
+    b.inv_k = static_cast<float>(1.0 / k);
+    b.half_wall = 0.5f * p.wall_mm;
+    return b;
+}
+
+// ---------- scalar ----------
+//
+// Products of the x and y terms are the same for a whole z row; the AVX2
+// kernel hoists them and performs the same operations in the same order,
+// lane-wise, so both kernels round identically.
+
+static float voxel_scalar(TpmsSurface surface, float sx, float cx, float sy, float cy, float sz,
+                          float cz, float inv_k, float half_wall) {
+    float g, n2;
+    switch (surface) {
+        case TpmsSurface::Gyroid: {
+            const float a = sx * cy, b = cx * cy, c = sx * sy;
+            g = (a + sy * cz) + sz * cx;
+            const float gx = b - sx * sz;
+            const float gy = cy * cz - c;
+            const float gz = cz * cx - sy * sz;
+            n2 = (gx * gx + gy * gy) + gz * gz;
+            break;
+        }
+        case TpmsSurface::SchwarzP: {
+            g = (cx + cy) + cz;
+            n2 = (sx * sx + sy * sy) + sz * sz;
+            break;
+        }
+        default: {  // Diamond
+            const float p = sx * sy, q = sx * cy, r = cx * sy, u = cx * cy;
+            g = ((p * sz + q * cz) + r * cz) + u * sz;
+            const float gx = ((r * sz + u * cz) - p * cz) - q * sz;
+            const float gy = ((q * sz + u * cz) - p * cz) - r * sz;
+            const float gz = ((p * cz - q * sz) - r * sz) + u * cz;
+            n2 = (gx * gx + gy * gy) + gz * gz;
+            break;
+        }
+    }
+    const float n = std::max(std::sqrt(n2), kMinGrad);
+    return std::fabs(g) * inv_k / n - half_wall;
+}
+
+static void block_scalar(TpmsSurface surface, const BlockSetup& b, float* out) {
+    for (int i = 0; i < kDim; ++i)
+        for (int j = 0; j < kDim; ++j)
+            for (int k = 0; k < kDim; ++k)
+                out[(i * kDim + j) * kDim + k] =
+                    voxel_scalar(surface, b.x.s[i], b.x.c[i], b.y.s[j], b.y.c[j], b.z.s[k],
+                                 b.z.c[k], b.inv_k, b.half_wall);
+}
+
+// ---------- x86 SIMD ----------
+
+#if GENMESH_X86
+
+GENMESH_TARGET("avx2")
+static inline __m256 sq(__m256 v) { return _mm256_mul_ps(v, v); }
+
+// |g| * inv_k / max(sqrt(n2), kMinGrad) - half_wall
+GENMESH_TARGET("avx2")
+static inline __m256 finish8(__m256 g, __m256 n2, __m256 inv_k, __m256 half_wall) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 n = _mm256_max_ps(_mm256_sqrt_ps(n2), _mm256_set1_ps(kMinGrad));
+    const __m256 d = _mm256_div_ps(_mm256_mul_ps(_mm256_and_ps(g, abs_mask), inv_k), n);
+    return _mm256_sub_ps(d, half_wall);
+}
+
+// One z row (8 voxels) = one YMM register. No FMA, so every lane rounds
+// exactly like the scalar kernel.
+GENMESH_TARGET("avx2")
+static void block_avx2(TpmsSurface surface, const BlockSetup& b, float* out) {
+    const __m256 sz = _mm256_loadu_ps(b.z.s);
+    const __m256 cz = _mm256_loadu_ps(b.z.c);
+    const __m256 inv_k = _mm256_set1_ps(b.inv_k);
+    const __m256 half_wall = _mm256_set1_ps(b.half_wall);
+
+    for (int i = 0; i < kDim; ++i) {
+        const float sx = b.x.s[i], cx = b.x.c[i];
+        for (int j = 0; j < kDim; ++j) {
+            const float sy = b.y.s[j], cy = b.y.c[j];
+            float* row = out + i * kDim * kDim + j * kDim;
+            __m256 d;
+            switch (surface) {
+                case TpmsSurface::Gyroid: {
+                    const __m256 a = _mm256_set1_ps(sx * cy);
+                    const __m256 bb = _mm256_set1_ps(cx * cy);
+                    const __m256 c = _mm256_set1_ps(sx * sy);
+                    const __m256 vsx = _mm256_set1_ps(sx), vcx = _mm256_set1_ps(cx);
+                    const __m256 vsy = _mm256_set1_ps(sy), vcy = _mm256_set1_ps(cy);
+                    const __m256 g = _mm256_add_ps(_mm256_add_ps(a, _mm256_mul_ps(vsy, cz)),
+                                                   _mm256_mul_ps(sz, vcx));
+                    const __m256 gx = _mm256_sub_ps(bb, _mm256_mul_ps(vsx, sz));
+                    const __m256 gy = _mm256_sub_ps(_mm256_mul_ps(vcy, cz), c);
+                    const __m256 gz =
+                        _mm256_sub_ps(_mm256_mul_ps(cz, vcx), _mm256_mul_ps(vsy, sz));
+                    d = finish8(g, _mm256_add_ps(_mm256_add_ps(sq(gx), sq(gy)), sq(gz)), inv_k,
+                                half_wall);
+                    break;
+                }
+                case TpmsSurface::SchwarzP: {
+                    const __m256 a = _mm256_set1_ps(cx + cy);
+                    const __m256 m = _mm256_set1_ps(sx * sx + sy * sy);
+                    d = finish8(_mm256_add_ps(a, cz), _mm256_add_ps(m, sq(sz)), inv_k, half_wall);
+                    break;
+                }
+                default: {  // Diamond
+                    const __m256 p = _mm256_set1_ps(sx * sy);
+                    const __m256 q = _mm256_set1_ps(sx * cy);
+                    const __m256 r = _mm256_set1_ps(cx * sy);
+                    const __m256 u = _mm256_set1_ps(cx * cy);
+                    const __m256 psz = _mm256_mul_ps(p, sz), pcz = _mm256_mul_ps(p, cz);
+                    const __m256 qsz = _mm256_mul_ps(q, sz), qcz = _mm256_mul_ps(q, cz);
+                    const __m256 rsz = _mm256_mul_ps(r, sz), rcz = _mm256_mul_ps(r, cz);
+                    const __m256 usz = _mm256_mul_ps(u, sz), ucz = _mm256_mul_ps(u, cz);
+                    const __m256 g = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(psz, qcz), rcz), usz);
+                    const __m256 gx = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(rsz, ucz), pcz), qsz);
+                    const __m256 gy = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(qsz, ucz), pcz), rsz);
+                    const __m256 gz = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(pcz, qsz), rsz), ucz);
+                    d = finish8(g, _mm256_add_ps(_mm256_add_ps(sq(gx), sq(gy)), sq(gz)), inv_k,
+                                half_wall);
+                    break;
+                }
+            }
+            _mm256_storeu_ps(row, d);
+        }
+    }
+}
+
+#endif
+
+// ---------- dispatch ----------
+
+bool tpms_kernel_supported(TpmsKernel kernel) {
+    switch (kernel) {
+        case TpmsKernel::Auto:
+        case TpmsKernel::Scalar:
+            return true;
+#if GENMESH_X86
+        case TpmsKernel::Avx2:
+            return cpu_features().avx2;
+#else
+        default:
+            return false;
+#endif
+    }
+    return false;
+}
+
+static TpmsKernel resolve_auto() {
+    static const TpmsKernel best =
+        tpms_kernel_supported(TpmsKernel::Avx2) ? TpmsKernel::Avx2 : TpmsKernel::Scalar;
+    return best;
+}
+
+const char* tpms_kernel_name() {
+    return resolve_auto() == TpmsKernel::Avx2 ? "avx2" : "scalar";
+}
+
+float tpms_distance(const TpmsParams& params, double x, double y, double z) {
+    // the first voxel of a block at (x, y, z): same tables and arithmetic
+    AxisTable tx, ty, tz;
+    const double k = kTwoPi / params.cell_mm;
+    axis_table(k, x, 0.0, 1, tx);
+    axis_table(k, y, 0.0, 1, ty);
+    axis_table(k, z, 0.0, 1, tz);
+    return voxel_scalar(params.surface, tx.s[0], tx.c[0], ty.s[0], ty.c[0], tz.s[0], tz.c[0],
+                        static_cast<float>(1.0 / k), 0.5f * params.wall_mm);
+}
+
+void tpms_block(const TpmsParams& params, const std::array<double, 3>& origin, double voxel,
+                float* out, TpmsKernel kernel) {
+    if (kernel == TpmsKernel::Auto) {
+        kernel = resolve_auto();
+    } else if (!tpms_kernel_supported(kernel)) {
+        kernel = TpmsKernel::Scalar;
+    }
+
+    const BlockSetup b = block_setup(params, origin, voxel);
+    switch (kernel) {
+#if GENMESH_X86
+        case TpmsKernel::Avx2: block_avx2(params.surface, b, out); break;
+#endif
+        default:               block_scalar(params.surface, b, out); break;
+    }
+}
+
+}  // namespace genmesh
@@ -0,0 +1,112 @@
+#include "genmesh/uniform_block.h"
+#include "genmesh/cpu_features.h"
+
+#include <cstddef>
+#include <cstring>
+
+#if GENMESH_X86
+#include <immintrin.h>
+#endif
+
+namespace genmesh {
+
+static constexpr int kDim = kUniformBlockDim;
+
+static const float* block_row(const float* src, int B, int ox, int oy, int oz, int y, int z) {
+    return src + static_cast<size_t>(ox) +
+           static_cast<size_t>(B) * (static_cast<size_t>(oy + y) +
+                                     static_cast<size_t>(B) * static_cast<size_t>(oz + z));
+}
+
+// ---------- scalar ----------
+
+static bool uniform_scalar(const float* src, int B, int ox, int oy, int oz, uint32_t ref) {
+    for (int z = 0; z < kDim; ++z) {
+        for (int y = 0; y < kDim; ++y) {
+            uint32_t row[kDim];
+            std::memcpy(row, block_row(src, B, ox, oy, oz, y, z), sizeof(row));
+            uint32_t diff = 0;
+            for (int x = 0; x < kDim; ++x) diff |= row[x] ^ ref;
+            if (diff != 0) return false;
+        }
+    }
+    return true;
+}
+
+// ---------- x86 SIMD ----------
+
+#if GENMESH_X86
+
+// Rows are 8 floats = one YMM register. XOR against the reference bits and
+// OR the differences of a whole 8x8 slice before testing, so the branch is
+// taken once per 8 loads.
+GENMESH_TARGET("avx2")
+static bool uniform_avx2(const float* src, int B, int ox, int oy, int oz, uint32_t ref) {
+    const __m256i want = _mm256_set1_epi32(static_cast<int>(ref));
+    for (int z = 0; z < kDim; ++z) {
+        __m256i diff = _mm256_setzero_si256();
+        for (int y = 0; y < kDim; ++y) {
+            const __m256i row = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(block_row(src, B, ox, oy, oz, y, z)));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(row, want));
+        }
+        if (!_mm256_testz_si256(diff, diff)) return false;
+    }
+    return true;
+}
+
+#endif
+
+// ---------- dispatch ----------
+
+bool uniform_kernel_supported(UniformKernel kernel) {
+    switch (kernel) {
+        case UniformKernel::Auto:
+        case UniformKernel::Scalar:
+            return true;
+#if GENMESH_X86
+        case UniformKernel::Avx2:
+            return cpu_features().avx2;
+#else
+        default:
+            return false;
+#endif
+    }
+    return false;
+}
+
+static UniformKernel resolve_auto() {
+    static const UniformKernel best = uniform_kernel_supported(UniformKernel::Avx2)
+                                          ? UniformKernel::Avx2
+                                          : UniformKernel::Scalar;
+    return best;
+}
+
+const char* uniform_kernel_name() {
+    return resolve_auto() == UniformKernel::Avx2 ? "avx2" : "scalar";
+}
+
+bool uniform_block(const float* src, int B, int ox, int oy, int oz, float& value,
+                   UniformKernel kernel) {
+    if (kernel == UniformKernel::Auto) {
+        kernel = resolve_auto();
+    } else if (!uniform_kernel_supported(kernel)) {
+        kernel = UniformKernel::Scalar;
+    }
+
+    const float first = *block_row(src, B, ox, oy, oz, 0, 0);
+    uint32_t ref;
+    std::memcpy(&ref, &first, sizeof(ref));
+
+    bool uniform;
+    switch (kernel) {
+#if GENMESH_X86
+        case UniformKernel::Avx2: uniform = uniform_avx2(src, B, ox, oy, oz, ref); break;
+#endif
+        default:                  uniform = uniform_scalar(src, B, ox, oy, oz, ref); break;
+    }
+    if (uniform) value = first;
+    return uniform;
+}
+
+}  // namespace genmesh
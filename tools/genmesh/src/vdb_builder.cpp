@@ -1,13 +1,34 @@
 #include "genmesh/vdb_builder.h"
 #include "genmesh/error_code.h"
 #include "genmesh/log.h"
+#include "genmesh/tpms.h"
+#include "genmesh/uniform_block.h"
 
 #include <openvdb/openvdb.h>
 #include <openvdb/math/Transform.h>
+#include <openvdb/tools/Clip.h>
+#include <openvdb/tools/Composite.h>
+#include <openvdb/tools/FastSweeping.h>
 #include <openvdb/tools/LevelSetFilter.h>
+#include <openvdb/tools/LevelSetTubes.h>
+#include <openvdb/tools/LevelSetUtil.h>
+#include <openvdb/tools/Prune.h>
+#include <openvdb/tools/SignedFloodFill.h>
+#include <openvdb/tools/ValueTransformer.h>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
+#include <memory>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace genmesh {
 
@@ -47,9 +68,220 @@ openvdb::FloatGrid::Ptr create_grid(const Manifest& manifest) {
     return grid;
 }
 
-VdbBuildResult build_vdb(const Manifest& manifest,
-                         const std::vector<BrickData>& bricks) {
-    VdbBuildResult result;
+using LeafT = openvdb::FloatTree::LeafNodeType;
+constexpr int kLeafDim = static_cast<int>(LeafT::DIM);  // 8
+
+/// Which brick voxels become active. Dense: everything but the background
+/// value. Narrow band: only values within `band` of `surface`; the others are
+/// left to signedFloodFill.
+struct VoxelFilter {
+    float bg = 0.0f;
+    bool narrow_band = false;
+    float surface = 0.0f;
+    float band = 0.0f;
+
+    bool active(float v) const {
+        if (narrow_band) return std::fabs(v - surface) <= band;
+        return v != bg;
+    }
+};
+
+/// Per-thread build counters.
+struct BuildCounts {
+    int64_t set = 0;          // active voxels written
+    int64_t skipped_bg = 0;   // voxels equal to the background
+    int64_t outside_band = 0; // narrow band: voxels left inactive
+    int64_t uniform_tiles = 0;  // uniform 8^3 blocks stored as tiles instead of leaves
+    int64_t outside_dims = 0;   // voxels of boundary bricks past manifest.dims, not read
+
+    void skip(float v, float bg) {
+        if (v == bg) ++skipped_bg;
+        else ++outside_band;
+    }
+};
+
+/// A uniform 8^3 block, added to the grid as an active leaf-level tile after
+/// the merge.
+struct UniformTile {
+    openvdb::Coord origin;
+    float value;
+};
+
+/// Voxels of a brick that lie inside manifest.dims, per axis (<= B; less
+/// only for the last brick on an axis when dims is not a multiple of B).
+struct BrickExtent {
+    int x;
+    int y;
+    int z;
+};
+
+/// Build the leaf at brick-local (ox, oy, oz) from x-fastest brick values,
+/// reading only the first nx * ny * nz voxels of it (the in-domain part).
+/// Only voxels passing `filter` are written (and active); returns nullptr
+/// if there are none.
+///
+/// kB > 0 fixes the brick size at compile time so the row strides are
+/// constants; kB == 0 takes it from `brick_size`.
+template <int kB>
+static LeafT* make_leaf(const float* src, int brick_size, int ox, int oy, int oz,
+                        int nx, int ny, int nz, const VoxelFilter& filter,
+                        const openvdb::Coord& origin, BuildCounts& counts) {
+    const size_t B = static_cast<size_t>(kB > 0 ? kB : brick_size);
+    std::unique_ptr<LeafT> leaf;
+    for (int z = 0; z < nz; ++z) {
+        for (int y = 0; y < ny; ++y) {
+            const float* row = src + static_cast<size_t>(ox) +
+                               B * (static_cast<size_t>(oy + y) + B * static_cast<size_t>(oz + z));
+            for (int x = 0; x < nx; ++x) {
+                const float val = row[x];
+                if (!filter.active(val)) {
+                    counts.skip(val, filter.bg);
+                    continue;
+                }
+                if (!leaf) leaf = std::make_unique<LeafT>(origin, filter.bg, false);
+                // leaf layout is z-fastest: offset = x*64 + y*8 + z
+                const openvdb::Index n = LeafT::coordToOffset(openvdb::Coord(x, y, z));
+                leaf->buffer().setValue(n, val);
+                leaf->getValueMask().setOn(n);
+                ++counts.set;
+            }
+        }
+    }
+    return leaf.release();
+}
+
+/// Write the in-domain part of one voxel brick into `tree`: whole leaves
+/// when B is a multiple of 8 (leaves without active voxels are never
+/// created), per-voxel otherwise. Voxels past `dims` are not read.
+/// Uniform leaf-sized blocks become `tiles` instead: the exact collapse of
+/// the leaf they replace, active exactly when its voxels would be
+/// (`filter`), and dropped when that leaf would not exist.
+template <int kB>
+static void insert_brick(openvdb::FloatTree& tree, std::vector<UniformTile>& tiles,
+                         const BrickView& brick, int brick_size,
+                         const std::array<int, 3>& dims, const VoxelFilter& filter,
+                         BuildCounts& counts) {
+    const int B = kB > 0 ? kB : brick_size;
+    const float* src = brick.values;
+    const int base_x = brick.bx * B;
+    const int base_y = brick.by * B;
+    const int base_z = brick.bz * B;
+    const BrickExtent ext{std::min(B, dims[0] - base_x), std::min(B, dims[1] - base_y),
+                          std::min(B, dims[2] - base_z)};
+    if (ext.x <= 0 || ext.y <= 0 || ext.z <= 0) {
+        counts.outside_dims += static_cast<int64_t>(B) * B * B;
+        return;
+    }
+    counts.outside_dims += static_cast<int64_t>(B) * B * B -
+                           static_cast<int64_t>(ext.x) * ext.y * ext.z;
+
+    // B is a multiple of 8: the brick covers (B/8)^3 whole leaf nodes.
+    // Fill each leaf's buffer and value mask directly and hand it to the tree.
+    if (B % kLeafDim == 0) {
+        for (int oz = 0; oz < ext.z; oz += kLeafDim) {
+            const int nz = std::min(kLeafDim, ext.z - oz);
+            for (int oy = 0; oy < ext.y; oy += kLeafDim) {
+                const int ny = std::min(kLeafDim, ext.y - oy);
+                for (int ox = 0; ox < ext.x; ox += kLeafDim) {
+                    const int nx = std::min(kLeafDim, ext.x - ox);
+                    const openvdb::Coord origin(base_x + ox, base_y + oy, base_z + oz);
+                    const bool full = nx == kLeafDim && ny == kLeafDim && nz == kLeafDim;
+                    float value;
+                    if (full && uniform_block(src, B, ox, oy, oz, value)) {
+                        const bool active = filter.active(value);
+                        if (value == filter.bg || !active) {
+                            (value == filter.bg ? counts.skipped_bg : counts.outside_band) +=
+                                LeafT::SIZE;
+                            continue;
+                        }
+                        tiles.push_back({origin, value});
+                        ++counts.uniform_tiles;
+                        counts.set += LeafT::SIZE;
+                        continue;
+                    }
+                    auto* leaf = make_leaf<kB>(src, B, ox, oy, oz, nx, ny, nz, filter, origin,
+                                               counts);
+                    if (leaf) tree.addLeaf(leaf);
+                }
+            }
+        }
+        return;
+    }
+
+    openvdb::tree::ValueAccessor<openvdb::FloatTree> accessor(tree);
+    for (int lz = 0; lz < ext.z; ++lz) {
+        for (int ly = 0; ly < ext.y; ++ly) {
+            for (int lx = 0; lx < ext.x; ++lx) {
+                // x-fastest: index = lx + B*(ly + B*lz)
+                size_t idx = static_cast<size_t>(lx + B * (ly + B * lz));
+                float val = src[idx];
+
+                // Skip background values (they are the grid default) and,
+                // in narrow-band mode, everything outside the band
+                if (!filter.active(val)) {
+                    counts.skip(val, filter.bg);
+                    continue;
+                }
+
+                openvdb::Coord ijk(base_x + lx, base_y + ly, base_z + lz);
+                accessor.setValue(ijk, val);
+                ++counts.set;
+            }
+        }
+    }
+}
+
+using InsertBrickFn = void (*)(openvdb::FloatTree&, std::vector<UniformTile>&, const BrickView&,
+                               int, const std::array<int, 3>&, const VoxelFilter&,
+                               BuildCounts&);
+
+/// insert_brick specialized for the brick sizes the spec allows (§5.3).
+static InsertBrickFn insert_brick_for(int B) {
+    switch (B) {
+        case 32:  return &insert_brick<32>;
+        case 64:  return &insert_brick<64>;
+        case 128: return &insert_brick<128>;
+        default:  return &insert_brick<0>;
+    }
+}
+
+/// A constant brick, filled into the grid after the merge.
+struct ConstantBrick {
+    int bx;
+    int by;
+    int bz;
+    float value;
+};
+
+/// Voxel bricks are built by whichever thread adds them, each into its
+/// thread's own tree; the trees hold only leaves and are merged in finish().
+/// Bricks never overlap, so the merged tree does not depend on the split.
+struct LocalTree {
+    openvdb::FloatTree tree;
+    std::vector<UniformTile> tiles;
+    std::vector<ConstantBrick> constants;
+    std::vector<float> scratch;  // f16 bricks widened one at a time
+    BuildCounts counts;
+    int64_t bricks = 0;
+    explicit LocalTree(float background) : tree(background) {}
+};
+
+struct VdbStreamBuilder::State {
+    Manifest manifest;
+    VdbBuildResult result;  // holds the grid, or the grid creation error
+    float bg = 0.0f;
+    float band = 0.0f;
+    InsertBrickFn insert = nullptr;
+    VoxelFilter filter;
+    tbb::enumerable_thread_specific<LocalTree> locals;
+
+    explicit State(const Manifest& m)
+        : manifest(m), locals([bg = m.background_value_mm] { return LocalTree(bg); }) {}
+};
+
+VdbStreamBuilder::VdbStreamBuilder(const Manifest& manifest, const VdbBuildOptions& options)
+    : state_(std::make_unique<State>(manifest)) {
+    VdbBuildResult& result = state_->result;
 
     // Create grid
     try {
@@ -60,7 +292,7 @@ VdbBuildResult build_vdb(const Manifest& manifest,
         result.error_code = std::string(E4001);
         result.error_msg = std::string("Grid creation failed: ") + e.what();
         log_error(E4001, result.error_msg);
-        return result;
+        return;
     }
 
     if (!result.grid) {
@@ -69,51 +301,165 @@ VdbBuildResult build_vdb(const Manifest& manifest,
         result.error_code = std::string(E4001);
         result.error_msg = "Grid creation returned null";
         log_error(E4001, result.error_msg);
-        return result;
+        return;
     }
 
+    state_->bg = manifest.background_value_mm;
+    state_->band = static_cast<float>(manifest.half_width_voxels) * manifest.voxel_size;
+    state_->insert = insert_brick_for(manifest.brick_size);
+
+    VoxelFilter& filter = state_->filter;
+    filter.bg = state_->bg;
+    if (options.narrow_band) {
+        // Same surface and band as classify_brick(): the offset filter later
+        // moves the surface by offset_mm and needs the band around both.
+        filter.surface = manifest.iso + manifest.offset_mm;
+        filter.band = state_->band + std::fabs(manifest.offset_mm);
+        // signedFloodFill takes the inside/outside sign of a voxel from its
+        // value, so the band has to straddle 0.
+        if (std::fabs(filter.surface) < filter.band && filter.bg > filter.band) {
+            filter.narrow_band = true;
+        } else {
+            log_warn(W4001, "Narrow band needs the iso surface within the band around 0; "
+                            "building a dense grid", {
+                {"iso", std::to_string(manifest.iso)},
+                {"offset_mm", std::to_string(manifest.offset_mm)},
+                {"band_mm", std::to_string(filter.band)},
+            });
+        }
+    }
+    result.narrow_band = filter.narrow_band;
+}
+
+VdbStreamBuilder::~VdbStreamBuilder() = default;
+
+void VdbStreamBuilder::add(const BrickData& brick) {
+    add(brick_view(brick, state_->locals.local().scratch));
+}
+
+void VdbStreamBuilder::add(const BrickView& brick) {
+    State& st = *state_;
+    if (!st.result.grid) return;
+    LocalTree& local = st.locals.local();
+    ++local.bricks;
+    if (brick.constant) {
+        local.constants.push_back({brick.bx, brick.by, brick.bz, *brick.constant});
+        return;
+    }
+    st.insert(local.tree, local.tiles, brick, st.manifest.brick_size, st.manifest.dims, st.filter,
+              local.counts);
+}
+
+VdbBuildResult VdbStreamBuilder::finish() {
+    State& st = *state_;
+    VdbBuildResult result = std::move(st.result);
+    if (!result.grid) return result;
+
+    const Manifest& manifest = st.manifest;
     const int B = manifest.brick_size;
-    const float bg = manifest.background_value_mm;
+    const float bg = st.bg;
+    const VoxelFilter& filter = st.filter;
 
-    // Use an accessor for efficient voxel insertion
-    auto accessor = result.grid->getAccessor();
+    BuildCounts counts;
+    int64_t bricks = 0;
+    std::vector<ConstantBrick> constants;
 
-    int64_t total_set = 0;
-    int64_t skipped_bg = 0;
+    auto& tree = result.grid->tree();
+    for (auto& local : st.locals) {
+        // Local trees hold leaves only. Leaves new to `tree` are moved over;
+        // with B < 8 two threads can share a leaf, and since bricks are
+        // disjoint the active voxels of both simply combine.
+        tree.merge(local.tree, openvdb::MERGE_ACTIVE_STATES);
+        counts.set += local.counts.set;
+        counts.skipped_bg += local.counts.skipped_bg;
+        counts.outside_band += local.counts.outside_band;
+        counts.uniform_tiles += local.counts.uniform_tiles;
+        counts.outside_dims += local.counts.outside_dims;
+        bricks += local.bricks;
+        constants.insert(constants.end(), local.constants.begin(), local.constants.end());
+    }
+    // Uniform blocks are added only now, once the leaves of every thread
+    // are in one tree
+    for (const auto& local : st.locals) {
+        for (const auto& t : local.tiles) {
+            tree.addTile(1, t.origin, t.value, true);
+        }
+    }
+    st.locals.clear();
 
-    for (const auto& brick : bricks) {
+    // "constant" bricks: one fill instead of B^3 setValue calls. OpenVDB
+    // keeps it as tiles wherever the box covers whole nodes. Active exactly
+    // when the same values written as voxels would be (VoxelFilter), so a
+    // field gives the same tree whether stored raw or constant; with the
+    // narrow band, interiors become inactive -background tiles. Filled after
+    // the merge because Tree::merge does not carry inactive tiles over, in
+    // brick coordinate order so the fill does not depend on arrival order.
+    std::sort(constants.begin(), constants.end(),
+              [](const ConstantBrick& a, const ConstantBrick& b) {
+                  return std::tie(a.bz, a.by, a.bx) < std::tie(b.bz, b.by, b.bx);
+              });
+    int64_t constant_bricks = 0;
+    for (const auto& brick : constants) {
+        const float val = brick.value;
         const int base_x = brick.bx * B;
         const int base_y = brick.by * B;
         const int base_z = brick.bz * B;
-
-        for (int lz = 0; lz < B; ++lz) {
-            for (int ly = 0; ly < B; ++ly) {
-                for (int lx = 0; lx < B; ++lx) {
-                    // x-fastest: index = lx + B*(ly + B*lz)
-                    size_t idx = static_cast<size_t>(lx + B * (ly + B * lz));
-                    float val = brick.values[idx];
-
-                    // Skip background values (they are the grid default)
-                    if (val == bg) {
-                        ++skipped_bg;
-                        continue;
-                    }
-
-                    openvdb::Coord ijk(base_x + lx, base_y + ly, base_z + lz);
-                    accessor.setValue(ijk, val);
-                    ++total_set;
-                }
+        // clipped to dims like voxel bricks
+        const openvdb::CoordBBox box(
+            openvdb::Coord(base_x, base_y, base_z),
+            openvdb::Coord(std::min(base_x + B, manifest.dims[0]) - 1,
+                           std::min(base_y + B, manifest.dims[1]) - 1,
+                           std::min(base_z + B, manifest.dims[2]) - 1));
+        if (box.empty()) continue;
+        const int64_t brick_voxels = static_cast<int64_t>(box.volume());
+        counts.outside_dims += static_cast<int64_t>(B) * B * B - brick_voxels;
+        if (val == bg) {
+            counts.skipped_bg += brick_voxels;
+            continue;
+        }
+        const bool active = filter.active(val);
+        if (filter.narrow_band) {
+            // outside: background already; inside: signedFloodFill reaches it
+            // only through neighbouring leaves, so fill it here
+            if (!active && val > filter.surface) {
+                counts.outside_band += brick_voxels;
+                continue;
             }
         }
+        tree.fill(box, filter.narrow_band && !active ? -bg : val, active);
+        ++constant_bricks;
+    }
+
+    // Inactive voxels and tiles take +/-background by the side of the
+    // surface they are on, as the level set tools expect.
+    if (filter.narrow_band) {
+        openvdb::tools::signedFloodFill(tree);
     }
 
+    // Internal nodes whose children are now all the same tile collapse into
+    // one tile of the parent (lossless: tolerance 0).
+    tree.prune();
+
     result.active_voxel_count = static_cast<int64_t>(result.grid->activeVoxelCount());
+    result.brick_count = bricks;
+    result.leaf_count = static_cast<int64_t>(tree.leafCount());
+    result.uniform_tiles = counts.uniform_tiles;
+    result.memory_bytes = static_cast<int64_t>(tree.memUsage());
+    result.memory_saved_bytes =
+        counts.uniform_tiles * static_cast<int64_t>(LeafT(openvdb::Coord(0), bg).memUsage());
 
     log_info("GENMESH_I0002", "VDB grid built", {
         {"active_voxels", std::to_string(result.active_voxel_count)},
-        {"set_voxels", std::to_string(total_set)},
-        {"skipped_bg", std::to_string(skipped_bg)},
-        {"bricks", std::to_string(bricks.size())},
+        {"set_voxels", std::to_string(counts.set)},
+        {"skipped_bg", std::to_string(counts.skipped_bg)},
+        {"outside_band", std::to_string(counts.outside_band)},
+        {"constant_bricks", std::to_string(constant_bricks)},
+        {"leaves", std::to_string(result.leaf_count)},
+        {"uniform_tiles", std::to_string(counts.uniform_tiles)},
+        {"outside_dims", std::to_string(counts.outside_dims)},
+        {"memory_bytes", std::to_string(result.memory_bytes)},
+        {"narrow_band", filter.narrow_band ? "true" : "false"},
+        {"bricks", std::to_string(bricks)},
     });
 
     result.ok = true;
@@ -121,6 +467,23 @@ VdbBuildResult build_vdb(const Manifest& manifest,
     return result;
 }
 
+VdbBuildResult build_vdb(const Manifest& manifest,
+                         const std::vector<BrickData>& bricks,
+                         const VdbBuildOptions& options) {
+    VdbStreamBuilder builder(manifest, options);
+    if (options.parallel && bricks.size() > 1) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, bricks.size(), 1),
+                          [&](const tbb::blocked_range<size_t>& r) {
+                              for (size_t i = r.begin(); i != r.end(); ++i) {
+                                  builder.add(bricks[i]);
+                              }
+                          });
+    } else {
+        for (const auto& brick : bricks) builder.add(brick);
+    }
+    return builder.finish();
+}
+
 bool apply_offset(openvdb::FloatGrid::Ptr& grid, float offset_mm) {
     if (!grid) {
         log_error(E4001, "Cannot apply offset to null grid");
@@ -155,4 +518,283 @@ bool apply_offset(openvdb::FloatGrid::Ptr& grid, float offset_mm) {
     }
 }
 
+const char* offset_method_name(OffsetMethod method) {
+    switch (method) {
+        case OffsetMethod::Shift: return "shift";
+        case OffsetMethod::Sweep: return "sweep";
+        default:                  return "none";
+    }
+}
+
+OffsetResult offset_grid(openvdb::FloatGrid::Ptr& grid, float offset_mm, float band_mm) {
+    const auto t0 = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0)
+            .count();
+    };
+
+    OffsetResult result;
+    if (!grid) {
+        log_error(E4001, "Cannot apply offset to null grid");
+        return result;
+    }
+    if (offset_mm == 0.0f) {
+        result.ok = true;
+        return result;
+    }
+
+    const float voxel = static_cast<float>(grid->voxelSize()[0]);
+    const float reach = std::fabs(offset_mm) + voxel;
+    if (reach <= band_mm) {
+        result.method = OffsetMethod::Shift;
+        result.ok = apply_offset(grid, offset_mm);
+        result.ms = elapsed_ms();
+        return result;
+    }
+
+    // The moved surface, plus the voxel the mesher reads past it, lies
+    // outside the band: grow the band on that side (outside for dilation,
+    // inside for erosion) by fast sweeping from the existing values, by
+    // |offset_mm| so a full band is left on both sides of the moved surface.
+    result.method = OffsetMethod::Sweep;
+    result.dilated_voxels = static_cast<int>(std::ceil(std::fabs(offset_mm) / voxel));
+    try {
+        const float bg = grid->background();
+        // Only the band is trustworthy. A dense grid also holds real values
+        // past it (clamped interiors, inactive constant and uniform tiles)
+        // that a shift would not move consistently: reduce it to a narrow
+        // band of -/+background first.
+        auto trim = [band_mm, bg](const openvdb::FloatGrid::ValueAllIter& it) {
+            const float v = *it;
+            if (std::fabs(v) < band_mm) return;
+            it.setValue(v < 0.0f ? -bg : bg);
+            it.setValueOff();
+        };
+        openvdb::tools::foreach(grid->beginValueAll(), trim);
+        openvdb::tools::pruneLevelSet(grid->tree());
+
+        const auto side = offset_mm > 0.0f
+                              ? openvdb::tools::FastSweepingDomain::SWEEP_GREATER_THAN_ISOVALUE
+                              : openvdb::tools::FastSweepingDomain::SWEEP_LESS_THAN_ISOVALUE;
+        auto dilated = openvdb::tools::dilateSdf(*grid, result.dilated_voxels,
+                                                 openvdb::tools::NN_FACE, 1, side);
+        if (!dilated) {
+            log_error(E4001, "tools::dilateSdf returned no grid");
+            return result;
+        }
+        // Shift the band (everything else is -/+background now, on the
+        // right side of the moved surface), then trim it back to a
+        // symmetric +/-band_mm around the new surface.
+        auto shift = [offset_mm, band_mm, bg](const openvdb::FloatGrid::ValueOnIter& it) {
+            const float v = *it - offset_mm;
+            if (std::fabs(v) < band_mm) {
+                it.setValue(v);
+            } else {
+                it.setValue(v < 0.0f ? -bg : bg);
+                it.setValueOff();
+            }
+        };
+        openvdb::tools::foreach(dilated->beginValueOn(), shift);
+        openvdb::tools::pruneLevelSet(dilated->tree());
+        dilated->setName(grid->getName());
+        grid = dilated;
+    } catch (const std::exception& e) {
+        log_error(E4001, std::string("tools::dilateSdf failed: ") + e.what());
+        return result;
+    }
+
+    result.ok = true;
+    result.ms = elapsed_ms();
+    log_info("GENMESH_I0003", "Applied level set offset", {
+        {"offset_mm", std::to_string(offset_mm)},
+        {"method", offset_method_name(result.method)},
+        {"dilated_voxels", std::to_string(result.dilated_voxels)},
+        {"active_voxels", std::to_string(grid->activeVoxelCount())},
+    });
+    return result;
+}
+
+/// Level set of the capsule `hole` on `like`'s transform and background,
+/// built by tools::createLevelSetCapsule (threaded, only the band of
+/// `half_width` voxels is evaluated).
+static openvdb::FloatGrid::Ptr capsule_level_set(const openvdb::FloatGrid& like,
+                                                 const DrainHole& hole, int half_width) {
+    // createLevelSetCapsule uses a plain scale transform: express the end
+    // points in that frame so the result lines up with `like`'s voxels.
+    const auto& xf = like.transform();
+    const double voxel = like.voxelSize()[0];
+    auto to_frame = [&](const std::array<float, 3>& p) {
+        return openvdb::Vec3s(xf.worldToIndex(openvdb::Vec3d(p[0], p[1], p[2])) * voxel);
+    };
+    auto grid = openvdb::tools::createLevelSetCapsule<openvdb::FloatGrid>(
+        to_frame(hole.from), to_frame(hole.to), hole.radius_mm, static_cast<float>(voxel),
+        static_cast<float>(half_width));
+    grid->setTransform(xf.copy());
+    openvdb::tools::changeLevelSetBackground(grid->tree(), like.background());
+    return grid;
+}
+
+/// Level set of the sheet TPMS `params` on `solid`'s transform, evaluated
+/// only in the leaves covering `solid` (its narrow band and interior mask).
+/// Each leaf is one tpms_block() call; leaves whose center is far from the
+/// surface are skipped, and voxels within `band_mm` of it are active.
+/// `leaves` receives the number of leaves kept.
+static openvdb::FloatGrid::Ptr infill_level_set(const openvdb::FloatGrid& solid,
+                                                const TpmsParams& params, float band_mm,
+                                                int64_t& leaves) {
+    auto grid = openvdb::FloatGrid::create(solid.background());
+    grid->setTransform(solid.transform().copy());
+    grid->setGridClass(openvdb::GRID_LEVEL_SET);
+    const float bg = solid.background();
+    const auto& xf = grid->transform();
+    const double voxel = solid.voxelSize()[0];
+
+    // Leaf origins: the band's leaves plus the interior, whose tiles are
+    // split into leaf-sized blocks without voxelizing the mask.
+    auto interior = openvdb::tools::sdfInteriorMask(solid);
+    openvdb::MaskTree mask;
+    mask.topologyUnion(interior->tree());
+    mask.topologyUnion(solid.tree());
+    std::vector<openvdb::Coord> origins;
+    for (auto leaf = mask.cbeginLeaf(); leaf; ++leaf) origins.push_back(leaf->origin());
+    auto tile = mask.cbeginValueOn();
+    tile.setMaxDepth(openvdb::MaskTree::ValueOnCIter::LEAF_DEPTH - 1);
+    for (; tile; ++tile) {
+        openvdb::CoordBBox bbox;
+        tile.getBoundingBox(bbox);
+        for (int x = bbox.min().x(); x <= bbox.max().x(); x += kLeafDim)
+            for (int y = bbox.min().y(); y <= bbox.max().y(); y += kLeafDim)
+                for (int z = bbox.min().z(); z <= bbox.max().z(); z += kLeafDim)
+                    origins.emplace_back(x, y, z);
+    }
+
+    // Skip test: the estimate at the leaf center against the band widened
+    // by the leaf's half-diagonal, doubled since the estimate is only
+    // first-order away from the surface.
+    const double half = 0.5 * (kLeafDim - 1);
+    const float reach =
+        band_mm + static_cast<float>(2.0 * std::sqrt(3.0) * half * voxel + voxel);
+    std::vector<LeafT*> built(origins.size(), nullptr);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, origins.size(), 64),
+                      [&](const tbb::blocked_range<size_t>& r) {
+        float values[LeafT::SIZE];
+        for (size_t n = r.begin(); n < r.end(); ++n) {
+            const openvdb::Vec3d o = xf.indexToWorld(origins[n]);
+            const openvdb::Vec3d c =
+                xf.indexToWorld(origins[n].asVec3d() + openvdb::Vec3d(half));
+            if (std::fabs(tpms_distance(params, c[0], c[1], c[2])) > reach) continue;
+
+            tpms_block(params, {o[0], o[1], o[2]}, voxel, values);
+            auto* leaf = new LeafT(origins[n], bg, false);
+            for (openvdb::Index i = 0; i < LeafT::SIZE; ++i) {
+                const float v = values[i];
+                if (std::fabs(v) < band_mm) {
+                    leaf->setValueOn(i, v);
+                } else {
+                    leaf->setValueOff(i, v < 0.0f ? -bg : bg);
+                }
+            }
+            if (leaf->isEmpty()) {
+                delete leaf;
+                continue;
+            }
+            built[n] = leaf;
+        }
+    });
+
+    leaves = 0;
+    for (auto* leaf : built) {
+        if (!leaf) continue;
+        grid->tree().addLeaf(leaf);
+        ++leaves;
+    }
+    openvdb::tools::signedFloodFill(grid->tree());
+    return grid;
+}
+
+ShellResult make_shell(openvdb::FloatGrid::Ptr& grid, float thickness_mm,
+                       const std::vector<DrainHole>& holes, float band_mm,
+                       const std::optional<TpmsParams>& infill) {
+    const auto t0 = std::chrono::steady_clock::now();
+    ShellResult result;
+    if (!grid) {
+        log_error(E4001, "Cannot hollow null grid");
+        return result;
+    }
+
+    try {
+        // Inner surface: the solid eroded by the wall thickness
+        openvdb::FloatGrid::Ptr inner = grid->deepCopy();
+        const auto erode = offset_grid(inner, -thickness_mm, band_mm);
+        if (!erode.ok) return result;
+        result.erode_method = erode.method;
+
+        // Lattice clipped to the cavity, generated before the cavity is
+        // consumed by the subtraction
+        openvdb::FloatGrid::Ptr lattice;
+        if (infill) {
+            const auto ti = std::chrono::steady_clock::now();
+            lattice = infill_level_set(*inner, *infill, band_mm, result.infill_leaves);
+            auto cavity = inner->deepCopy();
+            openvdb::tools::csgIntersection(*lattice, *cavity);
+            result.infill_ms = std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() - ti)
+                                   .count();
+        }
+
+        openvdb::tools::csgDifference(*grid, *inner);
+        if (lattice) openvdb::tools::csgUnion(*grid, *lattice);
+
+        const float voxel = static_cast<float>(grid->voxelSize()[0]);
+        const int half_width = std::max(3, static_cast<int>(std::ceil(band_mm / voxel)));
+        for (const auto& hole : holes) {
+            auto capsule = capsule_level_set(*grid, hole, half_width);
+            openvdb::tools::csgDifference(*grid, *capsule);
+            ++result.drain_holes;
+        }
+    } catch (const std::exception& e) {
+        log_error(E4001, std::string("Shell failed: ") + e.what());
+        return result;
+    }
+
+    result.ok = true;
+    result.ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    log_info("GENMESH_I0015", "Hollowed to shell", {
+        {"thickness_mm", std::to_string(thickness_mm)},
+        {"erode_method", offset_method_name(result.erode_method)},
+        {"drain_holes", std::to_string(result.drain_holes)},
+        {"infill", infill ? tpms_surface_name(infill->surface) : "none"},
+        {"infill_leaves", std::to_string(result.infill_leaves)},
+        {"active_voxels", std::to_string(grid->activeVoxelCount())},
+    });
+    return result;
+}
+
+bool clip_grid(openvdb::FloatGrid::Ptr& grid, const WorldBox& box) {
+    if (!grid) {
+        log_error(E4001, "Cannot clip null grid");
+        return false;
+    }
+
+    try {
+        const openvdb::BBoxd bbox(openvdb::Vec3d(box.min[0], box.min[1], box.min[2]),
+                                  openvdb::Vec3d(box.max[0], box.max[1], box.max[2]));
+        auto clipped = openvdb::tools::clip(*grid, bbox);
+        clipped->setName(grid->getName());
+
+        log_info("GENMESH_I0013", "Clipped grid to bbox", {
+            {"active_voxels_before", std::to_string(grid->activeVoxelCount())},
+            {"active_voxels", std::to_string(clipped->activeVoxelCount())},
+        });
+
+        grid = std::move(clipped);
+        return true;
+
+    } catch (const std::exception& e) {
+        log_error(E4001, std::string("tools::clip failed: ") + e.what());
+        return false;
+    }
+}
+
 }  // namespace genmesh
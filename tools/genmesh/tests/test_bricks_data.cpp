@@ -2,20 +2,27 @@
 //
 // Tests use brick_size=2 (2x2x2 = 8 voxels) for minimal fixtures.
 // Binary fixtures are generated programmatically in the test.
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "genmesh/brick_arena.h"
+#include "genmesh/brick_codec.h"
 #include "genmesh/bricks_data.h"
 #include "genmesh/bricks_index.h"
 #include "genmesh/error_code.h"
 #include "genmesh/log.h"
 #include "genmesh/manifest.h"
+#include "genmesh/sdf_codec.h"
 
 static genmesh::Manifest make_manifest(int B = 2, const std::string& dtype = "f32") {
     genmesh::Manifest m;
@@ -40,7 +47,7 @@ static genmesh::Manifest make_manifest(int B = 2, const std::string& dtype = "f3
     return m;
 }
 
-// CRC32 matching bricks_data.cpp implementation
+// Byte-table CRC32 reference (independent of genmesh::crc32)
 static uint32_t crc32_calc(const uint8_t* data, size_t len) {
     static uint32_t table[256] = {0};
     static bool init = false;
@@ -276,6 +283,1062 @@ void test_multiple_bricks() {
     std::cout << "  PASS: test_multiple_bricks\n";
 }
 
+// --------- mmap reader ---------
+
+static genmesh::BricksReadOptions mmap_opts() {
+    genmesh::BricksReadOptions o;
+    o.mode = genmesh::ReadMode::Mmap;
+    return o;
+}
+
+void test_mmap_f32_is_view() {
+    std::vector<float> data1 = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<float> data2 = {10, 20, 30, 40, 50, 60, 70, 80};
+    {
+        std::ofstream ofs("_t22_mmap.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(data1.data()), 32);
+        ofs.write(reinterpret_cast<const char*>(data2.data()), 32);
+    }
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {4, 2, 2};
+
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {4, 2, 2};
+    idx.bricks.push_back({0, 0, 0, 0,  32, "raw", std::nullopt});
+    idx.bricks.push_back({1, 0, 0, 32, 32, "raw", to_hex8(crc32_calc(
+        reinterpret_cast<const uint8_t*>(data2.data()), 32))});
+
+    auto r = genmesh::load_bricks_bin("_t22_mmap.bin", idx, m, mmap_opts());
+    assert(r.ok);
+    assert(r.bricks.size() == 2);
+    // f32 bricks are zero-copy views; nothing is owned
+    assert(r.bricks[0].view != nullptr);
+    assert(r.bricks[0].values.empty());
+    assert(r.bricks[0].size() == 8);
+    assert(r.bricks[1].data() == r.bricks[0].data() + 8);
+    for (int i = 0; i < 8; ++i) {
+        assert(r.bricks[0].data()[i] == data1[i]);
+        assert(r.bricks[1].data()[i] == data2[i]);
+    }
+
+    // Views stay valid after the result is moved out (mapping is shared)
+    auto bricks = std::move(r.bricks);
+    assert(bricks[1].data()[7] == 80.0f);
+
+    bricks.clear();
+    std::remove("_t22_mmap.bin");
+    std::cout << "  PASS: test_mmap_f32_is_view\n";
+}
+
+void test_mmap_f16_decoded() {
+    std::vector<float> data = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+    write_f16_bin("_t22_mmap_f16.bin", data);
+
+    auto m = make_manifest(2, "f16");
+
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f16";
+    idx.dims = {2, 2, 2};
+    idx.bricks.push_back({0, 0, 0, 0, 16, "raw", std::nullopt});
+
+    auto r = genmesh::load_bricks_bin("_t22_mmap_f16.bin", idx, m, mmap_opts());
+    assert(r.ok);
+    assert(r.bricks.size() == 1);
+    assert(r.bricks[0].view == nullptr);
+    assert(r.bricks[0].values.size() == 8);
+    for (int i = 0; i < 8; ++i) {
+        assert(std::abs(r.bricks[0].data()[i] - data[i]) < 0.01f);
+    }
+
+    std::remove("_t22_mmap_f16.bin");
+    std::cout << "  PASS: test_mmap_f16_decoded\n";
+}
+
+void test_mmap_unaligned_offset_copies() {
+    std::vector<float> data = {1, 2, 3, 4, 5, 6, 7, 8};
+    {
+        std::ofstream ofs("_t22_mmap_odd.bin", std::ios::binary);
+        ofs.put('\0');  // 1-byte pad → payload at odd offset
+        ofs.write(reinterpret_cast<const char*>(data.data()), 32);
+    }
+
+    auto m = make_manifest(2, "f32");
+
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {2, 2, 2};
+    idx.bricks.push_back({0, 0, 0, 1, 32, "raw", std::nullopt});
+
+    auto r = genmesh::load_bricks_bin("_t22_mmap_odd.bin", idx, m, mmap_opts());
+    assert(r.ok);
+    assert(r.bricks[0].view == nullptr);
+    assert(r.bricks[0].values == data);
+
+    std::remove("_t22_mmap_odd.bin");
+    std::cout << "  PASS: test_mmap_unaligned_offset_copies\n";
+}
+
+void test_mmap_errors() {
+    auto m = make_manifest(2, "f32");
+
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {2, 2, 2};
+
+    auto missing = genmesh::load_bricks_bin("nonexistent.bin", idx, m, mmap_opts());
+    assert(!missing.ok);
+    assert(missing.exit_code == genmesh::ExitCode::IoError);
+    assert(has_error_code(missing, genmesh::E2001));
+
+    std::vector<float> data = {1, 2, 3, 4, 5, 6, 7, 8};
+    write_f32_bin("_t22_mmap_err.bin", data);
+    idx.bricks.push_back({0, 0, 0, 0, 32, "raw", "deadbeef"});
+    idx.bricks.push_back({0, 0, 0, 100, 32, "raw", std::nullopt});
+
+    auto r = genmesh::load_bricks_bin("_t22_mmap_err.bin", idx, m, mmap_opts());
+    assert(!r.ok);
+    assert(r.exit_code == genmesh::ExitCode::ValidationFailure);
+    assert(r.errors.size() == 2);
+    assert(r.errors[0].code == genmesh::E1106);
+    assert(r.errors[1].code == genmesh::E1105);
+
+    std::remove("_t22_mmap_err.bin");
+    std::cout << "  PASS: test_mmap_errors\n";
+}
+
+// --------- parallel decode ---------
+
+void test_parallel_matches_serial_order() {
+    // 64 bricks of B=2, every 5th with a bad CRC, every 7th out of range
+    const int n = 64;
+    std::vector<float> all;
+    for (int i = 0; i < n * 8; ++i) all.push_back(static_cast<float>(i));
+    write_f32_bin("_t22_par.bin", all);
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {2 * n, 2, 2};
+
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {2 * n, 2, 2};
+    for (int i = 0; i < n; ++i) {
+        int64_t off = (i % 7 == 3) ? 1 << 20 : static_cast<int64_t>(i) * 32;
+        std::optional<std::string> crc;
+        if (i % 5 == 1) crc = "deadbeef";
+        idx.bricks.push_back({i, 0, 0, off, 32, "raw", crc});
+    }
+
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions serial;
+        serial.mode = mode;
+        serial.parallel = false;
+        genmesh::BricksReadOptions par = serial;
+        par.parallel = true;
+
+        auto rs = genmesh::load_bricks_bin("_t22_par.bin", idx, m, serial);
+        auto rp = genmesh::load_bricks_bin("_t22_par.bin", idx, m, par);
+        assert(!rs.ok && !rp.ok);
+
+        assert(rs.errors.size() == rp.errors.size());
+        for (size_t i = 0; i < rs.errors.size(); ++i) {
+            assert(rs.errors[i].code == rp.errors[i].code);
+            assert(rs.errors[i].message == rp.errors[i].message);
+        }
+
+        assert(rs.bricks.size() == rp.bricks.size());
+        for (size_t i = 0; i < rs.bricks.size(); ++i) {
+            assert(rs.bricks[i].bx == rp.bricks[i].bx);
+            assert(rp.bricks[i].size() == 8);
+            assert(std::memcmp(rs.bricks[i].data(), rp.bricks[i].data(), 32) == 0);
+            assert(rp.bricks[i].data()[0] == static_cast<float>(rp.bricks[i].bx * 8));
+        }
+        // surviving bricks stay in index order
+        for (size_t i = 1; i < rp.bricks.size(); ++i) {
+            assert(rp.bricks[i - 1].bx < rp.bricks[i].bx);
+        }
+    }
+
+    std::remove("_t22_par.bin");
+    std::cout << "  PASS: test_parallel_matches_serial_order\n";
+}
+
+// --------- deferred CRC verification ---------
+
+void test_deferred_crc_verification() {
+    // 3 bricks: [0] good CRC, [1] bad CRC, [2] bad CRC
+    std::vector<float> all;
+    for (int i = 0; i < 24; ++i) all.push_back(static_cast<float>(i));
+    write_f32_bin("_t22_defer.bin", all);
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {6, 2, 2};
+
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {6, 2, 2};
+    idx.bricks.push_back({0, 0, 0, 0, 32, "raw", to_hex8(crc32_calc(
+        reinterpret_cast<const uint8_t*>(all.data()), 32))});
+    idx.bricks.push_back({1, 0, 0, 32, 32, "raw", "deadbeef"});
+    idx.bricks.push_back({2, 0, 0, 64, 32, "raw", "00000000"});
+
+    genmesh::BricksReadOptions opts;
+    opts.verify_crc = false;
+    auto r = genmesh::load_bricks_bin("_t22_defer.bin", idx, m, opts);
+    assert(r.ok);
+    assert(r.bricks.size() == 3);
+
+    auto v = genmesh::verify_bricks_crc("_t22_defer.bin", idx);
+    assert(!v.ok);
+    assert(v.exit_code == genmesh::ExitCode::ValidationFailure);
+    assert(v.bricks.empty());
+    assert(v.errors.size() == 2);
+    assert(v.errors[0].code == genmesh::E1106);
+    assert(v.errors[0].message.find("bricks[1]") != std::string::npos);
+    assert(v.errors[1].message.find("bricks[2]") != std::string::npos);
+
+    // Same diagnostics as the inline check
+    auto inline_r = genmesh::load_bricks_bin("_t22_defer.bin", idx, m);
+    assert(inline_r.errors.size() == v.errors.size());
+    for (size_t i = 0; i < v.errors.size(); ++i) {
+        assert(inline_r.errors[i].message == v.errors[i].message);
+    }
+
+    auto missing = genmesh::verify_bricks_crc("_t22_no_such.bin", idx);
+    assert(!missing.ok);
+    assert(missing.exit_code == genmesh::ExitCode::IoError);
+
+    std::remove("_t22_defer.bin");
+    std::cout << "  PASS: test_deferred_crc_verification\n";
+}
+
+// --------- compressed encodings ---------
+
+void test_compressed_bricks() {
+    // B=4 (64 voxels), 3 bricks: zstd, lz4, raw, packed back to back
+    const int B = 4;
+    const int V = B * B * B;
+    for (const std::string dtype : {"f32", "f16"}) {
+        const bool f16 = (dtype == "f16");
+        auto m = make_manifest(B, dtype);
+        m.dims = {3 * B, B, B};
+
+        genmesh::BricksIndex idx;
+        idx.version = 1;
+        idx.brick_size = B;
+        idx.dtype = dtype;
+        idx.dims = {3 * B, B, B};
+
+        std::vector<std::vector<float>> expect(3);
+        std::vector<uint8_t> bin;
+        const char* encs[] = {"zstd", "lz4", "raw"};
+        for (int b = 0; b < 3; ++b) {
+            std::vector<uint8_t> raw;
+            for (int i = 0; i < V; ++i) {
+                // smooth, SDF-like ramp (exact in f16)
+                float v = static_cast<float>(i % B) - 2.0f + static_cast<float>(b);
+                expect[b].push_back(v);
+                if (f16) {
+                    uint16_t h = float_to_half(v);
+                    raw.insert(raw.end(), reinterpret_cast<uint8_t*>(&h),
+                               reinterpret_cast<uint8_t*>(&h) + 2);
+                } else {
+                    raw.insert(raw.end(), reinterpret_cast<uint8_t*>(&v),
+                               reinterpret_cast<uint8_t*>(&v) + 4);
+                }
+            }
+            auto stored = genmesh::encode_brick_payload(encs[b], raw.data(), raw.size());
+            assert(!stored.empty());
+            if (b < 2) assert(stored.size() < raw.size());
+
+            idx.bricks.push_back({b, 0, 0, static_cast<int64_t>(bin.size()),
+                                  static_cast<int64_t>(stored.size()), encs[b],
+                                  to_hex8(crc32_calc(stored.data(), stored.size()))});
+            bin.insert(bin.end(), stored.begin(), stored.end());
+        }
+        {
+            std::ofstream ofs("_t22_comp.bin", std::ios::binary);
+            ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+        }
+
+        for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                          genmesh::ReadMode::Coalesced}) {
+            genmesh::BricksReadOptions opts;
+            opts.mode = mode;
+            auto r = genmesh::load_bricks_bin("_t22_comp.bin", idx, m, opts);
+            assert(r.ok);
+            assert(r.bricks.size() == 3);
+            for (int b = 0; b < 3; ++b) {
+                assert(r.bricks[b].bx == b);
+                assert(r.bricks[b].size() == static_cast<size_t>(V));
+                for (int i = 0; i < V; ++i) {
+                    assert(r.bricks[b].data()[i] == expect[b][i]);
+                }
+            }
+        }
+
+        // Corrupt the zstd frame (CRC left out so decode sees it)
+        bin[static_cast<size_t>(idx.bricks[0].offset_bytes) + 4] ^= 0xFF;
+        bin[static_cast<size_t>(idx.bricks[1].offset_bytes)] = 0xFF;  // lz4 token: huge literal run
+        {
+            std::ofstream ofs("_t22_comp.bin", std::ios::binary);
+            ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+        }
+        idx.bricks[0].crc32.reset();
+        idx.bricks[1].crc32.reset();
+        auto rc = genmesh::load_bricks_bin("_t22_comp.bin", idx, m);
+        assert(!rc.ok);
+        assert(rc.errors.size() == 2);
+        assert(rc.errors[0].code == genmesh::E1107);
+        assert(rc.errors[0].message.find("bricks[0] zstd") != std::string::npos);
+        assert(rc.errors[1].code == genmesh::E1107);
+        assert(rc.errors[1].message.find("bricks[1] lz4") != std::string::npos);
+        assert(rc.bricks.size() == 1);
+    }
+
+    std::remove("_t22_comp.bin");
+    std::cout << "  PASS: test_compressed_bricks\n";
+}
+
+void test_sdfp_brick() {
+    // B=8 sphere, lossless + bounded bricks side by side
+    const int B = 8;
+    const int V = B * B * B;
+    std::vector<float> sdf;
+    for (int z = 0; z < B; ++z)
+        for (int y = 0; y < B; ++y)
+            for (int x = 0; x < B; ++x)
+                sdf.push_back(std::sqrt(float((x - 4) * (x - 4) + (y - 4) * (y - 4) +
+                                              (z - 4) * (z - 4))) - 2.5f);
+
+    auto lossless = genmesh::sdfp_encode(sdf.data(), B);
+    genmesh::SdfpOptions opts;
+    opts.max_error_mm = genmesh::sdfp_error_bound(1.0f, 1.0f / 64.0f);
+    auto bounded = genmesh::sdfp_encode(sdf.data(), B, opts);
+
+    std::vector<uint8_t> bin(lossless);
+    bin.insert(bin.end(), bounded.begin(), bounded.end());
+    {
+        std::ofstream ofs("_t22_sdfp.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+    }
+
+    auto m = make_manifest(B, "f32");
+    m.dims = {2 * B, B, B};
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = B;
+    idx.dtype = "f32";
+    idx.dims = {2 * B, B, B};
+    idx.bricks.push_back({0, 0, 0, 0, static_cast<int64_t>(lossless.size()), "sdfp", std::nullopt});
+    idx.bricks.push_back({1, 0, 0, static_cast<int64_t>(lossless.size()),
+                          static_cast<int64_t>(bounded.size()), "sdfp", std::nullopt});
+
+    auto r = genmesh::load_bricks_bin("_t22_sdfp.bin", idx, m);
+    assert(r.ok);
+    assert(r.bricks.size() == 2);
+    assert(std::memcmp(r.bricks[0].data(), sdf.data(), V * sizeof(float)) == 0);
+    for (int i = 0; i < V; ++i) {
+        assert(std::fabs(r.bricks[1].data()[i] - sdf[i]) <= opts.max_error_mm);
+    }
+
+    std::remove("_t22_sdfp.bin");
+    std::cout << "  PASS: test_sdfp_brick\n";
+}
+
+void test_band_quantized_bricks() {
+    // band = 3 voxels * 1 mm; saturation expands to +/-background_value_mm
+    const int B = 4;
+    const int V = B * B * B;
+    const float band = 3.0f;
+    std::vector<float> sdf(V);
+    for (int i = 0; i < V; ++i) sdf[i] = -5.0f + 10.0f * static_cast<float>(i) / (V - 1);
+
+    for (const char* enc : {"q8", "q16"}) {
+        auto q = genmesh::band_quantize(enc, sdf.data(), V, band);
+        assert(q.size() == static_cast<size_t>(V) * genmesh::band_quantized_value_bytes(enc));
+        {
+            std::ofstream ofs("_t22_q.bin", std::ios::binary);
+            ofs.write(reinterpret_cast<const char*>(q.data()), q.size());
+        }
+
+        for (const char* dtype : {"f32", "f16"}) {
+            auto m = make_manifest(B, dtype);
+            genmesh::BricksIndex idx;
+            idx.version = 1;
+            idx.brick_size = B;
+            idx.dtype = dtype;
+            idx.dims = {B, B, B};
+            idx.bricks.push_back({0, 0, 0, 0, static_cast<int64_t>(q.size()), enc, std::nullopt});
+
+            for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                              genmesh::ReadMode::Coalesced}) {
+                genmesh::BricksReadOptions opts;
+                opts.mode = mode;
+                auto r = genmesh::load_bricks_bin("_t22_q.bin", idx, m, opts);
+                assert(r.ok);
+                assert(r.bricks.size() == 1);
+
+                const float step = band / (std::string(enc) == "q8" ? 127.0f : 32767.0f);
+                const float* got = r.bricks[0].data();
+                for (int i = 0; i < V; ++i) {
+                    const float d = sdf[i];
+                    if (std::fabs(d) < band - step) {
+                        assert(std::fabs(got[i] - d) <= step * 0.5f + 1e-6f);
+                    } else if (std::fabs(d) >= band) {
+                        assert(got[i] == (d > 0 ? 1000.0f : -1000.0f));
+                    }
+                }
+            }
+        }
+    }
+
+    std::remove("_t22_q.bin");
+    std::cout << "  PASS: test_band_quantized_bricks\n";
+}
+
+void test_constant_brick() {
+    // A constant brick reads nothing; bricks.bin may even be empty.
+    { std::ofstream ofs("_t22_const.bin", std::ios::binary); }
+
+    auto m = make_manifest(2, "f32");
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {2, 2, 2};
+    genmesh::BrickEntry e{0, 0, 0, 0, 0, "constant", std::nullopt};
+    e.value = -1000.0f;
+    idx.bricks.push_back(e);
+
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions opts;
+        opts.mode = mode;
+        auto r = genmesh::load_bricks_bin("_t22_const.bin", idx, m, opts);
+        assert(r.ok);
+        assert(r.bricks.size() == 1);
+        assert(r.bricks[0].constant.has_value());
+        assert(r.bricks[0].constant.value() == -1000.0f);
+        assert(r.bricks[0].size() == 0);
+    }
+
+    std::remove("_t22_const.bin");
+    std::cout << "  PASS: test_constant_brick\n";
+}
+
+void test_shared_payloads() {
+    // 3 entries, 2 stored payloads: (0,0,0) and (1,0,0) share offset 0
+    std::vector<float> a(8), b(8);
+    for (int i = 0; i < 8; ++i) {
+        a[i] = static_cast<float>(i);
+        b[i] = static_cast<float>(-i);
+    }
+    {
+        std::ofstream ofs("_t22_shared.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(a.data()), 32);
+        ofs.write(reinterpret_cast<const char*>(b.data()), 32);
+    }
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {6, 2, 2};
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {6, 2, 2};
+    const std::string crc_a = to_hex8(crc32_calc(reinterpret_cast<const uint8_t*>(a.data()), 32));
+    idx.bricks.push_back({0, 0, 0, 0, 32, "raw", crc_a});
+    idx.bricks.push_back({2, 0, 0, 32, 32, "raw", std::nullopt});
+    idx.bricks.push_back({1, 0, 0, 0, 32, "raw", crc_a});
+
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions opts;
+        opts.mode = mode;
+        auto r = genmesh::load_bricks_bin("_t22_shared.bin", idx, m, opts);
+        assert(r.ok);
+        assert(r.unique_payloads == 2);
+        assert(r.bricks.size() == 3);
+        assert(r.bricks[2].bx == 1);
+        assert(r.bricks[2].data() == r.bricks[0].data());  // shared, not copied
+        assert(std::memcmp(r.bricks[2].data(), a.data(), 32) == 0);
+        assert(std::memcmp(r.bricks[1].data(), b.data(), 32) == 0);
+    }
+
+    // a failed shared payload is reported once
+    idx.bricks[0].crc32 = idx.bricks[2].crc32 = std::string("00000000");
+    auto rf = genmesh::load_bricks_bin("_t22_shared.bin", idx, m);
+    assert(!rf.ok);
+    assert(rf.errors.size() == 1);
+    assert(rf.errors[0].code == genmesh::E1106);
+
+    std::remove("_t22_shared.bin");
+    std::cout << "  PASS: test_shared_payloads\n";
+}
+
+void test_coalesced_reads() {
+    // Payloads written in reverse index order with holes; the index is
+    // shuffled, mixes f32 raw with zstd, and has one entry past EOF.
+    const int n = 24;
+    std::vector<std::vector<float>> data(n, std::vector<float>(8));
+    for (int i = 0; i < n; ++i)
+        for (int k = 0; k < 8; ++k) data[i][k] = static_cast<float>(i * 8 + k);
+
+    std::vector<uint8_t> bin;
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {2 * n, 2, 2};
+    for (int i = n - 1; i >= 0; --i) {
+        const auto* src = reinterpret_cast<const uint8_t*>(data[i].data());
+        const bool packed = (i % 4 == 2);
+        auto payload = packed ? genmesh::encode_brick_payload("zstd", src, 32)
+                              : std::vector<uint8_t>(src, src + 32);
+        bin.resize(bin.size() + (i % 3) * 5000);  // holes, some beyond the merge gap
+        idx.bricks.push_back({i, 0, 0, static_cast<int64_t>(bin.size()),
+                              static_cast<int64_t>(payload.size()), packed ? "zstd" : "raw",
+                              to_hex8(crc32_calc(payload.data(), payload.size()))});
+        bin.insert(bin.end(), payload.begin(), payload.end());
+    }
+    bin.resize(bin.size() + 3);  // file size not a multiple of the block size
+    idx.bricks.push_back({n, 0, 0, static_cast<int64_t>(bin.size()) + 100, 32, "raw", std::nullopt});
+    idx.dims[0] += 2;
+    {
+        std::ofstream ofs("_t22_coal.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+    }
+
+    auto m = make_manifest(2, "f32");
+    m.dims = idx.dims;
+
+    genmesh::BricksReadOptions stream_opts;
+    auto expected = genmesh::load_bricks_bin("_t22_coal.bin", idx, m, stream_opts);
+    assert(!expected.ok);
+    assert(expected.errors.size() == 1 && expected.errors[0].code == genmesh::E1105);
+    assert(expected.bricks.size() == static_cast<size_t>(n));
+
+    for (bool direct : {false, true}) {
+        for (bool parallel : {false, true}) {
+            genmesh::BricksReadOptions opts;
+            opts.mode = genmesh::ReadMode::Coalesced;
+            opts.direct_io = direct;
+            opts.parallel = parallel;
+            auto r = genmesh::load_bricks_bin("_t22_coal.bin", idx, m, opts);
+            assert(!r.ok);
+            assert(r.errors.size() == 1);
+            assert(r.errors[0].message == expected.errors[0].message);
+            assert(r.bricks.size() == expected.bricks.size());
+            for (size_t i = 0; i < r.bricks.size(); ++i) {
+                assert(r.bricks[i].bx == expected.bricks[i].bx);
+                assert(std::memcmp(r.bricks[i].data(), data[r.bricks[i].bx].data(), 32) == 0);
+            }
+        }
+    }
+
+    std::remove("_t22_coal.bin");
+    std::cout << "  PASS: test_coalesced_reads\n";
+}
+
+void test_value_summary() {
+    std::vector<float> data = {-2.0f, -1.0f, 0.5f, 1.0f, 2.0f, 3.0f, 4.0f, NAN};
+    write_f32_bin("_t22_sum.bin", data);
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {4, 2, 2};
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {4, 2, 2};
+    genmesh::BrickEntry e{0, 0, 0, 0, 32, "raw"};
+    e.min = -2.0f;
+    e.max = 4.0f;  // NaN is not part of the range
+    e.crosses_iso = true;
+    idx.bricks.push_back(e);
+
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions opts;
+        opts.mode = mode;
+        auto r = genmesh::load_bricks_bin("_t22_sum.bin", idx, m, opts);
+        assert(r.ok);
+        assert(r.bricks.size() == 1);
+    }
+
+    // a looser summary is fine, a tighter one is not
+    idx.bricks[0].min = -5.0f;
+    assert(genmesh::load_bricks_bin("_t22_sum.bin", idx, m).ok);
+    idx.bricks[0].max = 3.5f;
+    auto rt = genmesh::load_bricks_bin("_t22_sum.bin", idx, m);
+    assert(!rt.ok);
+    assert(rt.bricks.empty());
+    assert(has_error_code(rt, genmesh::E1108));
+
+    // crosses_iso refers to the iso the summary was written for
+    idx.bricks[0].max = 4.0f;
+    genmesh::BricksReadOptions at5;
+    at5.summary_iso = 5.0f;
+    auto rc = genmesh::load_bricks_bin("_t22_sum.bin", idx, m, at5);
+    assert(!rc.ok);
+    assert(has_error_code(rc, genmesh::E1108));
+    idx.bricks[0].crosses_iso = false;
+    assert(genmesh::load_bricks_bin("_t22_sum.bin", idx, m, at5).ok);
+
+    // an entry sharing the payload is checked against its own summary
+    idx.bricks[0].crosses_iso = true;
+    auto shared = idx.bricks[0];
+    shared.bx = 1;
+    shared.min = 0.0f;
+    idx.bricks.push_back(shared);
+    auto rs = genmesh::load_bricks_bin("_t22_sum.bin", idx, m);
+    assert(!rs.ok);
+    assert(rs.errors.size() == 1);
+    assert(rs.errors[0].code == genmesh::E1108);
+    assert(rs.errors[0].message.rfind("bricks[1]", 0) == 0);
+    assert(rs.bricks.size() == 1 && rs.bricks[0].bx == 0);
+
+    std::remove("_t22_sum.bin");
+    std::cout << "  PASS: test_value_summary\n";
+}
+
+void test_cull_bricks() {
+    // band = half_width_voxels(3) * voxel_size(1) = 3 around iso 0
+    std::vector<float> near = {-1, -1, -1, -1, 1, 1, 1, 1};
+    write_f32_bin("_t22_cull.bin", near);
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {8, 2, 2};
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {8, 2, 2};
+    auto entry = [](int bx, int64_t offset, float lo, float hi) {
+        genmesh::BrickEntry e{bx, 0, 0, offset, 32, "raw", std::string("00000000")};
+        e.min = lo;
+        e.max = hi;
+        return e;
+    };
+    idx.bricks.push_back(entry(0, 0, 4.0f, 9.0f));      // outside: min > +3
+    idx.bricks.push_back(entry(1, 0, -1.0f, 1.0f));     // crosses the surface
+    idx.bricks.push_back(entry(2, 640, -9.0f, -4.0f));  // inside: max < -3, past EOF
+    idx.bricks.push_back(entry(3, 0, 2.0f, 5.0f));      // reaches into the band
+    idx.bricks[1].crc32 = to_hex8(crc32_calc(reinterpret_cast<const uint8_t*>(near.data()), 32));
+    idx.bricks[3].crc32 = idx.bricks[1].crc32;
+    idx.bricks[3].min = -1.0f;
+
+    assert(genmesh::classify_brick(idx.bricks[0], m) == genmesh::BrickCull::Outside);
+    assert(genmesh::classify_brick(idx.bricks[1], m) == genmesh::BrickCull::Keep);
+    assert(genmesh::classify_brick(idx.bricks[2], m) == genmesh::BrickCull::Inside);
+
+    // without culling the bogus crc / offset are read and reported
+    auto full = genmesh::load_bricks_bin("_t22_cull.bin", idx, m);
+    assert(!full.ok);
+    assert(has_error_code(full, genmesh::E1106));
+    assert(has_error_code(full, genmesh::E1105));
+
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions opts;
+        opts.mode = mode;
+        opts.cull = true;
+        auto r = genmesh::load_bricks_bin("_t22_cull.bin", idx, m, opts);
+        assert(r.ok);
+        assert(r.culled_outside == 1);
+        assert(r.culled_inside == 1);
+        assert(r.bricks.size() == 3);
+        assert(r.bricks[0].bx == 1 && std::memcmp(r.bricks[0].data(), near.data(), 32) == 0);
+        assert(r.bricks[1].bx == 2 && r.bricks[1].constant.value() == -4.0f);
+        assert(r.bricks[2].bx == 3 && r.bricks[2].data() == r.bricks[0].data());
+    }
+
+    // an overridden iso moves the cull set: the summaries alone decide
+    m.iso = 6.0f;
+    assert(genmesh::classify_brick(idx.bricks[0], m) == genmesh::BrickCull::Keep);
+    assert(genmesh::classify_brick(idx.bricks[1], m) == genmesh::BrickCull::Inside);
+    // offset_mm shifts the surface and widens the band
+    m.iso = 0.0f;
+    m.offset_mm = -1.5f;
+    assert(genmesh::classify_brick(idx.bricks[2], m) == genmesh::BrickCull::Keep);
+
+    std::remove("_t22_cull.bin");
+    std::cout << "  PASS: test_cull_bricks\n";
+}
+
+void test_keep_half() {
+    // B=4, 4 entries over 3 stored f16 payloads: raw (aligned), raw at an odd
+    // offset, zstd, and a fourth entry sharing the first payload
+    const int B = 4;
+    const int V = B * B * B;
+    auto m = make_manifest(B, "f16");
+    m.dims = {4 * B, B, B};
+
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = B;
+    idx.dtype = "f16";
+    idx.dims = {4 * B, B, B};
+
+    std::vector<uint8_t> bin;
+    for (int b = 0; b < 3; ++b) {
+        std::vector<uint8_t> raw;
+        for (int i = 0; i < V; ++i) {
+            uint16_t h = float_to_half(static_cast<float>((i + b) % 7) * 0.25f - 1.0f);
+            raw.insert(raw.end(), reinterpret_cast<uint8_t*>(&h),
+                       reinterpret_cast<uint8_t*>(&h) + 2);
+        }
+        const char* enc = b == 2 ? "zstd" : "raw";
+        auto stored = genmesh::encode_brick_payload(enc, raw.data(), raw.size());
+        if (b == 1) bin.push_back(0);  // odd offset
+        idx.bricks.push_back({b, 0, 0, static_cast<int64_t>(bin.size()),
+                              static_cast<int64_t>(stored.size()), enc,
+                              to_hex8(crc32_calc(stored.data(), stored.size()))});
+        bin.insert(bin.end(), stored.begin(), stored.end());
+    }
+    idx.bricks.push_back(idx.bricks[0]);
+    idx.bricks[3].bx = 3;
+    idx.bricks[0].min = -1.0f;  // summary checked against the f16 values
+    idx.bricks[0].max = 0.5f;
+    {
+        std::ofstream ofs("_t22_half.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+    }
+
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions opts;
+        opts.mode = mode;
+        auto widened = genmesh::load_bricks_bin("_t22_half.bin", idx, m, opts);
+        opts.keep_half = true;
+        auto r = genmesh::load_bricks_bin("_t22_half.bin", idx, m, opts);
+        assert(widened.ok && r.ok);
+        assert(r.bricks.size() == 4);
+
+        std::vector<float> scratch;
+        for (size_t b = 0; b < 4; ++b) {
+            const auto& bd = r.bricks[b];
+            assert(bd.is_half());
+            assert(bd.values.empty() && !bd.view);
+            assert(bd.size() == static_cast<size_t>(V));
+            const float* f = genmesh::brick_floats(bd, scratch);
+            assert(std::memcmp(f, widened.bricks[b].data(), V * sizeof(float)) == 0);
+        }
+        if (mode == genmesh::ReadMode::Mmap) {
+            assert(r.bricks[0].half_view != nullptr);  // in place
+            assert(r.bricks[1].half_view == nullptr);  // odd offset: copied
+        }
+        assert(r.bricks[3].half_data() == r.bricks[0].half_data());  // shared, not copied
+    }
+
+    // without keep_half, f16 is widened as before
+    auto plain = genmesh::load_bricks_bin("_t22_half.bin", idx, m);
+    assert(plain.ok && !plain.bricks[0].is_half());
+
+    // the summary is checked against the f16 values too
+    idx.bricks[0].max = 0.25f;
+    genmesh::BricksReadOptions opts;
+    opts.keep_half = true;
+    auto bad = genmesh::load_bricks_bin("_t22_half.bin", idx, m, opts);
+    assert(!bad.ok);
+    assert(has_error_code(bad, genmesh::E1108));
+
+    std::remove("_t22_half.bin");
+    std::cout << "  PASS: test_keep_half\n";
+}
+
+void test_stream_bricks() {
+    // raw, zstd, a shared payload, a constant, a bad crc and a culled-inside
+    // entry: the sink gets exactly the bricks load_bricks_bin() returns
+    std::vector<float> a = {-1, -1, -1, -1, 1, 1, 1, 1};
+    std::vector<float> b = {-2, -1, 0, 1, 2, 3, 4, 5};
+    auto zb = genmesh::encode_brick_payload("zstd", reinterpret_cast<const uint8_t*>(b.data()), 32);
+    std::vector<uint8_t> bin(reinterpret_cast<const uint8_t*>(a.data()),
+                             reinterpret_cast<const uint8_t*>(a.data()) + 32);
+    bin.insert(bin.end(), zb.begin(), zb.end());
+    {
+        std::ofstream ofs("_t22_stream.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+    }
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {12, 2, 2};
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {12, 2, 2};
+    const std::string crc_a = to_hex8(crc32_calc(bin.data(), 32));
+    idx.bricks.push_back({0, 0, 0, 0, 32, "raw", crc_a});
+    idx.bricks.push_back({1, 0, 0, 32, static_cast<int64_t>(zb.size()), "zstd",
+                          to_hex8(crc32_calc(zb.data(), zb.size()))});
+    idx.bricks.push_back({2, 0, 0, 0, 32, "raw", crc_a});  // shares bricks[0]
+    idx.bricks.push_back({3, 0, 0, 0, 0, "constant", std::nullopt});
+    idx.bricks[3].value = -2.0f;
+    idx.bricks.push_back({4, 0, 0, 0, 32, "raw", std::string("00000000")});  // E1106
+    idx.bricks.push_back({5, 0, 0, 640, 32, "raw", std::nullopt});  // culled inside
+    idx.bricks[5].min = -9.0f;
+    idx.bricks[5].max = -4.0f;
+    idx.bricks[2].min = -1.0f;  // summary of a shared entry is checked too
+    idx.bricks[2].max = 1.0f;
+
+    for (bool cull : {false, true}) {
+        for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                          genmesh::ReadMode::Coalesced}) {
+            for (bool parallel : {false, true}) {
+                genmesh::BricksReadOptions opts;
+                opts.mode = mode;
+                opts.parallel = parallel;
+                opts.cull = cull;
+                auto loaded = genmesh::load_bricks_bin("_t22_stream.bin", idx, m, opts);
+
+                std::mutex mu;
+                std::map<int, genmesh::BrickData> got;
+                auto r = genmesh::stream_bricks_bin(
+                    "_t22_stream.bin", idx, m, opts, [&](const genmesh::BrickData& bd) {
+                        genmesh::BrickData copy;
+                        copy.bx = bd.bx;
+                        copy.constant = bd.constant;
+                        if (!bd.constant) copy.values.assign(bd.data(), bd.data() + bd.size());
+                        std::lock_guard<std::mutex> lock(mu);
+                        assert(got.count(bd.bx) == 0);
+                        got[bd.bx] = std::move(copy);
+                    });
+
+                assert(!r.ok && !loaded.ok);
+                assert(r.bricks.empty());
+                assert(r.errors.size() == loaded.errors.size());
+                for (size_t i = 0; i < r.errors.size(); ++i) {
+                    assert(r.errors[i].code == loaded.errors[i].code);
+                    assert(r.errors[i].message == loaded.errors[i].message);
+                }
+                assert(has_error_code(r, genmesh::E1106));
+                assert(got.count(4) == 0);
+                assert(r.unique_payloads == loaded.unique_payloads);
+
+                assert(got.size() == loaded.bricks.size());
+                for (const auto& bd : loaded.bricks) {
+                    const auto& s = got.at(bd.bx);
+                    assert(s.constant == bd.constant);
+                    assert(s.values.size() == bd.size());
+                    if (!bd.constant) {
+                        assert(std::memcmp(s.values.data(), bd.data(), bd.size() * 4) == 0);
+                    }
+                }
+                assert(got.at(2).values == a);
+                assert(got.at(3).constant.value() == -2.0f);
+                assert(got.count(5) == (cull ? 1u : 0u));
+            }
+        }
+    }
+
+    // a failing summary on a shared entry keeps it from the sink only
+    idx.bricks[2].max = 0.5f;
+    std::vector<int> seen;
+    std::mutex mu;
+    auto r = genmesh::stream_bricks_bin("_t22_stream.bin", idx, m, {},
+                                        [&](const genmesh::BrickData& bd) {
+                                            std::lock_guard<std::mutex> lock(mu);
+                                            seen.push_back(bd.bx);
+                                        });
+    assert(has_error_code(r, genmesh::E1108));
+    assert(std::count(seen.begin(), seen.end(), 0) == 1);
+    assert(std::count(seen.begin(), seen.end(), 2) == 0);
+
+    std::remove("_t22_stream.bin");
+    std::cout << "  PASS: test_stream_bricks\n";
+}
+
+void test_arena_reads() {
+    // raw f32, zstd, a shared payload and a constant: arena slots hold the
+    // same values as per-brick vectors
+    std::vector<float> a = {-1, -1, -1, -1, 1, 1, 1, 1};
+    std::vector<float> b = {-2, -1, 0, 1, 2, 3, 4, 5};
+    auto zb = genmesh::encode_brick_payload("zstd", reinterpret_cast<const uint8_t*>(b.data()), 32);
+    std::vector<uint8_t> bin(reinterpret_cast<const uint8_t*>(a.data()),
+                             reinterpret_cast<const uint8_t*>(a.data()) + 32);
+    bin.insert(bin.end(), zb.begin(), zb.end());
+    {
+        std::ofstream ofs("_t22_arena.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+    }
+
+    auto m = make_manifest(2, "f32");
+    m.dims = {8, 2, 2};
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = 2;
+    idx.dtype = "f32";
+    idx.dims = {8, 2, 2};
+    idx.bricks.push_back({0, 0, 0, 0, 32, "raw", std::nullopt});
+    idx.bricks.push_back({1, 0, 0, 32, static_cast<int64_t>(zb.size()), "zstd", std::nullopt});
+    idx.bricks.push_back({2, 0, 0, 0, 32, "raw", std::nullopt});  // shares bricks[0]
+    idx.bricks.push_back({3, 0, 0, 0, 0, "constant", std::nullopt});
+    idx.bricks[3].value = 0.5f;
+
+    auto aligned = [](const void* p) {
+        return reinterpret_cast<uintptr_t>(p) % genmesh::BrickArena::kAlignment == 0;
+    };
+
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        for (bool parallel : {false, true}) {
+            genmesh::BricksReadOptions opts;
+            opts.mode = mode;
+            opts.parallel = parallel;
+            auto plain = genmesh::load_bricks_bin("_t22_arena.bin", idx, m, opts);
+            opts.arena = true;
+            opts.huge_pages = parallel;  // a hint only; same values either way
+            auto r = genmesh::load_bricks_bin("_t22_arena.bin", idx, m, opts);
+            assert(plain.ok && r.ok);
+            assert(r.bricks.size() == 4);
+            for (size_t i = 0; i < 3; ++i) {
+                const auto& bd = r.bricks[i];
+                assert(bd.values.empty() && bd.view && bd.keepalive);
+                assert(bd.size() == 8);
+                assert(std::memcmp(bd.data(), plain.bricks[i].data(), 32) == 0);
+            }
+            // the zstd brick is decoded into a slot; raw f32 is used in place under mmap
+            assert(aligned(r.bricks[1].data()));
+            if (mode != genmesh::ReadMode::Mmap) assert(aligned(r.bricks[0].data()));
+            assert(r.bricks[2].data() == r.bricks[0].data());
+            assert(r.bricks[3].constant.value() == 0.5f && r.bricks[3].keepalive == nullptr);
+
+            // streamed: slots are handed to the sink and recycled
+            std::mutex mu;
+            int seen = 0;
+            auto sr = genmesh::stream_bricks_bin(
+                "_t22_arena.bin", idx, m, opts, [&](const genmesh::BrickData& bd) {
+                    std::lock_guard<std::mutex> lock(mu);
+                    ++seen;
+                    if (bd.constant) return;
+                    assert(bd.values.empty() && bd.view);
+                    const auto& want = bd.bx == 1 ? b : a;
+                    assert(std::memcmp(bd.data(), want.data(), 32) == 0);
+                });
+            assert(sr.ok && seen == 4);
+        }
+    }
+
+    // keep_half: binary16 values go into slots as well
+    {
+        std::vector<uint16_t> h(8);
+        for (int i = 0; i < 8; ++i) h[i] = float_to_half(static_cast<float>(i) - 4.0f);
+        std::vector<uint8_t> hbin(1, 0);  // odd offset: copied, not used in place
+        hbin.insert(hbin.end(), reinterpret_cast<const uint8_t*>(h.data()),
+                    reinterpret_cast<const uint8_t*>(h.data()) + 16);
+        {
+            std::ofstream ofs("_t22_arena.bin", std::ios::binary);
+            ofs.write(reinterpret_cast<const char*>(hbin.data()), hbin.size());
+        }
+        auto mh = make_manifest(2, "f16");
+        genmesh::BricksIndex hidx;
+        hidx.version = 1;
+        hidx.brick_size = 2;
+        hidx.dtype = "f16";
+        hidx.dims = {2, 2, 2};
+        hidx.bricks.push_back({0, 0, 0, 1, 16, "raw", std::nullopt});
+        for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                          genmesh::ReadMode::Coalesced}) {
+            genmesh::BricksReadOptions opts;
+            opts.mode = mode;
+            opts.arena = true;
+            opts.keep_half = true;
+            auto r = genmesh::load_bricks_bin("_t22_arena.bin", hidx, mh, opts);
+            assert(r.ok && r.bricks[0].is_half());
+            assert(r.bricks[0].half_values.empty() && aligned(r.bricks[0].half_view));
+            assert(std::memcmp(r.bricks[0].half_data(), h.data(), 16) == 0);
+
+            opts.keep_half = false;
+            auto w = genmesh::load_bricks_bin("_t22_arena.bin", hidx, mh, opts);
+            assert(w.ok && !w.bricks[0].is_half() && aligned(w.bricks[0].data()));
+            assert(w.bricks[0].data()[7] == 3.0f);
+        }
+    }
+
+    std::remove("_t22_arena.bin");
+    std::cout << "  PASS: test_arena_reads\n";
+}
+
+void test_arena_half_footprint() {
+    // 16^3 f16 bricks: raw (odd offset, copied), zstd and q8. With keep_half
+    // the first two take 8 KiB binary16 slots; only q8 takes a 16 KiB float slot.
+    const int B = 16;
+    const size_t voxels = static_cast<size_t>(B) * B * B;
+    std::vector<uint16_t> h(voxels);
+    for (size_t i = 0; i < voxels; ++i) h[i] = float_to_half(static_cast<float>(i % 7) - 3.0f);
+    const auto* hb = reinterpret_cast<const uint8_t*>(h.data());
+    auto zh = genmesh::encode_brick_payload("zstd", hb, voxels * 2);
+    std::vector<uint8_t> q(voxels, 0x10);
+
+    std::vector<uint8_t> bin(1, 0);
+    bin.insert(bin.end(), hb, hb + voxels * 2);
+    bin.insert(bin.end(), zh.begin(), zh.end());
+    bin.insert(bin.end(), q.begin(), q.end());
+    {
+        std::ofstream ofs("_t22_arena_half.bin", std::ios::binary);
+        ofs.write(reinterpret_cast<const char*>(bin.data()), bin.size());
+    }
+
+    auto m = make_manifest(B, "f16");
+    m.dims = {3 * B, B, B};
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = B;
+    idx.dtype = "f16";
+    idx.dims = m.dims;
+    const int64_t raw_bytes = static_cast<int64_t>(voxels * 2);
+    const int64_t zbytes = static_cast<int64_t>(zh.size());
+    idx.bricks.push_back({0, 0, 0, 1, raw_bytes, "raw", std::nullopt});
+    idx.bricks.push_back({1, 0, 0, 1 + raw_bytes, zbytes, "zstd", std::nullopt});
+    idx.bricks.push_back({2, 0, 0, 1 + raw_bytes + zbytes, static_cast<int64_t>(voxels), "q8",
+                          std::nullopt});
+
+    const size_t half_slot = voxels * sizeof(uint16_t);
+    const size_t float_slot = voxels * sizeof(float);
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions opts;
+        opts.mode = mode;
+        opts.arena = true;
+        opts.keep_half = true;
+        auto r = genmesh::load_bricks_bin("_t22_arena_half.bin", idx, m, opts);
+        assert(r.ok);
+        assert(r.bricks[0].is_half() && r.bricks[1].is_half() && !r.bricks[2].is_half());
+        assert(std::memcmp(r.bricks[1].half_data(), h.data(), voxels * 2) == 0);
+        assert(r.arena_bytes == 2 * half_slot + float_slot);
+
+        std::atomic<size_t> streamed{0};
+        auto sr = genmesh::stream_bricks_bin("_t22_arena_half.bin", idx, m, opts,
+                                             [&](const genmesh::BrickData&) { ++streamed; });
+        assert(sr.ok && streamed == 3);
+        assert(sr.arena_bytes <= 2 * half_slot + float_slot);
+
+        // widened, every brick takes a float slot
+        opts.keep_half = false;
+        auto w = genmesh::load_bricks_bin("_t22_arena_half.bin", idx, m, opts);
+        assert(w.ok && w.arena_bytes == 3 * float_slot);
+    }
+
+    std::remove("_t22_arena_half.bin");
+    std::cout << "  PASS: test_arena_half_footprint\n";
+}
+
 int main() {
     genmesh::min_log_level() = genmesh::LogLevel::Error;
 
@@ -288,6 +1351,24 @@ int main() {
     test_crc32_valid();
     test_crc32_mismatch();
     test_multiple_bricks();
+    test_mmap_f32_is_view();
+    test_mmap_f16_decoded();
+    test_mmap_unaligned_offset_copies();
+    test_mmap_errors();
+    test_parallel_matches_serial_order();
+    test_deferred_crc_verification();
+    test_compressed_bricks();
+    test_sdfp_brick();
+    test_band_quantized_bricks();
+    test_constant_brick();
+    test_shared_payloads();
+    test_coalesced_reads();
+    test_value_summary();
+    test_cull_bricks();
+    test_keep_half();
+    test_stream_bricks();
+    test_arena_reads();
+    test_arena_half_footprint();
 
     std::cout << "=== All T2.2 tests passed ===\n";
     return 0;
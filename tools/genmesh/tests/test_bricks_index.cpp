@@ -1,11 +1,14 @@
 // T2.1 Bricks index parse + validation tests
 #include <cassert>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <tuple>
 
 #include <nlohmann/json.hpp>
 #include "genmesh/bricks_index.h"
+#include "genmesh/crc32.h"
 #include "genmesh/error_code.h"
 #include "genmesh/log.h"
 #include "genmesh/manifest.h"
@@ -180,7 +183,7 @@ void test_payload_bytes_mismatch() {
 
 void test_invalid_encoding() {
     auto j = valid_base();
-    j["bricks"][0]["encoding"] = "zstd";
+    j["bricks"][0]["encoding"] = "brotli";
     auto path = write_temp_json(j, "_bi_enc.json");
     auto m = make_manifest();
     auto r = genmesh::load_bricks_index(path, m);
@@ -190,6 +193,161 @@ void test_invalid_encoding() {
     std::cout << "  PASS: test_invalid_encoding\n";
 }
 
+void test_compressed_encodings() {
+    // zstd / lz4: payload_bytes is the stored (compressed) size
+    for (const char* enc : {"zstd", "lz4"}) {
+        auto j = valid_base();
+        j["bricks"][0]["encoding"] = enc;
+        j["bricks"][0]["payload_bytes"] = 1234;
+        auto path = write_temp_json(j, "_bi_comp.json");
+        auto m = make_manifest();
+        auto r = genmesh::load_bricks_index(path, m);
+        assert(r.ok);
+        assert(r.index.bricks[0].encoding == enc);
+        assert(r.index.bricks[0].payload_bytes == 1234);
+
+        j["bricks"][0]["payload_bytes"] = 0;
+        write_temp_json(j, "_bi_comp.json");
+        auto rz = genmesh::load_bricks_index(path, m);
+        assert(!rz.ok);
+        assert(has_error_code(rz, genmesh::E1104));
+        std::remove(path.c_str());
+    }
+
+    // sdfp stores f32 only
+    auto j = valid_base();
+    j["bricks"][0]["encoding"] = "sdfp";
+    j["bricks"][0]["payload_bytes"] = 100;
+    auto path = write_temp_json(j, "_bi_sdfp.json");
+    auto m = make_manifest();
+    assert(genmesh::load_bricks_index(path, m).ok);
+
+    j["dtype"] = "f16";
+    m.dtype = "f16";
+    write_temp_json(j, "_bi_sdfp.json");
+    auto rh = genmesh::load_bricks_index(path, m);
+    assert(!rh.ok);
+    assert(has_error_code(rh, genmesh::E1101));
+    std::remove(path.c_str());
+
+    std::cout << "  PASS: test_compressed_encodings\n";
+}
+
+void test_band_quantized_encodings() {
+    // q8 / q16: fixed size B^3 * {1,2}, independent of dtype
+    for (const char* dtype : {"f32", "f16"}) {
+        for (const char* enc : {"q8", "q16"}) {
+            const int64_t bytes = 64 * 64 * 64 * (std::string(enc) == "q8" ? 1 : 2);
+            auto j = valid_base();
+            j["dtype"] = dtype;
+            j["bricks"][0]["encoding"] = enc;
+            j["bricks"][0]["payload_bytes"] = bytes;
+            auto path = write_temp_json(j, "_bi_q.json");
+            auto m = make_manifest();
+            m.dtype = dtype;
+            auto r = genmesh::load_bricks_index(path, m);
+            assert(r.ok);
+            assert(r.index.bricks[0].encoding == enc);
+
+            j["bricks"][0]["payload_bytes"] = bytes + 1;
+            write_temp_json(j, "_bi_q.json");
+            auto rs = genmesh::load_bricks_index(path, m);
+            assert(!rs.ok);
+            assert(has_error_code(rs, genmesh::E1104));
+            std::remove(path.c_str());
+        }
+    }
+
+    // iso (+ offset) must lie inside the band: 3 voxels * 1 mm
+    auto j = valid_base();
+    j["bricks"][0]["encoding"] = "q8";
+    j["bricks"][0]["payload_bytes"] = 64 * 64 * 64;
+    auto path = write_temp_json(j, "_bi_q.json");
+    auto m = make_manifest();
+    m.iso = 2.0f;
+    assert(genmesh::load_bricks_index(path, m).ok);
+    m.offset_mm = -1.0f;
+    auto r = genmesh::load_bricks_index(path, m);
+    assert(!r.ok);
+    assert(has_error_code(r, genmesh::E1101));
+    std::remove(path.c_str());
+
+    std::cout << "  PASS: test_band_quantized_encodings\n";
+}
+
+void test_constant_encoding() {
+    auto j = valid_base();
+    j["bricks"][0]["encoding"] = "constant";
+    j["bricks"][0]["payload_bytes"] = 0;
+    j["bricks"][0]["value"] = -1000.0;
+    auto path = write_temp_json(j, "_bi_const.json");
+    auto m = make_manifest();
+    auto r = genmesh::load_bricks_index(path, m);
+    assert(r.ok);
+    assert(r.index.bricks[0].value.has_value());
+    assert(r.index.bricks[0].value.value() == -1000.0f);
+
+    // no payload allowed
+    j["bricks"][0]["payload_bytes"] = 4;
+    write_temp_json(j, "_bi_const.json");
+    auto rp = genmesh::load_bricks_index(path, m);
+    assert(!rp.ok);
+    assert(has_error_code(rp, genmesh::E1104));
+
+    // value is required
+    j["bricks"][0]["payload_bytes"] = 0;
+    j["bricks"][0].erase("value");
+    write_temp_json(j, "_bi_const.json");
+    auto rv = genmesh::load_bricks_index(path, m);
+    assert(!rv.ok);
+    assert(has_error_code(rv, genmesh::E1101));
+
+    // ... and only valid with constant
+    auto jr = valid_base();
+    jr["bricks"][0]["value"] = 1.0;
+    write_temp_json(jr, "_bi_const.json");
+    auto rr = genmesh::load_bricks_index(path, m);
+    assert(!rr.ok);
+    assert(has_error_code(rr, genmesh::E1101));
+    std::remove(path.c_str());
+
+    std::cout << "  PASS: test_constant_encoding\n";
+}
+
+void test_shared_payloads() {
+    // two coordinates referencing the same payload
+    auto j = valid_base();
+    j["dims"] = {128, 64, 64};
+    j["bricks"][0]["content_hash"] = "0123456789abcdef";
+    auto b1 = j["bricks"][0];
+    b1["bx"] = 1;
+    j["bricks"].push_back(b1);
+    auto path = write_temp_json(j, "_bi_shared.json");
+    auto m = make_manifest();
+    m.dims = {128, 64, 64};
+    auto r = genmesh::load_bricks_index(path, m);
+    assert(r.ok);
+    assert(r.index.bricks.size() == 2);
+    assert(r.index.bricks[1].content_hash.value() == "0123456789abcdef");
+
+    // same offset must describe the same bytes
+    j["bricks"][1]["content_hash"] = "fedcba9876543210";
+    write_temp_json(j, "_bi_shared.json");
+    auto rh = genmesh::load_bricks_index(path, m);
+    assert(!rh.ok);
+    assert(has_error_code(rh, genmesh::E1101));
+
+    // content_hash must be hex
+    j["bricks"][1]["content_hash"] = "not-a-hash";
+    write_temp_json(j, "_bi_shared.json");
+    auto rx = genmesh::load_bricks_index(path, m);
+    assert(!rx.ok);
+    assert(has_error_code(rx, genmesh::E1101));
+    std::remove(path.c_str());
+
+    std::cout << "  PASS: test_shared_payloads\n";
+}
+
 void test_optional_crc32() {
     auto j = valid_base();
     j["bricks"][0]["crc32"] = "abcd1234";
@@ -199,10 +357,256 @@ void test_optional_crc32() {
     assert(r.ok);
     assert(r.index.bricks[0].crc32.has_value());
     assert(r.index.bricks[0].crc32.value() == "abcd1234");
+
+    // exactly 8 hex digits: malformed, too long or too short values are errors
+    for (const char* bad : {"xyz", "1ffffffff", "abcd", "0xabcd12", "-abcd123", " abcd123"}) {
+        j["bricks"][0]["crc32"] = bad;
+        write_temp_json(j, "_bi_crc.json");
+        auto rb = genmesh::load_bricks_index(path, m);
+        assert(!rb.ok);
+        assert(has_error_code(rb, genmesh::E1101));
+
+        // an index built in code goes through the same check
+        auto idx = r.index;
+        idx.bricks[0].crc32 = bad;
+        auto rv = genmesh::validate_bricks_index(idx, m);
+        assert(!rv.ok);
+        assert(has_error_code(rv, genmesh::E1101));
+    }
+    j["bricks"][0]["crc32"] = 1234;
+    write_temp_json(j, "_bi_crc.json");
+    assert(!genmesh::load_bricks_index(path, m).ok);
+
+    uint32_t crc = 0;
+    assert(genmesh::parse_crc32_hex("ABCDEF01", crc) && crc == 0xabcdef01u);
+    assert(!genmesh::parse_crc32_hex("1ffffffff", crc) && crc == 0xabcdef01u);
+
     std::remove(path.c_str());
     std::cout << "  PASS: test_optional_crc32\n";
 }
 
+void test_streaming_parse() {
+    auto m = make_manifest();
+
+    // header after "bricks", repeated keys (last one wins), unknown fields skipped
+    {
+        std::ofstream ofs("_bi_stream.json");
+        ofs << R"({"bricks": [{"bx": "x", "bx": 0, "by": 0, "bz": 0, "extra": {"a": [1, 2]},)"
+            << R"( "offset_bytes": 0, "payload_bytes": 1048576, "encoding": "raw"}],)"
+            << R"( "version": 2, "version": 1, "brick_size": 64, "dtype": "f32",)"
+            << R"( "axis_order": "x-fastest", "dims": [64, 64, 64]})";
+    }
+    auto r = genmesh::load_bricks_index("_bi_stream.json", m);
+    assert(r.ok);
+    assert(r.index.version == 1);
+    assert(r.index.bricks.size() == 1);
+    assert(r.index.bricks[0].bx == 0);
+    assert(r.index.bricks[0].payload_bytes == 1048576);
+
+    // a later invalid value clears an earlier valid one
+    {
+        std::ofstream ofs("_bi_stream.json");
+        ofs << R"({"version": 1, "brick_size": 64, "dtype": "f32", "axis_order": "x-fastest",)"
+            << R"( "dims": [64, 64, 64], "dims": ["a", 64, 64], "bricks": []})";
+    }
+    auto rd = genmesh::load_bricks_index("_bi_stream.json", m);
+    assert(!rd.ok);
+    assert(rd.errors.size() == 1);
+    assert(rd.errors[0].field == "dims");
+    assert(rd.index.dims[0] == 0);
+
+    // non-object root: every field is missing
+    {
+        std::ofstream ofs("_bi_stream.json");
+        ofs << "[1, 2, 3]";
+    }
+    auto ra = genmesh::load_bricks_index("_bi_stream.json", m);
+    assert(!ra.ok);
+    assert(ra.errors.size() == 6);
+    std::remove("_bi_stream.json");
+
+    std::cout << "  PASS: test_streaming_parse\n";
+}
+
+void test_large_index() {
+    // 32^3 bricks; only the trailing duplicate is reported
+    auto m = make_manifest();
+    m.dims = {2048, 2048, 2048};
+    auto j = valid_base();
+    j["dims"] = {2048, 2048, 2048};
+    auto& bricks = j["bricks"];
+    bricks = nlohmann::json::array();
+    int64_t offset = 0;
+    for (int bz = 0; bz < 32; ++bz) {
+        for (int by = 0; by < 32; ++by) {
+            for (int bx = 0; bx < 32; ++bx) {
+                bricks.push_back({{"bx", bx}, {"by", by}, {"bz", bz}, {"offset_bytes", offset},
+                                  {"payload_bytes", 1048576}, {"encoding", "raw"}});
+                offset += 1048576;
+            }
+        }
+    }
+    bricks.push_back({{"bx", 31}, {"by", 0}, {"bz", 17}, {"offset_bytes", offset},
+                      {"payload_bytes", 1048576}, {"encoding", "raw"}});
+    auto path = write_temp_json(j, "_bi_large.json");
+    auto r = genmesh::load_bricks_index(path, m);
+    assert(!r.ok);
+    assert(r.index.bricks.size() == 32 * 32 * 32 + 1);
+    assert(r.errors.size() == 1);
+    assert(r.errors[0].code == genmesh::E1102);
+    assert(r.errors[0].message == "bricks[32768] duplicate brick (31,0,17)");
+    std::remove(path.c_str());
+    std::cout << "  PASS: test_large_index\n";
+}
+
+void test_value_summary() {
+    auto j = valid_base();
+    j["bricks"][0]["min"] = -2.5;
+    j["bricks"][0]["max"] = 4.0;
+    j["bricks"][0]["crosses_iso"] = true;
+    auto path = write_temp_json(j, "_bi_summary.json");
+    auto m = make_manifest();
+    auto r = genmesh::load_bricks_index(path, m);
+    assert(r.ok);
+    assert(r.index.bricks[0].min.value() == -2.5f);
+    assert(r.index.bricks[0].max.value() == 4.0f);
+    assert(r.index.bricks[0].crosses_iso.value());
+
+    // every field is optional on its own ...
+    j["bricks"][0].erase("crosses_iso");
+    write_temp_json(j, "_bi_summary.json");
+    assert(genmesh::load_bricks_index(path, m).ok);
+
+    // ... but min and max come as a pair
+    j["bricks"][0].erase("max");
+    write_temp_json(j, "_bi_summary.json");
+    auto rp = genmesh::load_bricks_index(path, m);
+    assert(!rp.ok);
+    assert(has_error_code(rp, genmesh::E1101));
+
+    j["bricks"][0]["max"] = -3.0;  // min > max
+    write_temp_json(j, "_bi_summary.json");
+    auto ro = genmesh::load_bricks_index(path, m);
+    assert(!ro.ok);
+    assert(has_error_code(ro, genmesh::E1101));
+
+    j["bricks"][0]["max"] = "4";
+    write_temp_json(j, "_bi_summary.json");
+    auto rt = genmesh::load_bricks_index(path, m);
+    assert(!rt.ok);
+    assert(has_error_code(rt, genmesh::E1101));
+
+    j["bricks"][0]["max"] = 4.0;
+    j["bricks"][0]["crosses_iso"] = 1;
+    write_temp_json(j, "_bi_summary.json");
+    auto rc = genmesh::load_bricks_index(path, m);
+    assert(!rc.ok);
+    assert(has_error_code(rc, genmesh::E1101));
+
+    // constant value must lie inside its own summary
+    auto jk = valid_base();
+    jk["bricks"][0]["encoding"] = "constant";
+    jk["bricks"][0]["payload_bytes"] = 0;
+    jk["bricks"][0]["value"] = -1000.0;
+    jk["bricks"][0]["min"] = -1000.0;
+    jk["bricks"][0]["max"] = -1000.0;
+    write_temp_json(jk, "_bi_summary.json");
+    assert(genmesh::load_bricks_index(path, m).ok);
+    jk["bricks"][0]["max"] = -1001.0;
+    jk["bricks"][0]["min"] = -1001.0;
+    write_temp_json(jk, "_bi_summary.json");
+    auto rk = genmesh::load_bricks_index(path, m);
+    assert(!rk.ok);
+    assert(has_error_code(rk, genmesh::E1101));
+    std::remove(path.c_str());
+
+    std::cout << "  PASS: test_value_summary\n";
+}
+
+void test_clip_bricks_index() {
+    // 4x4x4 bricks of 16^3 f32; (0,0,0) shares the payload of (1,0,0)
+    auto m = make_manifest();
+    m.brick_size = 16;
+    m.aabb_min = {10.0f, 0.0f, 0.0f};
+    const int64_t bytes = 16 * 16 * 16 * 4;
+    genmesh::BricksIndex idx;
+    idx.brick_size = 16;
+    for (int bz = 0; bz < 4; ++bz)
+        for (int by = 0; by < 4; ++by)
+            for (int bx = 0; bx < 4; ++bx) {
+                const int64_t slot = bx + 4 * (by + 4 * bz);
+                idx.bricks.push_back({bx, by, bz, slot * bytes, bytes, "raw"});
+            }
+    idx.bricks[0].offset_bytes = bytes;
+    idx.bricks.back() = {3, 3, 3, 0, 0, "constant"};
+
+    // voxels x 20..30, y/z 0..15: brick (1,0,0) only
+    genmesh::WorldBox box;
+    box.min = {30.0f, 0.0f, 0.0f};
+    box.max = {40.0f, 15.0f, 15.0f};
+    auto clipped = idx;
+    auto cs = genmesh::clip_bricks_index(clipped, m, box, 0);
+    assert(cs.kept == 1 && cs.skipped == 63);
+    assert(clipped.bricks.size() == 1);
+    assert(clipped.bricks[0].bx == 1 && clipped.bricks[0].by == 0);
+    // neither the shared payload nor the constant brick count as skipped bytes
+    assert(cs.bytes_skipped == 61 * bytes);
+
+    // a margin pulls in the neighbours, index order is kept
+    clipped = idx;
+    cs = genmesh::clip_bricks_index(clipped, m, box, 2);
+    assert(cs.kept == 8);
+    for (size_t i = 1; i < clipped.bricks.size(); ++i) {
+        const auto& a = clipped.bricks[i - 1];
+        const auto& b = clipped.bricks[i];
+        assert(std::make_tuple(a.bz, a.by, a.bx) < std::make_tuple(b.bz, b.by, b.bx));
+        assert(a.bx >= 1 && a.bx <= 2 && a.by <= 1 && a.bz <= 1);
+    }
+
+    // a box beyond the volume keeps nothing
+    box.min = {100.0f, 0.0f, 0.0f};
+    box.max = {120.0f, 1.0f, 1.0f};
+    clipped = idx;
+    cs = genmesh::clip_bricks_index(clipped, m, box, 1);
+    assert(cs.kept == 0 && clipped.bricks.empty());
+
+    std::cout << "  PASS: test_clip_bricks_index\n";
+}
+
+void test_clip_margin_voxels() {
+    auto m = make_manifest();  // band 3 voxels of 1 mm
+    assert(genmesh::clip_margin_voxels(m) == 4);
+    m.offset_mm = -1.5f;
+    assert(genmesh::clip_margin_voxels(m) == 6);
+
+    // --shell erodes from data up to the wall thickness away
+    m.offset_mm = 0.0f;
+    assert(genmesh::clip_margin_voxels(m, 2.5f) == 7);
+    m.voxel_size = 0.5f;
+    assert(genmesh::clip_margin_voxels(m, 2.5f) == 9);
+
+    // --clip-bbox with --shell 20: the thick wall needs the neighbours of
+    // the region's brick that the plain margin leaves out
+    m = make_manifest();
+    m.brick_size = 16;
+    genmesh::BricksIndex idx;
+    idx.brick_size = 16;
+    for (int bz = 0; bz < 4; ++bz)
+        for (int by = 0; by < 4; ++by)
+            for (int bx = 0; bx < 4; ++bx)
+                idx.bricks.push_back({bx, by, bz, 0, 0, "constant"});
+    genmesh::WorldBox box;
+    box.min = {20.0f, 20.0f, 20.0f};
+    box.max = {27.0f, 27.0f, 27.0f};
+    auto plain = idx;
+    assert(genmesh::clip_bricks_index(plain, m, box, genmesh::clip_margin_voxels(m)).kept == 1);
+    auto shell = idx;
+    assert(genmesh::clip_bricks_index(shell, m, box, genmesh::clip_margin_voxels(m, 20.0f)).kept ==
+           64);
+
+    std::cout << "  PASS: test_clip_margin_voxels\n";
+}
+
 int main() {
     genmesh::min_log_level() = genmesh::LogLevel::Error;
 
@@ -218,7 +622,16 @@ int main() {
     test_brick_out_of_range();
     test_payload_bytes_mismatch();
     test_invalid_encoding();
+    test_compressed_encodings();
+    test_band_quantized_encodings();
+    test_constant_encoding();
+    test_shared_payloads();
     test_optional_crc32();
+    test_value_summary();
+    test_clip_bricks_index();
+    test_clip_margin_voxels();
+    test_streaming_parse();
+    test_large_index();
 
     std::cout << "=== All T2.1 tests passed ===\n";
     return 0;
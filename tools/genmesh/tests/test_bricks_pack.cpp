@@ -0,0 +1,331 @@
+// bricks.pack container tests
+//
+// Packs are written from a programmatically generated bricks.bin + index
+// (brick_size=32, 3x2x1 bricks) and read back through load_bricks_pack()
+// and load_bricks_bin().
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include "genmesh/brick_codec.h"
+#include "genmesh/bricks_data.h"
+#include "genmesh/bricks_index.h"
+#include "genmesh/bricks_pack.h"
+#include "genmesh/crc32.h"
+#include "genmesh/error_code.h"
+#include "genmesh/log.h"
+#include "genmesh/manifest.h"
+#include "genmesh/mapped_file.h"
+
+static constexpr int B = 32;
+static constexpr size_t kVoxels = static_cast<size_t>(B) * B * B;
+
+static std::string fixture_dir() {
+    std::string file = __FILE__;
+    auto pos = file.rfind("tests");
+    return file.substr(0, pos) + "tests/fixtures/";
+}
+
+static std::string manifest_json() {
+    std::ifstream ifs(fixture_dir() + "valid_manifest.json");
+    auto j = nlohmann::json::parse(ifs);
+    j["brick"]["size"] = B;
+    j["dims"] = {96, 64, 32};
+    j["aabb_size"] = {96.0, 64.0, 32.0};
+    return j.dump(2);
+}
+
+static std::vector<float> brick_values(float base) {
+    std::vector<float> v(kVoxels);
+    for (size_t i = 0; i < kVoxels; ++i) v[i] = base + static_cast<float>(i % 97) * 0.01f;
+    return v;
+}
+
+static bool has_error_code(const std::vector<genmesh::ValidationError>& errors,
+                           std::string_view code) {
+    for (const auto& e : errors) {
+        if (e.code == code) return true;
+    }
+    return false;
+}
+
+/// bricks.bin + index: a raw brick shared by two coordinates, a zstd brick
+/// and a constant brick, listed out of Morton order.
+static genmesh::BricksIndex write_inputs(const std::string& bin_path) {
+    const auto a = brick_values(-1.0f);
+    const auto c = brick_values(2.0f);
+    const auto zc = genmesh::encode_brick_payload(
+        "zstd", reinterpret_cast<const uint8_t*>(c.data()), kVoxels * sizeof(float), 0);
+
+    std::ofstream ofs(bin_path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(a.data()), kVoxels * sizeof(float));
+    ofs.write(reinterpret_cast<const char*>(zc.data()), static_cast<std::streamsize>(zc.size()));
+    ofs.close();
+
+    const int64_t raw_bytes = static_cast<int64_t>(kVoxels * sizeof(float));
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = B;
+    idx.dtype = "f32";
+    idx.axis_order = "x-fastest";
+    idx.dims = {96, 64, 32};
+    idx.bricks.push_back({2, 1, 0, 0, raw_bytes, "raw"});
+    idx.bricks.push_back({0, 1, 0, raw_bytes, static_cast<int64_t>(zc.size()), "zstd"});
+    idx.bricks.push_back({1, 0, 0, 0, raw_bytes, "raw"});
+    idx.bricks[0].min = -1.0f;
+    idx.bricks[0].max = -0.04f;
+    idx.bricks[1].crosses_iso = false;
+    genmesh::BrickEntry k{0, 0, 0, 0, 0, "constant"};
+    k.value = -0.5f;
+    idx.bricks.push_back(k);
+    return idx;
+}
+
+static std::string write_pack(const std::string& path) {
+    const std::string text = manifest_json();
+    auto mr = genmesh::parse_manifest(text);
+    assert(mr.ok);
+    auto idx = write_inputs("_pack_src.bin");
+    std::string err;
+    bool ok = genmesh::write_bricks_pack(path, text, mr.manifest, idx, "_pack_src.bin", &err);
+    assert(ok);
+    std::remove("_pack_src.bin");
+    return text;
+}
+
+void test_morton() {
+    uint32_t x, y, z;
+    genmesh::morton3_decode(genmesh::morton3_encode(1, 0, 0), x, y, z);
+    assert(x == 1 && y == 0 && z == 0);
+    assert(genmesh::morton3_encode(1, 0, 0) == 1);
+    assert(genmesh::morton3_encode(0, 1, 0) == 2);
+    assert(genmesh::morton3_encode(0, 0, 1) == 4);
+    assert(genmesh::morton3_encode(1, 1, 1) == 7);
+    assert(genmesh::morton3_encode(2, 0, 0) == 8);
+
+    const uint32_t max = (1u << 21) - 1;
+    genmesh::morton3_decode(genmesh::morton3_encode(max, 12345, max), x, y, z);
+    assert(x == max && y == 12345 && z == max);
+    genmesh::morton3_decode(genmesh::morton3_encode(0x155555, 0xaaaaa, 7), x, y, z);
+    assert(x == 0x155555 && y == 0xaaaaa && z == 7);
+    std::cout << "  PASS: test_morton\n";
+}
+
+void test_roundtrip() {
+    write_pack("_roundtrip.pack");
+
+    auto r = genmesh::load_bricks_pack("_roundtrip.pack");
+    assert(r.ok);
+    assert(r.manifest.brick_size == B);
+    assert(r.manifest.dims[0] == 96);
+    assert(r.index.brick_size == B);
+    assert(r.index.dtype == "f32");
+    assert(r.index.bricks.size() == 4);
+
+    // directory order: (0,0,0) (1,0,0) (0,1,0) (2,1,0)
+    const auto& e = r.index.bricks;
+    assert(e[0].bx == 0 && e[0].by == 0 && e[0].encoding == "constant");
+    assert(e[0].value.has_value() && *e[0].value == -0.5f);
+    assert(e[1].bx == 1 && e[1].by == 0 && e[1].encoding == "raw");
+    assert(e[2].bx == 0 && e[2].by == 1 && e[2].encoding == "zstd");
+    assert(e[3].bx == 2 && e[3].by == 1 && e[3].encoding == "raw");
+    // optional summaries survive the directory
+    assert(e[3].min.value() == -1.0f && e[3].max.value() == -0.04f);
+    assert(!e[3].crosses_iso.has_value());
+    assert(e[2].crosses_iso.has_value() && !*e[2].crosses_iso);
+    assert(!e[2].min.has_value() && !e[1].min.has_value());
+    // the shared payload is stored once, every payload is page aligned
+    assert(e[1].offset_bytes == e[3].offset_bytes);
+    assert(e[1].offset_bytes % genmesh::kPackAlignment == 0);
+    assert(e[2].offset_bytes % genmesh::kPackAlignment == 0);
+    assert(e[2].offset_bytes != e[1].offset_bytes);
+
+    // the pack reads like bricks.bin, in every mode
+    for (auto mode : {genmesh::ReadMode::Stream, genmesh::ReadMode::Mmap,
+                      genmesh::ReadMode::Coalesced}) {
+        genmesh::BricksReadOptions opts;
+        opts.mode = mode;
+        auto br = genmesh::load_bricks_bin("_roundtrip.pack", r.index, r.manifest, opts);
+        assert(br.ok);
+        assert(br.bricks.size() == 4);
+        assert(br.bricks[0].constant.has_value());
+        const auto a = brick_values(-1.0f);
+        const auto c = brick_values(2.0f);
+        assert(std::memcmp(br.bricks[1].data(), a.data(), kVoxels * sizeof(float)) == 0);
+        assert(std::memcmp(br.bricks[2].data(), c.data(), kVoxels * sizeof(float)) == 0);
+        assert(std::memcmp(br.bricks[3].data(), a.data(), kVoxels * sizeof(float)) == 0);
+    }
+
+    std::remove("_roundtrip.pack");
+    std::cout << "  PASS: test_roundtrip\n";
+}
+
+void test_find() {
+    write_pack("_find.pack");
+    auto pack = genmesh::BricksPack::open(genmesh::MappedFile::open("_find.pack"));
+    assert(pack);
+    assert(pack->brick_count() == 4);
+
+    const auto* z = pack->find(0, 1, 0);
+    assert(z != nullptr);
+    assert(z->encoding == static_cast<uint8_t>(genmesh::PackEncoding::Zstd));
+    assert(pack->payload(*z) != nullptr);
+
+    const auto* k = pack->find(0, 0, 0);
+    assert(k != nullptr);
+    assert(pack->payload(*k) == nullptr);
+    assert(k->value == -0.5f);
+
+    const auto* raw = pack->find(2, 1, 0);
+    assert(raw != nullptr);
+    const auto a = brick_values(-1.0f);
+    assert(std::memcmp(pack->payload(*raw), a.data(), kVoxels * sizeof(float)) == 0);
+
+    assert(pack->find(1, 1, 0) == nullptr);   // absent
+    assert(pack->find(3, 0, 0) == nullptr);   // outside the grid
+    assert(pack->find(-1, 0, 0) == nullptr);
+
+    auto text = pack->manifest_json();
+    assert(genmesh::parse_manifest(text).ok);
+
+    pack.reset();
+    std::remove("_find.pack");
+    std::cout << "  PASS: test_find\n";
+}
+
+// Patch `len` bytes at `offset` of a copy of the pack
+static void patch(const std::string& path, int64_t offset, const void* bytes, size_t len) {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(offset);
+    f.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(len));
+}
+
+void test_invalid_pack() {
+    auto r = genmesh::load_bricks_pack("nonexistent.pack");
+    assert(!r.ok);
+    assert(r.exit_code == genmesh::ExitCode::IoError);
+    assert(has_error_code(r.errors, genmesh::E2003));
+
+    // bad magic
+    write_pack("_bad.pack");
+    patch("_bad.pack", 0, "XXXX", 4);
+    r = genmesh::load_bricks_pack("_bad.pack");
+    assert(!r.ok);
+    assert(r.exit_code == genmesh::ExitCode::ValidationFailure);
+    assert(has_error_code(r.errors, genmesh::E1101));
+
+    // truncated copy
+    write_pack("_bad.pack");
+    {
+        std::ifstream ifs("_bad.pack", std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        ifs.close();
+        std::ofstream ofs("_bad.pack", std::ios::binary | std::ios::trunc);
+        ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 100));
+    }
+    r = genmesh::load_bricks_pack("_bad.pack");
+    assert(!r.ok);
+    assert(has_error_code(r.errors, genmesh::E1101));
+
+    // slot table pointing at the wrong entry
+    write_pack("_bad.pack");
+    genmesh::PackHeader h;
+    {
+        std::ifstream ifs("_bad.pack", std::ios::binary);
+        ifs.read(reinterpret_cast<char*>(&h), sizeof(h));
+    }
+    const uint32_t wrong = 2;  // cell (0,0,0) -> entry 1
+    patch("_bad.pack", static_cast<int64_t>(h.slots_offset), &wrong, sizeof(wrong));
+    r = genmesh::load_bricks_pack("_bad.pack");
+    assert(!r.ok);
+    assert(has_error_code(r.errors, genmesh::E1101));
+
+    // directory entries swapped: no longer in Morton order
+    write_pack("_bad.pack");
+    genmesh::PackDirEntry d[2];
+    {
+        std::ifstream ifs("_bad.pack", std::ios::binary);
+        ifs.seekg(static_cast<int64_t>(h.directory_offset));
+        ifs.read(reinterpret_cast<char*>(d), sizeof(d));
+    }
+    std::swap(d[0], d[1]);
+    patch("_bad.pack", static_cast<int64_t>(h.directory_offset), d, sizeof(d));
+    r = genmesh::load_bricks_pack("_bad.pack");
+    assert(!r.ok);
+    assert(has_error_code(r.errors, genmesh::E1101));
+
+    // index rules still apply: constant brick with a payload size
+    write_pack("_bad.pack");
+    {
+        std::ifstream ifs("_bad.pack", std::ios::binary);
+        ifs.seekg(static_cast<int64_t>(h.directory_offset));
+        ifs.read(reinterpret_cast<char*>(d), sizeof(d));
+    }
+    d[0].payload_bytes = 16;
+    patch("_bad.pack", static_cast<int64_t>(h.directory_offset), d, sizeof(d[0]));
+    r = genmesh::load_bricks_pack("_bad.pack");
+    assert(!r.ok);
+    assert(has_error_code(r.errors, genmesh::E1104));
+
+    std::remove("_bad.pack");
+    std::cout << "  PASS: test_invalid_pack\n";
+}
+
+void test_write_crc32() {
+    const std::string text = manifest_json();
+    auto mr = genmesh::parse_manifest(text);
+    assert(mr.ok);
+    const auto a = brick_values(-1.0f);
+    const uint32_t crc = genmesh::crc32(a.data(), kVoxels * sizeof(float));
+
+    // a valid crc32 lands in the directory and reads back as 8 hex digits
+    auto idx = write_inputs("_pack_src.bin");
+    char hex[9];
+    std::snprintf(hex, sizeof(hex), "%08X", crc);
+    idx.bricks[0].crc32 = hex;
+    idx.bricks[2].crc32 = hex;
+    std::string err;
+    assert(genmesh::write_bricks_pack("_crc.pack", text, mr.manifest, idx, "_pack_src.bin", &err));
+    auto r = genmesh::load_bricks_pack("_crc.pack");
+    assert(r.ok);
+    uint32_t read_back = 0;
+    assert(genmesh::parse_crc32_hex(r.index.bricks[1].crc32.value(), read_back));
+    assert(read_back == crc);
+    auto br = genmesh::load_bricks_bin("_crc.pack", r.index, r.manifest);
+    assert(br.ok);
+
+    // malformed or over-long values fail the write instead of throwing or truncating
+    for (const char* bad : {"xyz", "1ffffffff", "abcd"}) {
+        idx.bricks[0].crc32 = bad;
+        err.clear();
+        assert(!genmesh::write_bricks_pack("_crc.pack", text, mr.manifest, idx, "_pack_src.bin",
+                                           &err));
+        assert(err.find("crc32") != std::string::npos);
+    }
+
+    std::remove("_pack_src.bin");
+    std::remove("_crc.pack");
+    std::cout << "  PASS: test_write_crc32\n";
+}
+
+int main() {
+    genmesh::min_log_level() = genmesh::LogLevel::Error;
+
+    std::cout << "=== bricks.pack tests ===\n";
+
+    test_morton();
+    test_roundtrip();
+    test_find();
+    test_invalid_pack();
+    test_write_crc32();
+
+    std::cout << "=== All bricks.pack tests passed ===\n";
+    return 0;
+}
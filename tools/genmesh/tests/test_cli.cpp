@@ -124,6 +124,259 @@ void test_missing_value() {
     std::cout << "  PASS: test_missing_value\n";
 }
 
+void test_threads() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--threads", "4"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(r.args.threads == 4);
+
+    // the whole value must be a number
+    for (const char* bad : {"4abc", "abc", "-1", "2.5", ""}) {
+        ArgBuilder bb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                      "--threads", bad};
+        auto rb = genmesh::parse_args(bb.argc(), bb.argv());
+        assert(!rb.ok);
+        assert(rb.exit_code == static_cast<int>(genmesh::ExitCode::General));
+    }
+    std::cout << "  PASS: test_threads\n";
+}
+
+void test_read_mode() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--read-mode", "mmap"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(r.args.read_mode == "mmap");
+
+    ArgBuilder bad{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                   "--read-mode", "aio"};
+    auto rb = genmesh::parse_args(bad.argc(), bad.argv());
+    assert(!rb.ok);
+    assert(rb.exit_code == static_cast<int>(genmesh::ExitCode::General));
+
+    ArgBuilder co{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--direct-io", "--read-mode", "coalesced"};
+    auto rc = genmesh::parse_args(co.argc(), co.argv());
+    assert(rc.ok);
+    assert(rc.args.read_mode == "coalesced");
+    assert(rc.args.direct_io);
+
+    // O_DIRECT is only wired into the coalesced reader
+    ArgBuilder dio{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                   "--direct-io"};
+    auto rd = genmesh::parse_args(dio.argc(), dio.argv());
+    assert(!rd.ok);
+    assert(rd.exit_code == static_cast<int>(genmesh::ExitCode::General));
+    std::cout << "  PASS: test_read_mode\n";
+}
+
+void test_crc_verify() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(r.args.crc_verify == "inline");
+
+    ArgBuilder bg{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--crc-verify", "background"};
+    auto rg = genmesh::parse_args(bg.argc(), bg.argv());
+    assert(rg.ok);
+    assert(rg.args.crc_verify == "background");
+
+    ArgBuilder bad{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                   "--crc-verify", "never"};
+    auto rb = genmesh::parse_args(bad.argc(), bad.argv());
+    assert(!rb.ok);
+    assert(rb.exit_code == static_cast<int>(genmesh::ExitCode::General));
+    std::cout << "  PASS: test_crc_verify\n";
+}
+
+void test_pack() {
+    // --pack replaces --manifest / --in
+    ArgBuilder ab{"genmesh", "--pack", "job.pack", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(r.args.pack_path == "job.pack");
+    assert(r.args.manifest_path.empty());
+
+    ArgBuilder mix{"genmesh", "--pack", "job.pack", "--in", "d/", "--out", "o/"};
+    auto rm = genmesh::parse_args(mix.argc(), mix.argv());
+    assert(!rm.ok);
+    assert(rm.exit_code == static_cast<int>(genmesh::ExitCode::General));
+
+    ArgBuilder no_out{"genmesh", "--pack", "job.pack"};
+    auto ro = genmesh::parse_args(no_out.argc(), no_out.argv());
+    assert(!ro.ok);
+    assert(ro.exit_code == static_cast<int>(genmesh::ExitCode::ValidationFailure));
+    std::cout << "  PASS: test_pack\n";
+}
+
+void test_cull_bricks() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(!r.args.cull_bricks);
+
+    ArgBuilder cb{"genmesh", "--pack", "job.pack", "--out", "o/", "--cull-bricks"};
+    auto rc = genmesh::parse_args(cb.argc(), cb.argv());
+    assert(rc.ok);
+    assert(rc.args.cull_bricks);
+    std::cout << "  PASS: test_cull_bricks\n";
+}
+
+void test_narrow_band() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(!r.args.narrow_band);
+
+    ArgBuilder nb{"genmesh", "--debug-generate", "sphere", "--out", "o/", "--narrow-band"};
+    auto rn = genmesh::parse_args(nb.argc(), nb.argv());
+    assert(rn.ok);
+    assert(rn.args.narrow_band);
+    std::cout << "  PASS: test_narrow_band\n";
+}
+
+void test_half() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(!r.args.half);
+
+    ArgBuilder hb{"genmesh", "--pack", "job.pack", "--out", "o/", "--write-vdb", "--half"};
+    auto rh = genmesh::parse_args(hb.argc(), hb.argv());
+    assert(rh.ok);
+    assert(rh.args.half);
+    assert(rh.args.write_vdb);
+    std::cout << "  PASS: test_half\n";
+}
+
+void test_huge_pages() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(!r.args.huge_pages);
+
+    ArgBuilder hb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--huge-pages"};
+    auto rh = genmesh::parse_args(hb.argc(), hb.argv());
+    assert(rh.ok);
+    assert(rh.args.huge_pages);
+    std::cout << "  PASS: test_huge_pages\n";
+}
+
+void test_clip_bbox() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--clip-bbox", "-10.5,0,2..10,20.25,3e1"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(r.args.clip_min.has_value() && r.args.clip_max.has_value());
+    assert((*r.args.clip_min)[0] == -10.5f && (*r.args.clip_min)[2] == 2.0f);
+    assert((*r.args.clip_max)[1] == 20.25f && (*r.args.clip_max)[2] == 30.0f);
+
+    ArgBuilder none{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    assert(!genmesh::parse_args(none.argc(), none.argv()).args.clip_min.has_value());
+
+    for (const char* bad : {"0,0,0", "0,0..1,1,1", "0,0,0..1,1", "0,0,0..1,1,1,1",
+                            "0,0,x..1,1,1", "0,0,5..1,1,1", "0,0,0..1,1,1.5mm"}) {
+        ArgBuilder bb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                      "--clip-bbox", bad};
+        auto rb = genmesh::parse_args(bb.argc(), bb.argv());
+        assert(!rb.ok);
+        assert(rb.exit_code == static_cast<int>(genmesh::ExitCode::General));
+    }
+    std::cout << "  PASS: test_clip_bbox\n";
+}
+
+void test_shell() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(!r.args.shell_mm.has_value());
+    assert(r.args.drain_holes.empty());
+    assert(r.args.drain_radius_mm == 1.5f);
+
+    ArgBuilder sb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--shell", "2.5", "--drain-hole", "10,0,10..10,-5,10",
+                  "--drain-hole", "0,0,0..0,0,-4", "--drain-radius", "2"};
+    auto rs = genmesh::parse_args(sb.argc(), sb.argv());
+    assert(rs.ok);
+    assert(rs.args.shell_mm.value() == 2.5f);
+    assert(rs.args.drain_holes.size() == 2);
+    assert(rs.args.drain_holes[0].from[0] == 10.0f);
+    assert(rs.args.drain_holes[0].to[1] == -5.0f);
+    assert(rs.args.drain_holes[1].to[2] == -4.0f);
+    assert(rs.args.drain_radius_mm == 2.0f);
+
+    for (const char* bad : {"0", "-1", "abc"}) {
+        ArgBuilder bb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                      "--shell", bad};
+        auto rb = genmesh::parse_args(bb.argc(), bb.argv());
+        assert(!rb.ok);
+        assert(rb.exit_code == static_cast<int>(genmesh::ExitCode::General));
+    }
+
+    ArgBuilder hb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--shell", "2", "--drain-hole", "1,2,3"};
+    assert(!genmesh::parse_args(hb.argc(), hb.argv()).ok);
+
+    ArgBuilder rb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--shell", "2", "--drain-radius", "0"};
+    assert(!genmesh::parse_args(rb.argc(), rb.argv()).ok);
+
+    // drain holes only make sense through a shell
+    ArgBuilder nb{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--drain-hole", "0,0,0..0,0,-4"};
+    auto rn = genmesh::parse_args(nb.argc(), nb.argv());
+    assert(!rn.ok);
+    assert(rn.exit_code == static_cast<int>(genmesh::ExitCode::General));
+    std::cout << "  PASS: test_shell\n";
+}
+
+void test_infill() {
+    ArgBuilder ab{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/"};
+    auto r = genmesh::parse_args(ab.argc(), ab.argv());
+    assert(r.ok);
+    assert(r.args.infill.empty());
+    assert(r.args.infill_cell_mm == 8.0f);
+    assert(r.args.infill_wall_mm == 0.8f);
+
+    for (const char* surface : {"gyroid", "schwarz-p", "diamond"}) {
+        ArgBuilder ib{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                      "--shell", "2", "--infill", surface, "--infill-cell", "12",
+                      "--infill-wall", "1.2"};
+        auto ri = genmesh::parse_args(ib.argc(), ib.argv());
+        assert(ri.ok);
+        assert(ri.args.infill == surface);
+        assert(ri.args.infill_cell_mm == 12.0f);
+        assert(ri.args.infill_wall_mm == 1.2f);
+    }
+
+    ArgBuilder bad{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                   "--shell", "2", "--infill", "honeycomb"};
+    auto rb = genmesh::parse_args(bad.argc(), bad.argv());
+    assert(!rb.ok);
+    assert(rb.exit_code == static_cast<int>(genmesh::ExitCode::General));
+
+    ArgBuilder zero{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                    "--shell", "2", "--infill", "gyroid", "--infill-cell", "0"};
+    assert(!genmesh::parse_args(zero.argc(), zero.argv()).ok);
+
+    // walls as thick as the cell leave no lattice
+    ArgBuilder thick{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                     "--shell", "2", "--infill", "gyroid", "--infill-cell", "4",
+                     "--infill-wall", "4"};
+    assert(!genmesh::parse_args(thick.argc(), thick.argv()).ok);
+
+    // the lattice fills the cavity of a shell
+    ArgBuilder ns{"genmesh", "--manifest", "p.json", "--in", "d/", "--out", "o/",
+                  "--infill", "gyroid"};
+    auto rn = genmesh::parse_args(ns.argc(), ns.argv());
+    assert(!rn.ok);
+    assert(rn.exit_code == static_cast<int>(genmesh::ExitCode::General));
+    std::cout << "  PASS: test_infill\n";
+}
+
 int main() {
     std::cout << "=== T1.1 CLI parsing tests ===\n";
 
@@ -137,6 +390,17 @@ int main() {
     test_debug_generate_missing_out();
     test_invalid_log_level();
     test_missing_value();
+    test_threads();
+    test_read_mode();
+    test_crc_verify();
+    test_pack();
+    test_cull_bricks();
+    test_narrow_band();
+    test_half();
+    test_huge_pages();
+    test_clip_bbox();
+    test_shell();
+    test_infill();
 
     std::cout << "=== All T1.1 tests passed ===\n";
     return 0;
@@ -0,0 +1,95 @@
+// CRC32 kernel tests (slice-by-16 / PCLMULQDQ) against a bitwise reference
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "genmesh/crc32.h"
+
+// Bit-at-a-time reference (zlib polynomial, reflected)
+static uint32_t crc32_ref(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; ++j) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+        }
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static std::vector<uint8_t> random_bytes(size_t n, uint32_t seed) {
+    std::vector<uint8_t> v(n);
+    std::mt19937 rng(seed);
+    for (auto& b : v) b = static_cast<uint8_t>(rng());
+    return v;
+}
+
+static const genmesh::Crc32Kernel kKernels[] = {
+    genmesh::Crc32Kernel::Slice16,
+    genmesh::Crc32Kernel::Pclmul,
+    genmesh::Crc32Kernel::Auto,
+};
+
+void test_known_vectors() {
+    const char* check = "123456789";
+    for (auto k : kKernels) {
+        assert(genmesh::crc32(check, 9, 0, k) == 0xCBF43926u);
+        assert(genmesh::crc32(nullptr, 0, 0, k) == 0u);
+    }
+
+    // 64 zero bytes: shortest input that takes the folding path
+    std::vector<uint8_t> zeros(64, 0);
+    for (auto k : kKernels) {
+        assert(genmesh::crc32(zeros.data(), zeros.size(), 0, k) == 0x758D6336u);
+    }
+    std::cout << "  PASS: test_known_vectors (auto=" << genmesh::crc32_kernel_name() << ")\n";
+}
+
+void test_lengths_and_offsets() {
+    const auto buf = random_bytes(4096 + 16, 7);
+
+    for (auto k : kKernels) {
+        if (!genmesh::crc32_kernel_supported(k)) {
+            std::cout << "    (kernel " << static_cast<int>(k) << " not supported, skipped)\n";
+            continue;
+        }
+        for (size_t off = 0; off < 4; ++off) {
+            for (size_t len = 0; len <= 300; ++len) {
+                assert(genmesh::crc32(buf.data() + off, len, 0, k) ==
+                       crc32_ref(buf.data() + off, len));
+            }
+        }
+        assert(genmesh::crc32(buf.data() + 3, 4096, 0, k) == crc32_ref(buf.data() + 3, 4096));
+    }
+    std::cout << "  PASS: test_lengths_and_offsets\n";
+}
+
+void test_chaining() {
+    // A B=64 f32 brick is 1 MiB; split it at awkward points.
+    const auto buf = random_bytes(64 * 64 * 64 * 4, 11);
+    const uint32_t whole = crc32_ref(buf.data(), buf.size());
+
+    for (auto k : kKernels) {
+        assert(genmesh::crc32(buf.data(), buf.size(), 0, k) == whole);
+        for (size_t split : {size_t(1), size_t(63), size_t(64), size_t(1000), buf.size() - 17}) {
+            uint32_t c = genmesh::crc32(buf.data(), split, 0, k);
+            c = genmesh::crc32(buf.data() + split, buf.size() - split, c, k);
+            assert(c == whole);
+        }
+    }
+    std::cout << "  PASS: test_chaining\n";
+}
+
+int main() {
+    std::cout << "=== CRC32 tests ===\n";
+
+    test_known_vectors();
+    test_lengths_and_offsets();
+    test_chaining();
+
+    std::cout << "=== All CRC32 tests passed ===\n";
+    return 0;
+}
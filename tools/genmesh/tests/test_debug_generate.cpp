@@ -1,8 +1,10 @@
 // T3.1 debug-generate sphere/box tests
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "genmesh/debug_generate.h"
 #include "genmesh/log.h"
@@ -153,6 +155,43 @@ void test_custom_voxel_size() {
     std::cout << "  PASS: test_custom_voxel_size\n";
 }
 
+void test_sink_matches_collected() {
+    // streamed bricks arrive in order, same as the collected ones
+    auto collected = genmesh::debug_generate("box", 128, 1.0f);
+    assert(collected.ok);
+    assert(collected.brick_count == collected.bricks.size());
+
+    size_t i = 0;
+    const float* slot = nullptr;
+    auto streamed = genmesh::debug_generate("box", 128, 1.0f,
+                                            [&](const genmesh::BrickData& bd) {
+                                                assert(i < collected.bricks.size());
+                                                const auto& want = collected.bricks[i++];
+                                                assert(bd.bx == want.bx && bd.by == want.by &&
+                                                       bd.bz == want.bz);
+                                                // computed into one recycled arena slot
+                                                assert(bd.values.empty() && bd.view);
+                                                assert(!slot || bd.view == slot);
+                                                slot = bd.view;
+                                                assert(bd.size() == want.values.size());
+                                                assert(std::equal(want.values.begin(),
+                                                                  want.values.end(), bd.data()));
+                                            });
+    assert(streamed.ok);
+    assert(streamed.bricks.empty());
+    assert(streamed.brick_count == collected.bricks.size());
+    assert(i == collected.bricks.size());
+    assert(streamed.manifest.dims == collected.manifest.dims);
+
+    // the manifest is available up front
+    auto m = genmesh::debug_manifest(128, 1.0f);
+    assert(m.dims == collected.manifest.dims);
+    assert(m.brick_size == collected.manifest.brick_size);
+    assert(m.background_value_mm == collected.manifest.background_value_mm);
+
+    std::cout << "  PASS: test_sink_matches_collected\n";
+}
+
 int main() {
     genmesh::min_log_level() = genmesh::LogLevel::Error;
 
@@ -166,6 +205,7 @@ int main() {
     test_unknown_shape();
     test_multi_brick_grid();
     test_custom_voxel_size();
+    test_sink_matches_collected();
 
     std::cout << "=== All T3.1 tests passed ===\n";
     return 0;
@@ -1,11 +1,13 @@
 /// @file test_e2e.cpp
 /// Phase 7: End-to-end integration tests.
-///   T7.1  – fixture-based pipeline (manifest + bricks.index + bricks.bin)
+///   T7.1  – fixture-based pipeline (manifest + bricks.index + bricks.bin, bricks.pack)
 ///   T7.2  – debug-generate sphere → mesh.stl + report.json
 ///   T7.3  – regression baseline (tri/vertex/quad counts, mesh AABB)
+///   T7.4  – streamed build: peak RSS bounded by the grid, not grid + bricks
 
 #include "genmesh/bricks_data.h"
 #include "genmesh/bricks_index.h"
+#include "genmesh/bricks_pack.h"
 #include "genmesh/debug_generate.h"
 #include "genmesh/error_code.h"
 #include "genmesh/exit_code.h"
@@ -17,6 +19,7 @@
 #include "genmesh/vdb_builder.h"
 
 #include <nlohmann/json.hpp>
+#include <tbb/global_control.h>
 
 #include <algorithm>
 #include <cassert>
@@ -24,10 +27,19 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define GENMESH_TEST_FORK 1
+#endif
+
 namespace fs = std::filesystem;
 
 static int tests_run = 0;
@@ -433,6 +445,43 @@ void test_e2e_file_pipeline() {
     fs::remove_all(dir);
 }
 
+void test_e2e_pack_pipeline() {
+    auto dir = make_temp_dir("pack_pipeline");
+    auto manifest_path = write_valid_fixture_set(dir);
+
+    auto mr = genmesh::load_manifest(manifest_path);
+    ASSERT(mr.ok);
+    auto ir = genmesh::load_bricks_index((dir / "bricks.index.json").string(), mr.manifest);
+    ASSERT(ir.ok);
+
+    // Convert the three-file set into a single bricks.pack
+    std::string manifest_text;
+    {
+        std::ifstream ifs(manifest_path);
+        manifest_text.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    auto pack_path = (dir / "bricks.pack").string();
+    std::string err;
+    ASSERT(genmesh::write_bricks_pack(pack_path, manifest_text, mr.manifest, ir.index,
+                                      (dir / "bricks.bin").string(), &err));
+
+    // Same structs, same mesh as the file pipeline
+    auto pr = genmesh::load_bricks_pack(pack_path);
+    ASSERT(pr.ok);
+    ASSERT(pr.manifest.dims == mr.manifest.dims);
+    ASSERT(pr.index.bricks.size() == ir.index.bricks.size());
+
+    auto br = genmesh::load_bricks_bin(pack_path, pr.index, pr.manifest);
+    ASSERT(br.ok);
+    auto vdb = genmesh::build_vdb(pr.manifest, br.bricks);
+    ASSERT(vdb.ok);
+    auto mesh = genmesh::extract_mesh(vdb.grid, 0.0, 0.0);
+    ASSERT(mesh.ok);
+    ASSERT(static_cast<int64_t>(mesh.mesh.triangles.size()) == 24672);
+
+    fs::remove_all(dir);
+}
+
 void test_e2e_invalid_manifest_no_dims() {
     auto manifest_path = (fixture_dir() / "invalid_manifest_no_dims.json").string();
     auto mr = genmesh::load_manifest(manifest_path);
@@ -498,6 +547,163 @@ void test_e2e_failure_report_is_written() {
     fs::remove_all(dir);
 }
 
+void test_e2e_stream_pipeline() {
+    auto dir = make_temp_dir("stream_pipeline");
+    auto manifest_path = write_valid_fixture_set(dir);
+
+    auto mr = genmesh::load_manifest(manifest_path);
+    ASSERT(mr.ok);
+    auto ir = genmesh::load_bricks_index((dir / "bricks.index.json").string(), mr.manifest);
+    ASSERT(ir.ok);
+
+    // Bricks go straight from the reader into the grid
+    genmesh::VdbStreamBuilder builder(mr.manifest);
+    auto br = genmesh::stream_bricks_bin((dir / "bricks.bin").string(), ir.index, mr.manifest,
+                                         {}, [&](const genmesh::BrickData& bd) { builder.add(bd); });
+    ASSERT(br.ok);
+    ASSERT(br.bricks.empty());
+    auto vdb = builder.finish();
+    ASSERT(vdb.ok);
+    ASSERT(vdb.brick_count == static_cast<int64_t>(ir.index.bricks.size()));
+
+    auto mesh = genmesh::extract_mesh(vdb.grid, 0.0, 0.0);
+    ASSERT(mesh.ok);
+    ASSERT(static_cast<int64_t>(mesh.mesh.triangles.size()) == 24672);
+
+    // debug_generate as the producer gives the collected sphere's grid
+    auto& pr = shared_sphere_result();
+    genmesh::VdbStreamBuilder dg_builder(genmesh::debug_manifest());
+    auto dg = genmesh::debug_generate("sphere", 64, 1.0f,
+                                      [&](const genmesh::BrickData& bd) { dg_builder.add(bd); });
+    ASSERT(dg.ok);
+    auto dg_vdb = dg_builder.finish();
+    ASSERT(dg_vdb.ok);
+    ASSERT(dg_vdb.active_voxel_count == pr.vdb.active_voxel_count);
+    ASSERT(dg_vdb.leaf_count == pr.vdb.leaf_count);
+
+    fs::remove_all(dir);
+}
+
+// ===================================================================
+//  T7.4  Peak RSS of the streamed build
+// ===================================================================
+
+#ifdef GENMESH_TEST_FORK
+
+/// Run `fn` in a forked child; returns the child's peak RSS in bytes
+/// (ru_maxrss) and stores what `fn` returned in `value`. -1 if the child
+/// failed. Forking is only safe while this process has no TBB workers.
+static int64_t child_peak_rss(const std::function<int64_t()>& fn, int64_t& value) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    const pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        close(fds[0]);
+        int64_t v = -1;
+        try {
+            v = fn();
+        } catch (const std::exception& e) {
+            std::cout << "(child: " << e.what() << ") ";
+        }
+        const bool sent = write(fds[1], &v, sizeof(v)) == static_cast<ssize_t>(sizeof(v));
+        _exit(sent && v >= 0 ? 0 : 1);
+    }
+    close(fds[1]);
+    int64_t v = -1;
+    const bool got = read(fds[0], &v, sizeof(v)) == static_cast<ssize_t>(sizeof(v));
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage ru {};
+    if (wait4(pid, &status, 0, &ru) != pid) return -1;
+    if (!got || !WIFEXITED(status) || WEXITSTATUS(status) != 0) return -1;
+    value = v;
+#ifdef __APPLE__
+    return static_cast<int64_t>(ru.ru_maxrss);  // bytes
+#else
+    return static_cast<int64_t>(ru.ru_maxrss) * 1024;  // KiB
+#endif
+}
+
+void test_stream_peak_rss() {
+    // 256^3 debug sphere: 64 bricks of 1 MiB, and a grid just as large
+    // (every voxel is active), written to bricks.bin one brick at a time.
+    auto dir = make_temp_dir("stream_rss");
+    const auto bin_path = (dir / "bricks.bin").string();
+    const auto m = genmesh::debug_manifest(256, 1.0f);
+    genmesh::BricksIndex idx;
+    idx.version = 1;
+    idx.brick_size = m.brick_size;
+    idx.dtype = m.dtype;
+    idx.axis_order = m.axis_order;
+    idx.dims = m.dims;
+    int64_t brick_bytes = 0;
+    {
+        std::ofstream ofs(bin_path, std::ios::binary);
+        auto dg = genmesh::debug_generate("sphere", 256, 1.0f,
+                                          [&](const genmesh::BrickData& bd) {
+            const auto bytes = static_cast<int64_t>(bd.values.size() * sizeof(float));
+            ofs.write(reinterpret_cast<const char*>(bd.values.data()), bytes);
+            idx.bricks.push_back({bd.bx, bd.by, bd.bz, brick_bytes, bytes, "raw", std::nullopt});
+            brick_bytes += bytes;
+        });
+        ASSERT(dg.ok);
+    }
+    const int64_t one_brick = brick_bytes / static_cast<int64_t>(idx.bricks.size());
+    ASSERT(idx.bricks.size() == 64);
+
+    // Children run on 4 workers, so about 4 bricks are in flight
+    int64_t unused = 0;
+    const int64_t rss_base = child_peak_rss([] { return int64_t{0}; }, unused);
+
+    int64_t grid_bytes = 0;
+    const int64_t rss_stream = child_peak_rss([&] {
+        tbb::global_control workers(tbb::global_control::max_allowed_parallelism, 4);
+        genmesh::VdbStreamBuilder builder(m);
+        auto br = genmesh::stream_bricks_bin(bin_path, idx, m, {},
+                                             [&](const genmesh::BrickData& bd) { builder.add(bd); });
+        ASSERT(br.ok);
+        auto vdb = builder.finish();
+        ASSERT(vdb.ok);
+        ASSERT(vdb.brick_count == 64);
+        return vdb.memory_bytes;
+    }, grid_bytes);
+
+    int64_t collected_grid_bytes = 0;
+    const int64_t rss_collected = child_peak_rss([&] {
+        tbb::global_control workers(tbb::global_control::max_allowed_parallelism, 4);
+        auto br = genmesh::load_bricks_bin(bin_path, idx, m);
+        ASSERT(br.ok);
+        auto vdb = genmesh::build_vdb(m, br.bricks);
+        ASSERT(vdb.ok);
+        return vdb.memory_bytes;
+    }, collected_grid_bytes);
+
+    ASSERT(rss_base > 0 && rss_stream > 0 && rss_collected > 0);
+    ASSERT(grid_bytes == collected_grid_bytes);
+    ASSERT(grid_bytes >= brick_bytes);
+    std::cout << "(base " << (rss_base >> 20) << " MiB, stream +" << ((rss_stream - rss_base) >> 20)
+              << " MiB, collected +" << ((rss_collected - rss_base) >> 20) << " MiB, grid "
+              << (grid_bytes >> 20) << " MiB) ";
+
+    // Streamed: the grid plus a few in-flight bricks and per-thread trees
+    ASSERT(rss_stream - rss_base <= grid_bytes + 16 * one_brick + (16 << 20));
+    // Collected: every brick is resident next to the grid
+    ASSERT(rss_collected - rss_base >= grid_bytes + brick_bytes / 2);
+    ASSERT(rss_collected - rss_stream >= brick_bytes / 2);
+
+    fs::remove_all(dir);
+}
+
+#else
+
+void test_stream_peak_rss() {
+    std::cout << "(no fork(); skipped) ";
+}
+
+#endif
+
 // ===================================================================
 //  main
 // ===================================================================
@@ -511,6 +717,10 @@ int main() {
 
     std::cout << "=== test_e2e ===\n";
 
+    // T7.4 first: it forks, which needs a process without TBB workers yet
+    std::cout << "\n--- T7.4: streamed build peak RSS ---\n";
+    RUN(test_stream_peak_rss);
+
     // T7.2: E2E debug-generate pipeline
     std::cout << "\n--- T7.2: E2E debug-generate ---\n";
     RUN(test_e2e_debug_generate_sphere_ok);
@@ -533,6 +743,8 @@ int main() {
     // T7.1: Fixture-based pipeline
     std::cout << "\n--- T7.1: fixture-based pipeline ---\n";
     RUN(test_e2e_file_pipeline);
+    RUN(test_e2e_pack_pipeline);
+    RUN(test_e2e_stream_pipeline);
     RUN(test_e2e_invalid_manifest_no_dims);
     RUN(test_e2e_invalid_manifest_bad_dtype);
     RUN(test_e2e_failure_report_is_written);
@@ -0,0 +1,108 @@
+// f16 → f32 bulk conversion tests (scalar / F16C / AVX-512 kernels)
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "genmesh/half.h"
+
+// Original per-voxel routine from bricks_data.cpp (reference for bit-exactness)
+static float half_to_float_ref(uint16_t h) {
+    uint32_t sign = (h >> 15) & 0x1;
+    uint32_t exp  = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+
+    uint32_t f;
+    if (exp == 0) {
+        if (mant == 0) {
+            f = sign << 31;
+        } else {
+            exp = 1;
+            while (!(mant & 0x400)) {
+                mant <<= 1;
+                exp--;
+            }
+            mant &= 0x3FF;
+            f = (sign << 31) | ((exp + 127 - 15) << 23) | (mant << 13);
+        }
+    } else if (exp == 31) {
+        f = (sign << 31) | 0x7F800000 | (mant << 13);
+    } else {
+        f = (sign << 31) | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &f, sizeof(float));
+    return result;
+}
+
+static uint32_t bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(float));
+    return u;
+}
+
+static std::vector<uint16_t> all_halves() {
+    std::vector<uint16_t> v(65536);
+    for (uint32_t i = 0; i < 65536; ++i) v[i] = static_cast<uint16_t>(i);
+    return v;
+}
+
+void test_scalar_matches_reference() {
+    for (uint32_t i = 0; i < 65536; ++i) {
+        uint16_t h = static_cast<uint16_t>(i);
+        assert(bits(genmesh::half_to_float(h)) == bits(half_to_float_ref(h)));
+    }
+    std::cout << "  PASS: test_scalar_matches_reference\n";
+}
+
+void test_kernels_all_values() {
+    const auto src = all_halves();
+
+    for (auto k : {genmesh::HalfKernel::Scalar, genmesh::HalfKernel::F16C,
+                   genmesh::HalfKernel::Avx512, genmesh::HalfKernel::Auto}) {
+        if (!genmesh::half_kernel_supported(k)) {
+            std::cout << "    (kernel " << static_cast<int>(k) << " not supported, skipped)\n";
+            continue;
+        }
+        std::vector<float> dst(src.size());
+        genmesh::half_to_float_n(src.data(), dst.data(), src.size(), k);
+        for (size_t i = 0; i < src.size(); ++i) {
+            assert(bits(dst[i]) == bits(half_to_float_ref(src[i])));
+        }
+    }
+    std::cout << "  PASS: test_kernels_all_values (auto=" << genmesh::half_kernel_name() << ")\n";
+}
+
+void test_unaligned_and_tails() {
+    const auto src = all_halves();
+
+    // Odd start offsets and lengths exercise the scalar tail of each kernel.
+    for (auto k : {genmesh::HalfKernel::F16C, genmesh::HalfKernel::Avx512}) {
+        if (!genmesh::half_kernel_supported(k)) continue;
+        for (size_t off = 0; off < 3; ++off) {
+            for (size_t len : {0, 1, 7, 8, 15, 16, 17, 33, 1000}) {
+                std::vector<float> dst(len + 2, 12345.0f);
+                genmesh::half_to_float_n(src.data() + 0x3C00 + off, dst.data() + 1, len, k);
+                assert(dst[0] == 12345.0f);
+                assert(dst[len + 1] == 12345.0f);
+                for (size_t i = 0; i < len; ++i) {
+                    assert(bits(dst[i + 1]) == bits(half_to_float_ref(src[0x3C00 + off + i])));
+                }
+            }
+        }
+    }
+    std::cout << "  PASS: test_unaligned_and_tails\n";
+}
+
+int main() {
+    std::cout << "=== f16 conversion tests ===\n";
+
+    test_scalar_matches_reference();
+    test_kernels_all_values();
+    test_unaligned_and_tails();
+
+    std::cout << "=== All f16 conversion tests passed ===\n";
+    return 0;
+}
@@ -69,6 +69,26 @@ void test_extract_mesh_sphere_produces_triangles() {
            r.mesh.original_tri_count + r.mesh.original_quad_count * 2);
 }
 
+void test_extract_mesh_narrow_band_same_mesh() {
+    // Cells the surface crosses lie inside the band, so dropping the far
+    // field must not change the mesh.
+    genmesh::vdb_init();
+    auto dg = genmesh::debug_generate("sphere", 64, 1.0f);
+    ASSERT(dg.ok);
+    auto dense = genmesh::build_vdb(dg.manifest, dg.bricks);
+    genmesh::VdbBuildOptions opts;
+    opts.narrow_band = true;
+    auto nb = genmesh::build_vdb(dg.manifest, dg.bricks, opts);
+    ASSERT(dense.ok && nb.ok && nb.narrow_band);
+
+    auto a = genmesh::extract_mesh(dense.grid, 0.0, 0.0);
+    auto b = genmesh::extract_mesh(nb.grid, 0.0, 0.0);
+    ASSERT(a.ok && b.ok);
+    ASSERT(!a.mesh.triangles.empty());
+    ASSERT(a.mesh.triangles.size() == b.mesh.triangles.size());
+    ASSERT(a.mesh.points.size() == b.mesh.points.size());
+}
+
 void test_extract_mesh_null_grid_fails() {
     openvdb::FloatGrid::Ptr null_grid;
     auto r = genmesh::extract_mesh(null_grid);
@@ -304,6 +324,39 @@ void test_write_vdb_readable() {
     fs::remove_all(dir);
 }
 
+void test_write_vdb_save_as_half() {
+    auto grid = make_sphere_grid();
+
+    auto dir = make_temp_dir("vdb_half");
+    auto full_path = dir / "full.vdb";
+    auto half_path = dir / "half.vdb";
+
+    ASSERT(genmesh::write_vdb(full_path, grid).ok);
+    auto wr = genmesh::write_vdb(half_path, grid, true);
+    ASSERT(wr.ok);
+    ASSERT(fs::file_size(half_path) < fs::file_size(full_path));
+    // the flag does not stick to the grid
+    ASSERT(!grid->saveFloatAsHalf());
+
+    openvdb::io::File file(half_path.string());
+    file.open();
+    auto grids = file.getGrids();
+    ASSERT(grids && !grids->empty());
+    auto read_grid = openvdb::gridPtrCast<openvdb::FloatGrid>((*grids)[0]);
+    ASSERT(read_grid);
+    ASSERT(read_grid->activeVoxelCount() == grid->activeVoxelCount());
+    // values come back rounded to binary16
+    auto acc = grid->getConstAccessor();
+    auto racc = read_grid->getConstAccessor();
+    for (auto it = grid->cbeginValueOn(); it; ++it) {
+        const float v = acc.getValue(it.getCoord());
+        ASSERT(std::abs(racc.getValue(it.getCoord()) - v) <= std::abs(v) * 1e-3f + 1e-4f);
+    }
+
+    file.close();
+    fs::remove_all(dir);
+}
+
 void test_write_vdb_null_grid_fails() {
     openvdb::FloatGrid::Ptr null_grid;
 
@@ -324,6 +377,7 @@ int main() {
 
     // T5.1: extract_mesh
     RUN(test_extract_mesh_sphere_produces_triangles);
+    RUN(test_extract_mesh_narrow_band_same_mesh);
     RUN(test_extract_mesh_null_grid_fails);
     RUN(test_extract_mesh_quad_split_consistency);
     RUN(test_extract_mesh_vertex_indices_in_range);
@@ -339,6 +393,7 @@ int main() {
     // T5.3: write_vdb
     RUN(test_write_vdb_produces_file);
     RUN(test_write_vdb_readable);
+    RUN(test_write_vdb_save_as_half);
     RUN(test_write_vdb_null_grid_fails);
 
     std::cout << "\n" << tests_passed << "/" << tests_run << " passed\n";
@@ -170,6 +170,95 @@ void test_report_to_json_mesh_aabb() {
     ASSERT(s["mesh_aabb_max"][2] == 30.0f);
 }
 
+void test_report_to_json_clip() {
+    auto r = make_success_report();
+    ASSERT(!genmesh::report_to_json(r)["stats"].contains("clip"));
+
+    r.stats.has_clip = true;
+    r.stats.clip_min = {-5.0f, 0.0f, 1.5f};
+    r.stats.clip_max = {5.0f, 8.0f, 9.5f};
+    r.stats.clip_bricks_skipped = 7;
+    r.stats.clip_bytes_skipped = 7 * 131072;
+    auto c = genmesh::report_to_json(r)["stats"]["clip"];
+
+    ASSERT(c["bbox_min"][0] == -5.0f);
+    ASSERT(c["bbox_max"][2] == 9.5f);
+    ASSERT(c["bricks_skipped"] == 7);
+    ASSERT(c["bytes_skipped"] == 917504);
+}
+
+void test_report_to_json_offset() {
+    auto r = make_success_report();
+    ASSERT(!genmesh::report_to_json(r)["stats"].contains("offset"));
+
+    r.stats.has_offset = true;
+    r.stats.offset_mm = 4.5f;
+    r.stats.offset_method = "sweep";
+    r.stats.offset_dilated_voxels = 3;
+    r.stats.offset_ms = 12.5;
+    auto o = genmesh::report_to_json(r)["stats"]["offset"];
+
+    ASSERT(o["offset_mm"] == 4.5f);
+    ASSERT(o["method"] == "sweep");
+    ASSERT(o["dilated_voxels"] == 3);
+    ASSERT(o["ms"] == 12.5);
+}
+
+void test_report_to_json_shell() {
+    auto r = make_success_report();
+    ASSERT(!genmesh::report_to_json(r)["stats"].contains("shell"));
+
+    r.stats.has_shell = true;
+    r.stats.shell_thickness_mm = 2.0f;
+    r.stats.shell_method = "shift";
+    r.stats.shell_drain_holes = 2;
+    r.stats.shell_ms = 40.0;
+    auto s = genmesh::report_to_json(r)["stats"]["shell"];
+
+    ASSERT(s["thickness_mm"] == 2.0f);
+    ASSERT(s["method"] == "shift");
+    ASSERT(s["drain_holes"] == 2);
+    ASSERT(s["ms"] == 40.0);
+    ASSERT(!s.contains("infill"));
+}
+
+void test_report_to_json_infill() {
+    auto r = make_success_report();
+    r.stats.has_shell = true;
+    r.stats.shell_thickness_mm = 2.0f;
+    r.stats.shell_method = "shift";
+    r.stats.has_infill = true;
+    r.stats.infill_surface = "gyroid";
+    r.stats.infill_cell_mm = 8.0f;
+    r.stats.infill_wall_mm = 0.75f;
+    r.stats.infill_leaves = 5000;
+    r.stats.infill_ms = 12.5;
+    auto f = genmesh::report_to_json(r)["stats"]["shell"]["infill"];
+
+    ASSERT(f["surface"] == "gyroid");
+    ASSERT(f["cell_mm"] == 8.0f);
+    ASSERT(f["wall_mm"] == 0.75f);
+    ASSERT(f["leaves"] == 5000);
+    ASSERT(f["ms"] == 12.5);
+}
+
+void test_report_to_json_grid() {
+    auto r = make_success_report();
+    ASSERT(!genmesh::report_to_json(r)["stats"].contains("grid"));
+
+    r.stats.has_grid = true;
+    r.stats.grid_leaf_count = 1200;
+    r.stats.grid_uniform_tiles = 300;
+    r.stats.grid_memory_bytes = 2600000;
+    r.stats.grid_memory_saved_bytes = 300 * 2128;
+    auto g = genmesh::report_to_json(r)["stats"]["grid"];
+
+    ASSERT(g["leaf_count"] == 1200);
+    ASSERT(g["uniform_tiles"] == 300);
+    ASSERT(g["memory_bytes"] == 2600000);
+    ASSERT(g["memory_saved_bytes"] == 638400);
+}
+
 void test_report_to_json_warnings() {
     auto r = make_success_report();
     r.warnings.push_back({"GENMESH_W5001", "Degenerate triangles", "meshing",
@@ -300,6 +389,11 @@ int main() {
     RUN(test_report_to_json_timing_omits_unmeasured);
     RUN(test_report_to_json_stats);
     RUN(test_report_to_json_mesh_aabb);
+    RUN(test_report_to_json_clip);
+    RUN(test_report_to_json_offset);
+    RUN(test_report_to_json_shell);
+    RUN(test_report_to_json_infill);
+    RUN(test_report_to_json_grid);
     RUN(test_report_to_json_warnings);
     RUN(test_report_to_json_errors_with_kind);
     RUN(test_report_to_json_progress);
@@ -0,0 +1,183 @@
+// "sdfp" predictive SDF codec tests
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "genmesh/brick_codec.h"
+#include "genmesh/sdf_codec.h"
+
+static uint32_t bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+// Sphere SDF sampled at voxel centers, B^3 x-fastest
+static std::vector<float> sphere_brick(int B, float voxel, float radius) {
+    std::vector<float> v;
+    v.reserve(static_cast<size_t>(B) * B * B);
+    const float c = 0.5f * B * voxel;
+    for (int z = 0; z < B; ++z)
+        for (int y = 0; y < B; ++y)
+            for (int x = 0; x < B; ++x) {
+                float px = (x + 0.5f) * voxel - c;
+                float py = (y + 0.5f) * voxel - c;
+                float pz = (z + 0.5f) * voxel - c;
+                v.push_back(std::sqrt(px * px + py * py + pz * pz) - radius);
+            }
+    return v;
+}
+
+static std::vector<float> roundtrip(const std::vector<float>& in, int B,
+                                    const genmesh::SdfpOptions& opts = {}) {
+    auto enc = genmesh::sdfp_encode(in.data(), B, opts);
+    std::vector<float> out(in.size(), 12345.0f);
+    std::string err;
+    bool ok = genmesh::sdfp_decode(enc.data(), enc.size(), out.data(), out.size(), &err);
+    assert(ok);
+    return out;
+}
+
+void test_lossless_bit_exact() {
+    const int B = 16;
+    const size_t n = static_cast<size_t>(B) * B * B;
+
+    std::vector<std::vector<float>> inputs;
+    inputs.push_back(sphere_brick(B, 0.5f, 3.0f));
+    inputs.push_back(std::vector<float>(n, 3.0f));  // far-field constant
+
+    std::vector<float> noise(n);
+    std::mt19937 rng(1);
+    for (auto& f : noise) {
+        uint32_t u = rng();
+        std::memcpy(&f, &u, sizeof(f));  // arbitrary bit patterns incl. NaN/Inf
+    }
+    inputs.push_back(noise);
+
+    std::vector<float> special = sphere_brick(B, 1.0f, 5.0f);
+    special[0] = std::numeric_limits<float>::infinity();
+    special[1] = -std::numeric_limits<float>::infinity();
+    special[2] = std::numeric_limits<float>::quiet_NaN();
+    special[17] = -0.0f;
+    special[18] = std::numeric_limits<float>::denorm_min();
+    special[300] = std::numeric_limits<float>::max();
+    inputs.push_back(special);
+
+    for (const auto& in : inputs) {
+        auto out = roundtrip(in, B);
+        for (size_t i = 0; i < n; ++i) assert(bits(out[i]) == bits(in[i]));
+    }
+    std::cout << "  PASS: test_lossless_bit_exact\n";
+}
+
+void test_lossless_beats_raw_on_sdf() {
+    const int B = 64;
+    auto in = sphere_brick(B, 1.0f, 25.6f);
+    auto enc = genmesh::sdfp_encode(in.data(), B);
+    assert(enc.size() < in.size() * sizeof(float) / 2);
+    std::cout << "  PASS: test_lossless_beats_raw_on_sdf (ratio="
+              << static_cast<double>(in.size() * 4) / enc.size() << ")\n";
+}
+
+void test_bounded_error() {
+    const int B = 32;
+    const float voxel = 0.5f;
+    auto in = sphere_brick(B, voxel, 6.0f);
+
+    genmesh::SdfpOptions opts;
+    opts.max_error_mm = genmesh::sdfp_error_bound(voxel, 1.0f / 64.0f);
+
+    auto enc = genmesh::sdfp_encode(in.data(), B, opts);
+    auto lossless = genmesh::sdfp_encode(in.data(), B);
+    assert(enc.size() < lossless.size());
+
+    auto out = roundtrip(in, B, opts);
+    for (size_t i = 0; i < in.size(); ++i) {
+        assert(std::fabs(out[i] - in[i]) <= opts.max_error_mm);
+    }
+    std::cout << "  PASS: test_bounded_error\n";
+}
+
+void test_bounded_falls_back_to_lossless() {
+    const int B = 8;
+    auto in = sphere_brick(B, 1.0f, 2.0f);
+    in[5] = std::numeric_limits<float>::quiet_NaN();  // cannot be quantized
+
+    genmesh::SdfpOptions opts;
+    opts.max_error_mm = 0.01f;
+    auto out = roundtrip(in, B, opts);
+    for (size_t i = 0; i < in.size(); ++i) assert(bits(out[i]) == bits(in[i]));
+    std::cout << "  PASS: test_bounded_falls_back_to_lossless\n";
+}
+
+void test_corrupt_streams() {
+    const int B = 16;
+    auto in = sphere_brick(B, 0.5f, 3.0f);
+    auto enc = genmesh::sdfp_encode(in.data(), B);
+    std::vector<float> out(in.size());
+    std::string err;
+
+    // truncated header / body
+    assert(!genmesh::sdfp_decode(enc.data(), 4, out.data(), out.size(), &err));
+    assert(!genmesh::sdfp_decode(enc.data(), enc.size() / 2, out.data(), out.size(), &err));
+    assert(err == "corrupt bitstream");
+
+    // wrong brick size for the destination
+    assert(!genmesh::sdfp_decode(enc.data(), enc.size(), out.data(), 8 * 8 * 8, &err));
+    assert(err == "brick size mismatch");
+
+    // unknown mode
+    auto bad = enc;
+    bad[0] = 7;
+    assert(!genmesh::sdfp_decode(bad.data(), bad.size(), out.data(), out.size(), &err));
+
+    // random garbage must fail or decode, never crash
+    std::mt19937 rng(3);
+    for (int t = 0; t < 200; ++t) {
+        auto g = enc;
+        for (int k = 0; k < 8; ++k) g[8 + rng() % (g.size() - 8)] = static_cast<uint8_t>(rng());
+        genmesh::sdfp_decode(g.data(), g.size(), out.data(), out.size(), &err);
+    }
+    std::cout << "  PASS: test_corrupt_streams\n";
+}
+
+void test_brick_codec_dispatch() {
+    const int B = 8;
+    auto in = sphere_brick(B, 1.0f, 2.5f);
+    const auto* raw = reinterpret_cast<const uint8_t*>(in.data());
+    const size_t raw_size = in.size() * sizeof(float);
+
+    auto enc = genmesh::encode_brick_payload("sdfp", raw, raw_size);
+    assert(!enc.empty());
+
+    std::vector<float> out(in.size());
+    std::string err;
+    assert(genmesh::decode_brick_payload("sdfp", enc.data(), enc.size(),
+                                         reinterpret_cast<uint8_t*>(out.data()), raw_size, &err));
+    assert(std::memcmp(out.data(), in.data(), raw_size) == 0);
+
+    assert(genmesh::is_known_encoding("sdfp"));
+    assert(genmesh::encoding_supports_dtype("sdfp", "f32"));
+    assert(!genmesh::encoding_supports_dtype("sdfp", "f16"));
+    std::cout << "  PASS: test_brick_codec_dispatch\n";
+}
+
+int main() {
+    std::cout << "=== sdfp codec tests ===\n";
+
+    test_lossless_bit_exact();
+    test_lossless_beats_raw_on_sdf();
+    test_bounded_error();
+    test_bounded_falls_back_to_lossless();
+    test_corrupt_streams();
+    test_brick_codec_dispatch();
+
+    std::cout << "=== All sdfp codec tests passed ===\n";
+    return 0;
+}
@@ -0,0 +1,99 @@
+// uniform_block() tests (scalar / AVX2 kernels)
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "genmesh/uniform_block.h"
+
+static const genmesh::UniformKernel kKernels[] = {
+    genmesh::UniformKernel::Auto,
+    genmesh::UniformKernel::Scalar,
+    genmesh::UniformKernel::Avx2,
+};
+
+static size_t at(int B, int x, int y, int z) {
+    return static_cast<size_t>(x + B * (y + B * z));
+}
+
+void test_uniform_and_background() {
+    const int B = 32;
+    std::vector<float> brick(static_cast<size_t>(B) * B * B, 1000.0f);
+    for (auto k : kKernels) {
+        if (!genmesh::uniform_kernel_supported(k)) continue;
+        float v = 0.0f;
+        assert(genmesh::uniform_block(brick.data(), B, 8, 16, 24, v, k));
+        assert(v == 1000.0f);
+    }
+    std::cout << "  PASS: test_uniform_and_background (auto=" << genmesh::uniform_kernel_name()
+              << ")\n";
+}
+
+void test_single_voxel_differs() {
+    // Every voxel position of a block, in a block that is not at the brick origin
+    const int B = 16;
+    std::vector<float> brick(static_cast<size_t>(B) * B * B, -1000.0f);
+    for (auto k : kKernels) {
+        if (!genmesh::uniform_kernel_supported(k)) {
+            std::cout << "    (kernel " << static_cast<int>(k) << " not supported, skipped)\n";
+            continue;
+        }
+        for (int z = 0; z < 8; ++z)
+            for (int y = 0; y < 8; ++y)
+                for (int x = 0; x < 8; ++x) {
+                    const size_t i = at(B, 8 + x, 8 + y, z);
+                    brick[i] = -999.0f;
+                    float v = 0.0f;
+                    assert(!genmesh::uniform_block(brick.data(), B, 8, 8, 0, v, k));
+                    brick[i] = -1000.0f;
+                }
+        // values outside the block do not matter
+        brick[at(B, 7, 8, 0)] = 0.0f;
+        brick[at(B, 8, 8, 8)] = 0.0f;
+        float v = 0.0f;
+        assert(genmesh::uniform_block(brick.data(), B, 8, 8, 0, v, k));
+        assert(v == -1000.0f);
+        brick[at(B, 7, 8, 0)] = -1000.0f;
+        brick[at(B, 8, 8, 8)] = -1000.0f;
+    }
+    std::cout << "  PASS: test_single_voxel_differs\n";
+}
+
+void test_bitwise_compare() {
+    const int B = 8;
+    const float qnan = std::numeric_limits<float>::quiet_NaN();
+    for (auto k : kKernels) {
+        if (!genmesh::uniform_kernel_supported(k)) continue;
+
+        // -0 and +0 compare equal as floats but are different values
+        std::vector<float> zeros(512, 0.0f);
+        zeros[300] = -0.0f;
+        float v = 1.0f;
+        assert(!genmesh::uniform_block(zeros.data(), B, 0, 0, 0, v, k));
+
+        // the same NaN everywhere is uniform
+        std::vector<float> nans(512, qnan);
+        assert(genmesh::uniform_block(nans.data(), B, 0, 0, 0, v, k));
+        assert(std::isnan(v));
+
+        // a different NaN payload is not
+        uint32_t bits = 0x7FC00001u;
+        std::memcpy(&nans[511], &bits, sizeof(bits));
+        assert(!genmesh::uniform_block(nans.data(), B, 0, 0, 0, v, k));
+    }
+    std::cout << "  PASS: test_bitwise_compare\n";
+}
+
+int main() {
+    std::cout << "=== uniform_block tests ===\n";
+
+    test_uniform_and_background();
+    test_single_voxel_differs();
+    test_bitwise_compare();
+
+    std::cout << "=== All uniform_block tests passed ===\n";
+    return 0;
+}
@@ -1,12 +1,18 @@
 // T4.1 + T4.2 VDB builder tests
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include <openvdb/openvdb.h>
+#include <tbb/parallel_for.h>
 
 #include "genmesh/debug_generate.h"
+#include "genmesh/half.h"
 #include "genmesh/log.h"
 #include "genmesh/manifest.h"
 #include "genmesh/vdb_builder.h"
@@ -160,6 +166,479 @@ void test_build_vdb_empty_bricks() {
     std::cout << "  PASS: test_build_vdb_empty_bricks\n";
 }
 
+void test_build_vdb_constant_bricks() {
+    genmesh::Manifest m;
+    m.version = 1;
+    m.voxel_size = 1.0f;
+    m.aabb_min = {0, 0, 0};
+    m.aabb_size = {64, 32, 32};
+    m.dims = {64, 32, 32};
+    m.brick_size = 32;
+    m.dtype = "f32";
+    m.half_width_voxels = 3;
+    m.background_value_mm = 1000.0f;
+
+    // (0,0,0): solid interior, (1,0,0): in-band. Dense: both are active,
+    // like the same values written as voxels
+    std::vector<genmesh::BrickData> bricks(2);
+    bricks[0].constant = -1000.0f;
+    bricks[1].bx = 1;
+    bricks[1].constant = 0.5f;
+
+    auto r = genmesh::build_vdb(m, bricks);
+    assert(r.ok);
+    assert(r.active_voxel_count == 2 * 32 * 32 * 32);
+
+    auto accessor = r.grid->getConstAccessor();
+    assert(accessor.getValue(openvdb::Coord(5, 7, 9)) == -1000.0f);
+    assert(accessor.isValueOn(openvdb::Coord(5, 7, 9)));
+    assert(accessor.getValue(openvdb::Coord(40, 7, 9)) == 0.5f);
+    assert(accessor.isValueOn(openvdb::Coord(40, 7, 9)));
+    assert(accessor.getValue(openvdb::Coord(64, 0, 0)) == 1000.0f);
+
+    // Stored as tiles: each 32^3 box covers whole 8^3 leaf nodes
+    assert(r.grid->tree().leafCount() == 0);
+
+    std::cout << "  PASS: test_build_vdb_constant_bricks\n";
+}
+
+// Topology + buffers as written to a .vdb, without the file header (which
+// carries a random UUID).
+static std::string tree_bytes(const openvdb::FloatGrid& grid) {
+    std::ostringstream os(std::ios_base::binary);
+    grid.tree().writeTopology(os);
+    grid.tree().writeBuffers(os);
+    return os.str();
+}
+
+void test_build_vdb_constant_matches_raw() {
+    // A uniform field gives the same tree whether the producer wrote it as
+    // raw voxels (uniform 8^3 tiles) or as a constant brick
+    genmesh::Manifest m;
+    m.version = 1;
+    m.voxel_size = 1.0f;
+    m.aabb_min = {0, 0, 0};
+    m.aabb_size = {64, 32, 32};
+    m.dims = {64, 32, 32};
+    m.brick_size = 32;
+    m.dtype = "f32";
+    m.half_width_voxels = 3;
+    m.background_value_mm = 1000.0f;
+
+    auto build = [&](float value, bool as_constant, bool narrow_band) {
+        std::vector<genmesh::BrickData> bricks(2);
+        bricks[0].values.assign(32 * 32 * 32, 0.25f);  // a non-uniform neighbour
+        bricks[0].values[0] = -0.25f;
+        bricks[1].bx = 1;
+        if (as_constant) {
+            bricks[1].constant = value;
+        } else {
+            bricks[1].values.assign(32 * 32 * 32, value);
+        }
+        genmesh::VdbBuildOptions opts;
+        opts.narrow_band = narrow_band;
+        auto r = genmesh::build_vdb(m, bricks, opts);
+        assert(r.ok);
+        return r;
+    };
+
+    // dense: interior past the band (-5), deep interior (-1000), in band (0.5)
+    for (float value : {-5.0f, -1000.0f, 0.5f}) {
+        auto raw = build(value, false, false);
+        auto constant = build(value, true, false);
+        assert(raw.active_voxel_count == constant.active_voxel_count);
+        assert(raw.active_voxel_count == 2 * 32 * 32 * 32);
+        assert(tree_bytes(*raw.grid) == tree_bytes(*constant.grid));
+    }
+    // narrow band: an in-band constant is active like its voxels
+    {
+        auto raw = build(0.5f, false, true);
+        auto constant = build(0.5f, true, true);
+        assert(raw.narrow_band && constant.narrow_band);
+        assert(raw.active_voxel_count == constant.active_voxel_count);
+        assert(tree_bytes(*raw.grid) == tree_bytes(*constant.grid));
+    }
+
+    std::cout << "  PASS: test_build_vdb_constant_matches_raw\n";
+}
+
+void test_build_vdb_leaves_match_voxels() {
+    // Leaves built directly from brick values must give exactly the tree
+    // per-voxel insertion gives: same values, same active mask, no leaf for
+    // all-background 8^3 blocks.
+    for (int B : {32, 4}) {  // 4: not whole leaves, per-voxel fallback
+        genmesh::Manifest m;
+        m.version = 1;
+        m.voxel_size = 1.0f;
+        m.aabb_min = {0, 0, 0};
+        m.brick_size = B;
+        m.dims = {2 * B, B, B};
+        m.aabb_size = {2.0f * B, (float)B, (float)B};
+        m.dtype = "f32";
+        m.half_width_voxels = 3;
+        m.background_value_mm = 1000.0f;
+
+        std::vector<genmesh::BrickData> bricks(2);
+        for (int b = 0; b < 2; ++b) {
+            bricks[b].bx = b;
+            bricks[b].values.resize(static_cast<size_t>(B) * B * B);
+            for (int z = 0; z < B; ++z)
+                for (int y = 0; y < B; ++y)
+                    for (int x = 0; x < B; ++x) {
+                        // a slab of in-band values, background elsewhere
+                        float v = static_cast<float>(x + b * B) - 0.5f * B + 0.25f * y - 0.125f * z;
+                        if (std::fabs(v) > 3.0f) v = 1000.0f;
+                        bricks[b].values[static_cast<size_t>(x + B * (y + B * z))] = v;
+                    }
+        }
+
+        auto r = genmesh::build_vdb(m, bricks);
+        assert(r.ok);
+
+        auto ref = genmesh::create_grid(m);
+        auto acc = ref->getAccessor();
+        for (const auto& br : bricks)
+            for (int z = 0; z < B; ++z)
+                for (int y = 0; y < B; ++y)
+                    for (int x = 0; x < B; ++x) {
+                        const float v = br.values[static_cast<size_t>(x + B * (y + B * z))];
+                        if (v != 1000.0f) acc.setValue(openvdb::Coord(br.bx * B + x, y, z), v);
+                    }
+
+        assert(r.active_voxel_count == static_cast<int64_t>(ref->activeVoxelCount()));
+        assert(r.grid->tree().leafCount() == ref->tree().leafCount());
+        auto got = r.grid->getConstAccessor();
+        for (auto it = ref->cbeginValueOn(); it; ++it) {
+            assert(got.isValueOn(it.getCoord()));
+            assert(got.getValue(it.getCoord()) == *it);
+        }
+        for (auto it = r.grid->cbeginValueOn(); it; ++it) {
+            assert(acc.isValueOn(it.getCoord()));
+        }
+        assert(got.getValue(openvdb::Coord(0, 0, 0)) == 1000.0f);
+    }
+
+    std::cout << "  PASS: test_build_vdb_leaves_match_voxels\n";
+}
+
+void test_build_vdb_parallel_matches_serial() {
+    // Per-thread trees merged at the end must give the serial grid bit for bit.
+    {
+        auto gen = genmesh::debug_generate("sphere", 128, 1.0f);
+        assert(gen.ok);
+        // a solid interior brick and an in-band constant next to voxel bricks
+        assert(gen.bricks.size() == 8);
+        gen.bricks[6].values.clear();
+        gen.bricks[6].constant = -1000.0f;
+        gen.bricks[7].values.clear();
+        gen.bricks[7].constant = 0.5f;
+
+        genmesh::VdbBuildOptions serial_opts;
+        serial_opts.parallel = false;
+        auto serial = genmesh::build_vdb(gen.manifest, gen.bricks, serial_opts);
+        auto parallel = genmesh::build_vdb(gen.manifest, gen.bricks);
+        assert(serial.ok && parallel.ok);
+        assert(serial.active_voxel_count == parallel.active_voxel_count);
+        assert(tree_bytes(*serial.grid) == tree_bytes(*parallel.grid));
+    }
+    {
+        // B = 4: neighbouring bricks share 8^3 leaves across threads
+        genmesh::Manifest m;
+        m.version = 1;
+        m.voxel_size = 1.0f;
+        m.aabb_min = {0, 0, 0};
+        m.brick_size = 4;
+        m.dims = {32, 32, 32};
+        m.aabb_size = {32, 32, 32};
+        m.dtype = "f32";
+        m.half_width_voxels = 3;
+        m.background_value_mm = 1000.0f;
+
+        std::vector<genmesh::BrickData> bricks;
+        for (int bz = 0; bz < 8; ++bz)
+            for (int by = 0; by < 8; ++by)
+                for (int bx = 0; bx < 8; ++bx) {
+                    genmesh::BrickData b;
+                    b.bx = bx;
+                    b.by = by;
+                    b.bz = bz;
+                    b.values.resize(64);
+                    for (int z = 0; z < 4; ++z)
+                        for (int y = 0; y < 4; ++y)
+                            for (int x = 0; x < 4; ++x) {
+                                float v = static_cast<float>(bx * 4 + x + by * 4 + y) - 30.0f;
+                                if (std::fabs(v) > 3.0f) v = 1000.0f;
+                                b.values[static_cast<size_t>(x + 4 * (y + 4 * z))] = v;
+                            }
+                    bricks.push_back(std::move(b));
+                }
+
+        genmesh::VdbBuildOptions serial_opts;
+        serial_opts.parallel = false;
+        auto serial = genmesh::build_vdb(m, bricks, serial_opts);
+        auto parallel = genmesh::build_vdb(m, bricks);
+        assert(serial.ok && parallel.ok);
+        assert(serial.active_voxel_count > 0);
+        assert(tree_bytes(*serial.grid) == tree_bytes(*parallel.grid));
+    }
+
+    std::cout << "  PASS: test_build_vdb_parallel_matches_serial\n";
+}
+
+void test_vdb_stream_builder_any_order() {
+    // Bricks added in reverse, concurrently, give build_vdb()'s grid
+    auto gen = genmesh::debug_generate("sphere", 128, 1.0f);
+    assert(gen.ok);
+    gen.bricks[6].values.clear();
+    gen.bricks[6].constant = -1000.0f;
+    gen.bricks[7].values.clear();
+    gen.bricks[7].constant = 0.5f;
+
+    for (bool narrow_band : {false, true}) {
+        genmesh::VdbBuildOptions opts;
+        opts.narrow_band = narrow_band;
+        opts.parallel = false;
+        auto expected = genmesh::build_vdb(gen.manifest, gen.bricks, opts);
+        assert(expected.ok);
+        assert(expected.brick_count == static_cast<int64_t>(gen.bricks.size()));
+
+        genmesh::VdbStreamBuilder builder(gen.manifest, opts);
+        const size_t n = gen.bricks.size();
+        tbb::parallel_for(size_t(0), n, [&](size_t i) { builder.add(gen.bricks[n - 1 - i]); });
+        auto r = builder.finish();
+        assert(r.ok);
+        assert(r.narrow_band == expected.narrow_band);
+        assert(r.brick_count == expected.brick_count);
+        assert(r.active_voxel_count == expected.active_voxel_count);
+        assert(tree_bytes(*r.grid) == tree_bytes(*expected.grid));
+    }
+
+    // BrickViews over streamed debug bricks (arena slots) give the same grid
+    {
+        auto expected = genmesh::build_vdb(gen.manifest, gen.bricks);
+        genmesh::VdbStreamBuilder builder(gen.manifest);
+        std::vector<float> scratch;
+        for (const auto& bd : gen.bricks) builder.add(genmesh::brick_view(bd, scratch));
+        auto r = builder.finish();
+        assert(r.ok && r.brick_count == expected.brick_count);
+        assert(tree_bytes(*r.grid) == tree_bytes(*expected.grid));
+
+        genmesh::VdbStreamBuilder streamed(gen.manifest);
+        auto sg = genmesh::debug_generate("sphere", 128, 1.0f, [&](const genmesh::BrickData& bd) {
+            assert(bd.view && bd.values.empty());
+            streamed.add(genmesh::brick_view(bd, scratch));
+        });
+        assert(sg.ok);
+        auto plain = genmesh::debug_generate("sphere", 128, 1.0f);
+        auto want = genmesh::build_vdb(plain.manifest, plain.bricks);
+        auto got = streamed.finish();
+        assert(tree_bytes(*got.grid) == tree_bytes(*want.grid));
+    }
+
+    // nothing added: an empty grid
+    genmesh::VdbStreamBuilder empty(gen.manifest);
+    auto e = empty.finish();
+    assert(e.ok && e.brick_count == 0 && e.active_voxel_count == 0);
+
+    std::cout << "  PASS: test_vdb_stream_builder_any_order\n";
+}
+
+void test_build_vdb_narrow_band() {
+    // Dense debug sphere: every brick carries true distances far from the surface
+    auto gen = genmesh::debug_generate("sphere", 64, 1.0f);
+    assert(gen.ok);
+    auto dense = genmesh::build_vdb(gen.manifest, gen.bricks);
+
+    genmesh::VdbBuildOptions opts;
+    opts.narrow_band = true;
+    auto r = genmesh::build_vdb(gen.manifest, gen.bricks, opts);
+    assert(r.ok);
+    assert(r.narrow_band);
+    assert(r.active_voxel_count > 0);
+    assert(r.active_voxel_count * 4 < dense.active_voxel_count);
+
+    // only values within half_width_voxels (3) of the surface are active
+    for (auto it = r.grid->cbeginValueOn(); it; ++it) {
+        assert(std::fabs(*it) <= 3.0f);
+    }
+
+    // signedFloodFill: interior is -background, exterior +background, inactive
+    auto acc = r.grid->getConstAccessor();
+    assert(acc.getValue(openvdb::Coord(31, 31, 31)) == -1000.0f);
+    assert(!acc.isValueOn(openvdb::Coord(31, 31, 31)));
+    assert(acc.getValue(openvdb::Coord(0, 0, 0)) == 1000.0f);
+    assert(!acc.isValueOn(openvdb::Coord(0, 0, 0)));
+
+    // iso outside the band around 0: W4001, dense grid
+    auto far_iso = gen.manifest;
+    far_iso.iso = 10.0f;
+    auto fallback = genmesh::build_vdb(far_iso, gen.bricks, opts);
+    assert(fallback.ok);
+    assert(!fallback.narrow_band);
+    assert(fallback.active_voxel_count == dense.active_voxel_count);
+
+    std::cout << "  PASS: test_build_vdb_narrow_band\n";
+}
+
+void test_build_vdb_uniform_tiles() {
+    genmesh::Manifest m;
+    m.version = 1;
+    m.voxel_size = 1.0f;
+    m.aabb_min = {0, 0, 0};
+    m.brick_size = 32;
+    m.dims = {128, 128, 128};
+    m.aabb_size = {128, 128, 128};
+    m.dtype = "f32";
+    m.half_width_voxels = 3;
+    m.background_value_mm = 1000.0f;
+
+    {
+        // Plane at x = 20.5, clamped to -5 inside and background outside:
+        // the two 8-voxel slabs at x < 16 are uniform -5, the rest varies.
+        std::vector<genmesh::BrickData> bricks(1);
+        bricks[0].values.resize(32 * 32 * 32);
+        for (int z = 0; z < 32; ++z)
+            for (int y = 0; y < 32; ++y)
+                for (int x = 0; x < 32; ++x) {
+                    float v = std::max(static_cast<float>(x) - 20.5f, -5.0f);
+                    if (v > 5.0f) v = 1000.0f;
+                    bricks[0].values[static_cast<size_t>(x + 32 * (y + 32 * z))] = v;
+                }
+
+        auto r = genmesh::build_vdb(m, bricks);
+        assert(r.ok);
+        assert(r.uniform_tiles == 32);
+        assert(r.leaf_count == 32);
+        assert(r.grid->tree().leafCount() == 32);
+        assert(r.memory_saved_bytes > 0);
+        assert(r.memory_bytes == static_cast<int64_t>(r.grid->tree().memUsage()));
+
+        // values unchanged; uniform blocks are active like the voxels of the
+        // leaves they replace, so the active count matches per-voxel insertion
+        assert(r.active_voxel_count == 32 * 32 * 26);
+        auto acc = r.grid->getConstAccessor();
+        for (int x = 0; x < 32; ++x) {
+            const float v = bricks[0].values[static_cast<size_t>(x + 32 * (5 + 32 * 9))];
+            assert(acc.getValue(openvdb::Coord(x, 5, 9)) == v);
+        }
+        assert(acc.isValueOn(openvdb::Coord(3, 5, 9)));
+        assert(acc.isValueOn(openvdb::Coord(20, 5, 9)));
+        assert(!acc.isValueOn(openvdb::Coord(26, 5, 9)));
+    }
+    {
+        // 4^3 solid voxel bricks fill one 128^3 internal node: after pruning it
+        // is a single tile, no leaves and no lower internal nodes remain
+        std::vector<genmesh::BrickData> bricks;
+        for (int bz = 0; bz < 4; ++bz)
+            for (int by = 0; by < 4; ++by)
+                for (int bx = 0; bx < 4; ++bx) {
+                    genmesh::BrickData b;
+                    b.bx = bx;
+                    b.by = by;
+                    b.bz = bz;
+                    b.values.assign(32 * 32 * 32, -1000.0f);
+                    bricks.push_back(std::move(b));
+                }
+
+        auto r = genmesh::build_vdb(m, bricks);
+        assert(r.ok);
+        assert(r.uniform_tiles == 64 * 64);
+        assert(r.leaf_count == 0);
+        assert(r.active_voxel_count == 0);
+        assert(r.grid->tree().nodeCount()[1] == 0);
+        assert(r.grid->tree().getValue(openvdb::Coord(127, 0, 64)) == -1000.0f);
+        assert(r.grid->tree().getValue(openvdb::Coord(128, 0, 0)) == 1000.0f);
+    }
+
+    std::cout << "  PASS: test_build_vdb_uniform_tiles\n";
+}
+
+void test_build_vdb_clips_to_dims() {
+    // dims not a multiple of B: the boundary bricks carry voxels past dims
+    // that must not reach the grid (B = 32 specialized, B = 4 per-voxel)
+    for (int B : {32, 4}) {
+        genmesh::Manifest m;
+        m.version = 1;
+        m.voxel_size = 1.0f;
+        m.aabb_min = {0, 0, 0};
+        m.brick_size = B;
+        m.dims = {B + B / 2 + 1, B / 2 + 1, 2};
+        m.aabb_size = {(float)m.dims[0], (float)m.dims[1], (float)m.dims[2]};
+        m.dtype = "f32";
+        m.half_width_voxels = 3;
+        m.background_value_mm = 1000.0f;
+
+        std::vector<genmesh::BrickData> bricks(2);
+        bricks[0].values.assign(static_cast<size_t>(B) * B * B, -0.5f);
+        bricks[1].bx = 1;
+        bricks[1].values.assign(static_cast<size_t>(B) * B * B, -0.25f);
+        bricks[1].values[0] = 0.125f;  // not uniform
+
+        auto r = genmesh::build_vdb(m, bricks);
+        assert(r.ok);
+        assert(r.active_voxel_count ==
+               static_cast<int64_t>(m.dims[0]) * m.dims[1] * m.dims[2]);
+        const auto bbox = r.grid->evalActiveVoxelBoundingBox();
+        assert(bbox.min() == openvdb::Coord(0, 0, 0));
+        assert(bbox.max() == openvdb::Coord(m.dims[0] - 1, m.dims[1] - 1, m.dims[2] - 1));
+        auto acc = r.grid->getConstAccessor();
+        assert(acc.getValue(openvdb::Coord(m.dims[0], 0, 0)) == 1000.0f);
+        assert(acc.getValue(openvdb::Coord(0, m.dims[1], 0)) == 1000.0f);
+        assert(acc.getValue(openvdb::Coord(m.dims[0] - 1, 0, 1)) == -0.25f);
+
+        // constant bricks are clipped the same way
+        bricks[1].values.clear();
+        bricks[1].constant = -0.25f;
+        auto rc = genmesh::build_vdb(m, bricks);
+        assert(rc.ok);
+        assert(rc.active_voxel_count == r.active_voxel_count);
+        assert(rc.grid->evalActiveVoxelBoundingBox() == bbox);
+    }
+
+    std::cout << "  PASS: test_build_vdb_clips_to_dims\n";
+}
+
+// Truncating f32 -> f16 for test data (normals only, small values flush to 0)
+static uint16_t to_half_trunc(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const int exp = static_cast<int>((bits >> 23) & 0xFFu) - 127 + 15;
+    if (exp <= 0) return sign;
+    if (exp >= 31) return static_cast<uint16_t>(sign | 0x7BFFu);
+    return static_cast<uint16_t>(sign | (exp << 10) | ((bits >> 13) & 0x3FFu));
+}
+
+void test_build_vdb_half_bricks() {
+    // f16 bricks kept as binary16 build the same tree as their widened copy
+    auto gen = genmesh::debug_generate("sphere", 128, 1.0f);
+    assert(gen.ok);
+    auto half_bricks = gen.bricks;
+    for (size_t b = 0; b < gen.bricks.size(); ++b) {
+        auto& widened = gen.bricks[b].values;
+        auto& halfs = half_bricks[b].half_values;
+        halfs.resize(widened.size());
+        for (size_t i = 0; i < widened.size(); ++i) {
+            halfs[i] = to_half_trunc(widened[i]);
+            widened[i] = genmesh::half_to_float(halfs[i]);
+        }
+        half_bricks[b].values.clear();
+        assert(half_bricks[b].is_half());
+    }
+
+    for (bool parallel : {false, true}) {
+        genmesh::VdbBuildOptions opts;
+        opts.parallel = parallel;
+        auto rf = genmesh::build_vdb(gen.manifest, gen.bricks, opts);
+        auto rh = genmesh::build_vdb(gen.manifest, half_bricks, opts);
+        assert(rf.ok && rh.ok);
+        assert(rh.active_voxel_count == rf.active_voxel_count);
+        assert(tree_bytes(*rh.grid) == tree_bytes(*rf.grid));
+    }
+
+    std::cout << "  PASS: test_build_vdb_half_bricks\n";
+}
+
 void test_apply_offset_dilate() {
     // Generate sphere SDF
     auto gen = genmesh::debug_generate("sphere", 64, 1.0f);
@@ -238,6 +717,269 @@ void test_apply_offset_null_grid() {
     std::cout << "  PASS: test_apply_offset_null_grid\n";
 }
 
+void test_offset_grid_paths() {
+    // Narrow-band sphere (r = 25.6 mm, band 3 mm): past the band the grid
+    // only holds -/+background, so a shift alone cannot move the surface there
+    auto gen = genmesh::debug_generate("sphere", 64, 1.0f);
+    assert(gen.ok);
+    genmesh::VdbBuildOptions nb;
+    nb.narrow_band = true;
+    const float band = 3.0f;
+    const float r = 25.6f;
+
+    auto within = genmesh::build_vdb(gen.manifest, gen.bricks, nb);
+    auto res = genmesh::offset_grid(within.grid, 1.5f, band);
+    assert(res.ok);
+    assert(res.method == genmesh::OffsetMethod::Shift);
+    assert(res.dilated_voxels == 0);
+    assert(std::string(genmesh::offset_method_name(res.method)) == "shift");
+
+    auto zero = genmesh::offset_grid(within.grid, 0.0f, band);
+    assert(zero.ok && zero.method == genmesh::OffsetMethod::None);
+
+    openvdb::FloatGrid::Ptr null_grid;
+    assert(!genmesh::offset_grid(null_grid, 5.0f, band).ok);
+
+    for (float offset : {5.0f, -5.0f}) {
+        auto built = genmesh::build_vdb(gen.manifest, gen.bricks, nb);
+        assert(built.ok && built.narrow_band);
+        auto grid = built.grid;
+        auto off = genmesh::offset_grid(grid, offset, band);
+        assert(off.ok);
+        assert(off.method == genmesh::OffsetMethod::Sweep);
+        assert(off.dilated_voxels == 5);  // ceil(|offset| / voxel): a full band remains
+        assert(off.ms >= 0.0);
+        assert(grid->getGridClass() == openvdb::GRID_LEVEL_SET);
+
+        // along +x from the center: the values near the moved surface are
+        // distances to it, within fast sweeping's first-order error
+        auto acc = grid->getConstAccessor();
+        const auto& xf = grid->transform();
+        int crossings = 0;
+        float prev = 0.0f;
+        for (int i = 32; i < 64; ++i) {
+            const openvdb::Coord ijk(i, 31, 31);
+            const auto w = xf.indexToWorld(ijk);
+            const float d = static_cast<float>((w - openvdb::Vec3d(32.0, 32.0, 32.0)).length()) - r;
+            const float v = acc.getValue(ijk);
+            if (std::fabs(d - offset) <= 2.0f) {
+                assert(acc.isValueOn(ijk));
+                assert(std::fabs(v - (d - offset)) < 1.0f);
+            }
+            // symmetric band around the moved surface, nothing past it
+            if (acc.isValueOn(ijk)) assert(std::fabs(v) < band);
+            if (std::fabs(d - offset) >= band + 1.0f) assert(!acc.isValueOn(ijk));
+            if (i > 32 && (prev < 0.0f) != (v < 0.0f)) ++crossings;
+            prev = v;
+        }
+        assert(crossings == 1);
+    }
+
+    std::cout << "  PASS: test_offset_grid_paths\n";
+}
+
+void test_offset_grid_dense_tiles() {
+    // Dense grid, plane at x = 40.5 clamped to -5 inside: brick 0 is a
+    // constant -5 brick (an inactive tile, |v| >= band) and brick 1 holds
+    // clamped -5 voxels next to it. Eroding by 6 mm moves the plane to
+    // x = 34.5, past the clamp: only the band may be shifted, or the clamped
+    // voxels turn positive against the tile and form a false surface.
+    genmesh::Manifest m;
+    m.version = 1;
+    m.voxel_size = 1.0f;
+    m.aabb_min = {0, 0, 0};
+    m.brick_size = 32;
+    m.dims = {64, 32, 32};
+    m.aabb_size = {64, 32, 32};
+    m.dtype = "f32";
+    m.half_width_voxels = 3;
+    m.background_value_mm = 1000.0f;
+    const float band = 3.0f;
+
+    std::vector<genmesh::BrickData> bricks(2);
+    bricks[0].constant = -5.0f;
+    bricks[1].bx = 1;
+    bricks[1].values.resize(32 * 32 * 32);
+    for (int z = 0; z < 32; ++z)
+        for (int y = 0; y < 32; ++y)
+            for (int x = 0; x < 32; ++x) {
+                float v = std::max(static_cast<float>(32 + x) - 40.5f, -5.0f);
+                if (v > 5.0f) v = 1000.0f;
+                bricks[1].values[static_cast<size_t>(x + 32 * (y + 32 * z))] = v;
+            }
+
+    auto built = genmesh::build_vdb(m, bricks);
+    assert(built.ok && !built.narrow_band);
+    auto grid = built.grid;
+    assert(!grid->getConstAccessor().isValueOn(openvdb::Coord(10, 5, 5)));
+
+    auto off = genmesh::offset_grid(grid, -6.0f, band);
+    assert(off.ok);
+    assert(off.method == genmesh::OffsetMethod::Sweep);
+    assert(off.dilated_voxels == 6);
+
+    auto acc = grid->getConstAccessor();
+    for (int y : {0, 5, 31}) {
+        int crossings = 0;
+        float prev = acc.getValue(openvdb::Coord(0, y, 5));
+        assert(prev < 0.0f);
+        for (int x = 0; x < 64; ++x) {
+            const openvdb::Coord ijk(x, y, 5);
+            const float v = acc.getValue(ijk);
+            const float d = static_cast<float>(x) - 34.5f;
+            if ((prev < 0.0f) != (v < 0.0f)) ++crossings;
+            prev = v;
+            if (std::fabs(d) <= 2.0f) {
+                assert(acc.isValueOn(ijk));
+                assert(std::fabs(v - d) < 0.5f);
+            }
+            // +/-band around the new plane only
+            if (acc.isValueOn(ijk)) assert(std::fabs(v) < band);
+            if (std::fabs(d) >= band + 1.0f) assert(!acc.isValueOn(ijk));
+        }
+        assert(crossings == 1);
+    }
+
+    std::cout << "  PASS: test_offset_grid_dense_tiles\n";
+}
+
+void test_make_shell() {
+    // Sphere r = 25.6 mm centered at (32, 32, 32); band 3 mm
+    auto gen = genmesh::debug_generate("sphere", 64, 1.0f);
+    assert(gen.ok);
+    const float band = 3.0f;
+    auto sample = [](const openvdb::FloatGrid& g, double x, double y, double z) {
+        const auto ijk = g.transform().worldToIndexCellCentered(openvdb::Vec3d(x, y, z));
+        return g.getConstAccessor().getValue(ijk);
+    };
+
+    // thin wall, one drain hole up +y through it
+    {
+        auto r = genmesh::build_vdb(gen.manifest, gen.bricks);
+        assert(r.ok);
+        genmesh::DrainHole hole{{32.0f, 50.0f, 32.0f}, {32.0f, 62.0f, 32.0f}, 2.0f};
+        auto sh = genmesh::make_shell(r.grid, 1.5f, {hole}, band);
+        assert(sh.ok);
+        assert(sh.erode_method == genmesh::OffsetMethod::Shift);
+        assert(sh.drain_holes == 1);
+        assert(sh.ms >= 0.0);
+
+        const auto& g = *r.grid;
+        assert(sample(g, 32, 32, 32) > 0.0f);         // cavity
+        assert(sample(g, 32 - 24.8, 32, 32) < 0.0f);  // wall, 0.8 mm deep
+        assert(sample(g, 32 - 28.0, 32, 32) > 0.0f);  // outside
+        assert(sample(g, 32, 32 + 24.8, 32) > 0.0f);  // wall drilled by the hole
+        assert(sample(g, 32 + 3.0, 32 + 24.6, 32) < 0.0f);  // wall beside the hole
+    }
+
+    // a wall thicker than the band: eroded by fast sweeping
+    {
+        genmesh::VdbBuildOptions nb;
+        nb.narrow_band = true;
+        auto r = genmesh::build_vdb(gen.manifest, gen.bricks, nb);
+        assert(r.ok && r.narrow_band);
+        auto sh = genmesh::make_shell(r.grid, 6.0f, {}, band);
+        assert(sh.ok);
+        assert(sh.erode_method == genmesh::OffsetMethod::Sweep);
+        assert(sh.drain_holes == 0);
+
+        const auto& g = *r.grid;
+        assert(sample(g, 32, 32, 32) > 0.0f);
+        assert(sample(g, 32, 32, 32 + 25.6 - 3.0) < 0.0f);
+        assert(sample(g, 32, 32, 32 + 25.6 - 9.0) > 0.0f);
+    }
+
+    openvdb::FloatGrid::Ptr null_grid;
+    assert(!genmesh::make_shell(null_grid, 2.0f, {}, band).ok);
+
+    std::cout << "  PASS: test_make_shell\n";
+}
+
+void test_make_shell_infill() {
+    // Sphere r = 25.6 mm centered at (32, 32, 32), 1.5 mm wall, gyroid with
+    // 2 mm walls every 8 mm in the cavity
+    auto gen = genmesh::debug_generate("sphere", 64, 1.0f);
+    assert(gen.ok);
+    const float band = 3.0f;
+    genmesh::TpmsParams p;
+    p.surface = genmesh::TpmsSurface::Gyroid;
+    p.cell_mm = 8.0f;
+    p.wall_mm = 2.0f;
+
+    auto r = genmesh::build_vdb(gen.manifest, gen.bricks);
+    assert(r.ok);
+    genmesh::DrainHole hole{{32.0f, 50.0f, 32.0f}, {32.0f, 62.0f, 32.0f}, 2.0f};
+    auto sh = genmesh::make_shell(r.grid, 1.5f, {hole}, band, p);
+    assert(sh.ok);
+    assert(sh.drain_holes == 1);
+    assert(sh.infill_leaves > 0);
+    assert(sh.infill_ms >= 0.0 && sh.infill_ms <= sh.ms);
+
+    // deep in the cavity the grid follows the lattice; outside the part
+    // it stays empty
+    const auto& g = *r.grid;
+    auto acc = g.getConstAccessor();
+    int lattice = 0, open = 0;
+    for (int x = 0; x < 64; ++x) {
+        for (int y = 0; y < 64; ++y) {
+            for (int z = 0; z < 64; ++z) {
+                const openvdb::Coord ijk(x, y, z);
+                const openvdb::Vec3d w = g.transform().indexToWorld(ijk);
+                const double rad = (w - openvdb::Vec3d(32.0)).length();
+                const float v = acc.getValue(ijk);
+                if (rad > 27.0) {
+                    assert(v > 0.0f);
+                } else if (rad < 20.0) {
+                    const float d = genmesh::tpms_distance(p, w[0], w[1], w[2]);
+                    if (std::fabs(d) < 0.25f) continue;
+                    assert((v < 0.0f) == (d < 0.0f));
+                    ++(d < 0.0f ? lattice : open);
+                }
+            }
+        }
+    }
+    assert(lattice > 0 && open > 0);
+
+    // the shell itself and the drain hole through it are kept
+    auto sample = [&](double x, double y, double z) {
+        return acc.getValue(g.transform().worldToIndexCellCentered(openvdb::Vec3d(x, y, z)));
+    };
+    assert(sample(32 - 24.8, 32, 32) < 0.0f);
+    assert(sample(32, 32 + 24.8, 32) > 0.0f);
+
+    std::cout << "  PASS: test_make_shell_infill\n";
+}
+
+void test_clip_grid() {
+    auto gen = genmesh::debug_generate("sphere", 64, 1.0f);
+    assert(gen.ok);
+    auto r = genmesh::build_vdb(gen.manifest, gen.bricks);
+    assert(r.ok);
+    const auto full_active = r.grid->activeVoxelCount();
+    const float inside_before = r.grid->getConstAccessor().getValue(openvdb::Coord(10, 32, 32));
+
+    // keep the -x half of the sphere
+    genmesh::WorldBox box;
+    box.min = {-1.0f, -1.0f, -1.0f};
+    box.max = {32.0f, 65.0f, 65.0f};
+    bool ok = genmesh::clip_grid(r.grid, box);
+    assert(ok);
+    assert(r.grid->getName() == "distance");
+    assert(r.grid->getGridClass() == openvdb::GRID_LEVEL_SET);
+    assert(r.grid->activeVoxelCount() < full_active);
+
+    auto acc = r.grid->getConstAccessor();
+    assert(acc.getValue(openvdb::Coord(10, 32, 32)) == inside_before);
+    // cut away: background (outside), so the remaining half is capped
+    assert(acc.getValue(openvdb::Coord(50, 32, 32)) == gen.manifest.background_value_mm);
+    assert(!acc.isValueOn(openvdb::Coord(54, 32, 32)));
+
+    openvdb::FloatGrid::Ptr null_grid;
+    assert(!genmesh::clip_grid(null_grid, box));
+
+    std::cout << "  PASS: test_clip_grid\n";
+}
+
 int main() {
     genmesh::min_log_level() = genmesh::LogLevel::Error;
 
@@ -250,10 +992,24 @@ int main() {
     test_build_vdb_box();
     test_build_vdb_multi_brick();
     test_build_vdb_empty_bricks();
+    test_build_vdb_constant_bricks();
+    test_build_vdb_constant_matches_raw();
+    test_build_vdb_leaves_match_voxels();
+    test_build_vdb_parallel_matches_serial();
+    test_vdb_stream_builder_any_order();
+    test_build_vdb_narrow_band();
+    test_build_vdb_uniform_tiles();
+    test_build_vdb_clips_to_dims();
+    test_build_vdb_half_bricks();
     test_apply_offset_dilate();
     test_apply_offset_erode();
     test_apply_offset_zero();
     test_apply_offset_null_grid();
+    test_offset_grid_paths();
+    test_offset_grid_dense_tiles();
+    test_make_shell();
+    test_make_shell_infill();
+    test_clip_grid();
 
     std::cout << "=== All T4 tests passed ===\n";
     return 0;